@@ -29,6 +29,8 @@ macro(json2cpp_setup_options)
     set(SUPPORTS_ASAN ON)
   endif()
 
+  option(json2cpp_BUILD_BENCHMARKS "Enable the benchmark executables" OFF)
+
   json2cpp_check_libfuzzer_support(LIBFUZZER_SUPPORTED)
   option(json2cpp_BUILD_FUZZ_TESTS "Enable fuzz testing executable" ${LIBFUZZER_SUPPORTED})
 
@@ -0,0 +1,218 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+// Counts heap allocations made by the steps of `validate_internal` in
+// src/schema_validator.cpp (populating a schema from a compiled document, then
+// validating a document with it) and by plain traversal through the valijson
+// adapters. Every allocation in the process goes through the replaced global
+// operator new below.
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+
+#include <json2cpp/json2cpp_adapter.hpp>
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validator.hpp>
+
+#include "benchmark.hpp"
+#include "epjson_model_schema.hpp"
+#include "refbldg_medium_office.hpp"
+
+namespace {
+
+std::atomic<std::size_t> allocation_count{ 0 };
+std::atomic<std::size_t> allocation_bytes{ 0 };
+
+}// namespace
+
+void *operator new(const std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void *block = std::malloc(size == 0 ? 1 : size)) { return block; }
+  throw std::bad_alloc{};
+}
+
+void *operator new[](const std::size_t size) { return operator new(size); }
+
+void operator delete(void *block) noexcept { std::free(block); }
+void operator delete[](void *block) noexcept { std::free(block); }
+void operator delete(void *block, std::size_t) noexcept { std::free(block); }
+void operator delete[](void *block, std::size_t) noexcept { std::free(block); }
+
+namespace {
+
+using json2cpp::benchmark::do_not_optimize;
+
+struct allocations
+{
+  std::string name;
+  std::size_t count{};
+  std::size_t bytes{};
+};
+
+// runs `function` once and returns the allocations it made
+template<typename Function> allocations measure(std::string name, Function &&function)
+{
+  const auto count = allocation_count.load();
+  const auto bytes = allocation_bytes.load();
+  function();
+  return allocations{ std::move(name), allocation_count.load() - count, allocation_bytes.load() - bytes };
+}
+
+nlohmann::json load(const std::filesystem::path &filename)
+{
+  std::ifstream input(filename);
+  nlohmann::json document;
+  input >> document;
+  return document;
+}
+
+// visits every value through the generic valijson Adapter interface
+std::size_t traverse(const valijson::adapters::Adapter &value)
+{
+  std::size_t visited = 1;
+  value.applyToObject([&](const std::string &key, const valijson::adapters::Adapter &member) {
+    do_not_optimize(key);
+    visited += traverse(member);
+    return true;
+  });
+  value.applyToArray([&](const valijson::adapters::Adapter &element) {
+    visited += traverse(element);
+    return true;
+  });
+  return visited;
+}
+
+template<typename Adapter>
+void measure_adapter(std::string_view library, const Adapter &document, std::vector<allocations> &results)
+{
+  // the first pass is reported separately, it includes one time costs such as
+  // populating free lists; both passes copy every object key longer than the
+  // small string buffer
+  results.push_back(measure(fmt::format("{}/traverse/first", library), [&] { do_not_optimize(traverse(document)); }));
+  results.push_back(measure(fmt::format("{}/traverse", library), [&] { do_not_optimize(traverse(document)); }));
+
+  results.push_back(measure(fmt::format("{}/freeze_and_clone", library), [&] {
+    for (std::size_t idx = 0; idx < 100; ++idx) {
+      const std::unique_ptr<valijson::adapters::FrozenValue> frozen{ document.freeze() };
+      const std::unique_ptr<valijson::adapters::FrozenValue> cloned{ frozen->clone() };
+      do_not_optimize(cloned);
+    }
+  }));
+}
+
+template<typename Adapter>
+void measure_validation(std::string_view library,
+  const valijson::Schema &schema,
+  const Adapter &target,
+  std::vector<allocations> &results)
+{
+  results.push_back(measure(fmt::format("{}/validate/first", library), [&] {
+    valijson::Validator validator;
+    do_not_optimize(validator.validate(schema, target, nullptr));
+  }));
+  results.push_back(measure(fmt::format("{}/validate", library), [&] {
+    valijson::Validator validator;
+    do_not_optimize(validator.validate(schema, target, nullptr));
+  }));
+}
+
+}// namespace
+
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app("allocation_benchmark version 0.0.1");
+
+    std::filesystem::path examples{ JSON2CPP_EXAMPLES_DIR };
+    std::filesystem::path json_output;
+
+    app.add_option("--examples", examples, "Directory containing the example documents");
+    app.add_option("--json", json_output, "Write the results as JSON to this file");
+
+    CLI11_PARSE(app, argc, argv);
+
+    using valijson::Schema;
+    using valijson::SchemaParser;
+    using valijson::adapters::json2cppJsonAdapter;
+    using valijson::adapters::NlohmannJsonAdapter;
+
+    const auto schema_document = load(examples / "epjson_model.schema.json");
+    const auto target_document = load(examples / "RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+
+    const json2cppJsonAdapter json2cpp_schema(compiled_json::epjson_model_schema::get());
+    const NlohmannJsonAdapter nlohmann_schema(schema_document);
+    const json2cppJsonAdapter json2cpp_target(compiled_json::refbldg_medium_office::get());
+    const NlohmannJsonAdapter nlohmann_target(target_document);
+
+    std::vector<allocations> results;
+
+    Schema schema;
+    results.push_back(measure("json2cpp/populate_schema", [&] {
+      SchemaParser parser;
+      parser.populateSchema(json2cpp_schema, schema);
+    }));
+    results.push_back(measure("nlohmann/populate_schema", [&] {
+      Schema nlohmann_populated;
+      SchemaParser parser;
+      parser.populateSchema(nlohmann_schema, nlohmann_populated);
+    }));
+
+    measure_validation("json2cpp", schema, json2cpp_target, results);
+    measure_validation("nlohmann", schema, nlohmann_target, results);
+
+    measure_adapter("json2cpp", json2cpp_target, results);
+    measure_adapter("nlohmann", nlohmann_target, results);
+
+    nlohmann::json output;
+    output["build"] = json2cpp::benchmark::build_information();
+    output["benchmarks"] = nlohmann::json::array();
+    for (const auto &result : results) {
+      fmt::print("{:<40} {:>10} allocations {:>12} bytes\n", result.name, result.count, result.bytes);
+      output["benchmarks"].push_back(
+        { { "name", result.name }, { "allocations", result.count }, { "bytes", result.bytes } });
+    }
+
+    if (!json_output.empty()) {
+      std::ofstream json_file(json_output);
+      json_file << output.dump(2) << '\n';
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in main: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,337 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Benchmark harness shared by the benchmark executables: warm-up, repetitions,
+// summary statistics, optional Linux perf counters, and a text report or JSON
+// results written with fmt and nlohmann::json.
+
+#ifndef JSON2CPP_BENCHMARK_HPP
+#define JSON2CPP_BENCHMARK_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace json2cpp::benchmark {
+
+// keeps the optimizer from discarding a result we computed only for timing purposes
+template<typename Type> inline void do_not_optimize(const Type &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void *sink = nullptr;
+  sink = &value;
+#endif
+}
+
+struct options
+{
+  std::size_t warmup{ 3 };
+  std::size_t repetitions{ 20 };
+  bool perf_counters{ false };
+};
+
+struct statistics
+{
+  double min{};
+  double max{};
+  double mean{};
+  double median{};
+  double stddev{};
+  double p90{};
+};
+
+[[nodiscard]] inline statistics summarize(std::vector<double> samples)
+{
+  statistics result;
+  if (samples.empty()) { return result; }
+
+  std::sort(samples.begin(), samples.end());
+
+  const auto percentile = [&](const double fraction) {
+    const auto position = fraction * static_cast<double>(samples.size() - 1);
+    const auto lower = static_cast<std::size_t>(std::floor(position));
+    const auto upper = static_cast<std::size_t>(std::ceil(position));
+    const auto weight = position - static_cast<double>(lower);
+    return samples[lower] * (1.0 - weight) + samples[upper] * weight;
+  };
+
+  result.min = samples.front();
+  result.max = samples.back();
+  result.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+  result.median = percentile(0.5);
+  result.p90 = percentile(0.9);
+
+  const auto square_sum = std::accumulate(samples.begin(), samples.end(), 0.0, [&](const double sum, const double v) {
+    return sum + (v - result.mean) * (v - result.mean);
+  });
+  result.stddev = std::sqrt(square_sum / static_cast<double>(samples.size()));
+
+  return result;
+}
+
+// Hardware counters through perf_event_open(2). Opening the counters fails in many
+// containers and on systems with a restrictive perf_event_paranoid setting, in
+// which case `available()` is false and the benchmarks simply run without them.
+class perf_counters
+{
+public:
+  static constexpr std::array<std::string_view, 4> names{ "cycles", "instructions", "cache_misses", "branch_misses" };
+  using values = std::array<std::uint64_t, names.size()>;
+
+  perf_counters()
+  {
+#if defined(__linux__)
+    constexpr std::array<std::uint64_t, names.size()> configs{ PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES };
+
+    for (std::size_t idx = 0; idx < configs.size(); ++idx) {
+      perf_event_attr attr{};
+      std::memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[idx];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      descriptors_[idx] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+      if (descriptors_[idx] < 0) {
+        close_all();
+        return;
+      }
+    }
+    available_ = true;
+#endif
+  }
+
+  perf_counters(const perf_counters &) = delete;
+  perf_counters &operator=(const perf_counters &) = delete;
+  perf_counters(perf_counters &&) = delete;
+  perf_counters &operator=(perf_counters &&) = delete;
+
+  ~perf_counters() { close_all(); }
+
+  [[nodiscard]] bool available() const noexcept { return available_; }
+
+  void start()
+  {
+#if defined(__linux__)
+    if (!available_) { return; }
+    for (const auto descriptor : descriptors_) {
+      ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+      ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  [[nodiscard]] values stop()
+  {
+    values result{};
+#if defined(__linux__)
+    if (!available_) { return result; }
+    for (std::size_t idx = 0; idx < descriptors_.size(); ++idx) {
+      ioctl(descriptors_[idx], PERF_EVENT_IOC_DISABLE, 0);
+      std::uint64_t count{};
+      if (read(descriptors_[idx], &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+        result[idx] = count;
+      }
+    }
+#endif
+    return result;
+  }
+
+private:
+  void close_all()
+  {
+#if defined(__linux__)
+    for (auto &descriptor : descriptors_) {
+      if (descriptor >= 0) { ::close(descriptor); }
+      descriptor = -1;
+    }
+#endif
+    available_ = false;
+  }
+
+  std::array<int, names.size()> descriptors_{ -1, -1, -1, -1 };
+  bool available_{ false };
+};
+
+struct result
+{
+  std::string name;
+  // operations performed by one call of the benchmarked function, used to report per-operation numbers
+  std::size_t operations{ 1 };
+  // nanoseconds per call
+  statistics nanoseconds;
+  // mean counter values per operation, empty if counters were not available
+  std::vector<std::pair<std::string, double>> counters;
+
+  [[nodiscard]] double nanoseconds_per_operation() const
+  {
+    return nanoseconds.median / static_cast<double>(std::max<std::size_t>(operations, 1));
+  }
+};
+
+// `function` performs `operations` units of work per call and is invoked
+// `warmup` + `repetitions` times; only the repetitions are measured.
+template<typename Function>
+[[nodiscard]] result run(std::string name, const options &opts, const std::size_t operations, Function &&function)
+{
+  result bench_result;
+  bench_result.name = std::move(name);
+  bench_result.operations = operations;
+
+  for (std::size_t idx = 0; idx < opts.warmup; ++idx) { function(); }
+
+  std::vector<double> samples;
+  samples.reserve(opts.repetitions);
+
+  perf_counters::values counter_sums{};
+  std::optional<perf_counters> counters;
+  if (opts.perf_counters) { counters.emplace(); }
+  const bool use_counters = counters.has_value() && counters->available();
+
+  for (std::size_t idx = 0; idx < opts.repetitions; ++idx) {
+    if (use_counters) { counters->start(); }
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto stop = std::chrono::steady_clock::now();
+    if (use_counters) {
+      const auto values = counters->stop();
+      for (std::size_t counter = 0; counter < values.size(); ++counter) { counter_sums[counter] += values[counter]; }
+    }
+    samples.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+
+  bench_result.nanoseconds = summarize(std::move(samples));
+
+  if (use_counters) {
+    const auto divisor = static_cast<double>(std::max<std::size_t>(opts.repetitions, 1))
+                         * static_cast<double>(std::max<std::size_t>(operations, 1));
+    for (std::size_t counter = 0; counter < counter_sums.size(); ++counter) {
+      bench_result.counters.emplace_back(
+        std::string{ perf_counters::names[counter] }, static_cast<double>(counter_sums[counter]) / divisor);
+    }
+  }
+
+  return bench_result;
+}
+
+inline void print(const result &bench_result)
+{
+  fmt::print("{:<48} {:>12.1f} ns/op  median {:>12.0f} ns  min {:>12.0f} ns  p90 {:>12.0f} ns  stddev {:>6.1f}%",
+    bench_result.name,
+    bench_result.nanoseconds_per_operation(),
+    bench_result.nanoseconds.median,
+    bench_result.nanoseconds.min,
+    bench_result.nanoseconds.p90,
+    bench_result.nanoseconds.mean > 0 ? 100.0 * bench_result.nanoseconds.stddev / bench_result.nanoseconds.mean : 0.0);
+
+  for (const auto &[counter, value] : bench_result.counters) { fmt::print("  {} {:.1f}", counter, value); }
+  fmt::print("\n");
+}
+
+[[nodiscard]] inline nlohmann::json to_json(const result &bench_result)
+{
+  nlohmann::json value;
+  value["name"] = bench_result.name;
+  value["operations"] = bench_result.operations;
+  value["ns_per_op"] = bench_result.nanoseconds_per_operation();
+  value["ns"] = { { "min", bench_result.nanoseconds.min },
+    { "max", bench_result.nanoseconds.max },
+    { "mean", bench_result.nanoseconds.mean },
+    { "median", bench_result.nanoseconds.median },
+    { "stddev", bench_result.nanoseconds.stddev },
+    { "p90", bench_result.nanoseconds.p90 } };
+  for (const auto &[counter, counter_value] : bench_result.counters) { value["counters"][counter] = counter_value; }
+  return value;
+}
+
+// A set of benchmarks sharing options; benchmarks whose name does not contain
+// `filter` are skipped entirely
+class suite
+{
+public:
+  explicit suite(options opts, std::string filter = {}) : opts_{ opts }, filter_{ std::move(filter) } {}
+
+  template<typename Function> void add(std::string name, const std::size_t operations, Function &&function)
+  {
+    if (!filter_.empty() && name.find(filter_) == std::string::npos) { return; }
+    results_.push_back(run(std::move(name), opts_, operations, std::forward<Function>(function)));
+    print(results_.back());
+  }
+
+  [[nodiscard]] const options &opts() const noexcept { return opts_; }
+  [[nodiscard]] const std::vector<result> &results() const noexcept { return results_; }
+
+private:
+  options opts_;
+  std::string filter_;
+  std::vector<result> results_;
+};
+
+[[nodiscard]] inline nlohmann::json build_information()
+{
+  nlohmann::json info;
+#if defined(__clang__)
+  info["compiler"] = fmt::format("clang {}.{}.{}", __clang_major__, __clang_minor__, __clang_patchlevel__);
+#elif defined(__GNUC__)
+  info["compiler"] = fmt::format("gcc {}.{}.{}", __GNUC__, __GNUC_MINOR__, __GNUC_PATCHLEVEL__);
+#elif defined(_MSC_VER)
+  info["compiler"] = fmt::format("msvc {}", _MSC_VER);
+#endif
+#if defined(NDEBUG)
+  info["assertions"] = false;
+#else
+  info["assertions"] = true;
+#endif
+  return info;
+}
+
+}// namespace json2cpp::benchmark
+
+#endif
@@ -0,0 +1,381 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Measures what a document costs at build time: json2cpp run time, compiler
+// time and peak memory, and the size of the resulting object file, for a set of
+// synthetic document shapes that stress different parts of the generator.
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+
+#include "benchmark.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <elf.h>
+#endif
+
+namespace {
+
+struct process_result
+{
+  int exit_code{ -1 };
+  double wall_seconds{};
+  double cpu_seconds{};
+  std::uint64_t peak_rss_bytes{};
+};
+
+#if defined(__unix__) || defined(__APPLE__)
+process_result run_process(const std::vector<std::string> &arguments, const std::filesystem::path &working_directory)
+{
+  std::vector<char *> argv;
+  argv.reserve(arguments.size() + 1);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) execvp API
+  for (const auto &argument : arguments) { argv.push_back(const_cast<char *>(argument.c_str())); }
+  argv.push_back(nullptr);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  const auto pid = fork();
+  if (pid == 0) {
+    if (chdir(working_directory.c_str()) != 0) { _exit(127); }
+    // the generator logs every file it writes, keep the report readable
+    const int null_fd = open("/dev/null", O_WRONLY);// NOLINT vararg API
+    if (null_fd >= 0) { dup2(null_fd, STDOUT_FILENO); }
+    execvp(argv.front(), argv.data());
+    _exit(127);
+  }
+
+  if (pid < 0) { throw std::runtime_error(fmt::format("Unable to start '{}'", arguments.front())); }
+
+  int status = 0;
+  rusage usage{};
+  wait4(pid, &status, 0, &usage);
+
+  const auto stop = std::chrono::steady_clock::now();
+
+  const auto seconds = [](const timeval &time) {
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_usec) / 1e6;
+  };
+
+  process_result result;
+  result.exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  result.wall_seconds = std::chrono::duration<double>(stop - start).count();
+  result.cpu_seconds = seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#if defined(__APPLE__)
+  result.peak_rss_bytes = static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+  result.peak_rss_bytes = static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+  return result;
+}
+#else
+process_result run_process(const std::vector<std::string> &arguments, const std::filesystem::path &)
+{
+  throw std::runtime_error(fmt::format("Unable to start '{}': not supported on this platform", arguments.front()));
+}
+#endif
+
+// Sizes of the sections the generated data ends up in. Constant data without
+// relocations lands in .rodata, data holding pointers (every node and pair array)
+// in .data.rel.ro when compiling position independent code.
+std::map<std::string, std::uint64_t> section_sizes(const std::filesystem::path &object_file)
+{
+  std::map<std::string, std::uint64_t> sizes;
+#if defined(__linux__)
+  std::ifstream input(object_file, std::ios::binary);
+  std::ostringstream buffer;
+  buffer << input.rdbuf();
+  const std::string contents = buffer.str();
+
+  Elf64_Ehdr header{};
+  if (contents.size() < sizeof(header)) { return sizes; }
+  std::memcpy(&header, contents.data(), sizeof(header));
+  if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64) { return sizes; }
+
+  const auto section = [&](const std::size_t index) {
+    Elf64_Shdr section_header{};
+    const auto offset = header.e_shoff + index * header.e_shentsize;
+    if (offset + sizeof(section_header) <= contents.size()) {
+      std::memcpy(
+        &section_header, std::next(contents.data(), static_cast<std::ptrdiff_t>(offset)), sizeof(section_header));
+    }
+    return section_header;
+  };
+
+  const auto names = section(header.e_shstrndx);
+
+  for (std::size_t index = 0; index < header.e_shnum; ++index) {
+    const auto current = section(index);
+    if (names.sh_offset + current.sh_name >= contents.size()) { continue; }
+    const std::string_view name{ std::next(
+      contents.data(), static_cast<std::ptrdiff_t>(names.sh_offset + current.sh_name)) };
+
+    // -fdata-sections and comdat groups give every variable its own section, group them by kind
+    for (const auto prefix : { std::string_view{ ".rodata" }, std::string_view{ ".data.rel.ro" } }) {
+      if (name.substr(0, prefix.size()) == prefix) { sizes[std::string{ prefix }] += current.sh_size; }
+    }
+  }
+#else
+  static_cast<void>(object_file);
+#endif
+  return sizes;
+}
+
+// The synthetic shapes, each targeting a different cost in the generated code
+nlohmann::json deep_document(const std::size_t scale)
+{
+  nlohmann::json document = { { "leaf", 42 } };
+  for (std::size_t depth = 0; depth < 200 * scale; ++depth) {
+    document = nlohmann::json{ { "depth", depth }, { "child", std::move(document) } };
+  }
+  return document;
+}
+
+nlohmann::json wide_document(const std::size_t scale)
+{
+  nlohmann::json document = nlohmann::json::object();
+  for (std::size_t idx = 0; idx < 10000 * scale; ++idx) { document[fmt::format("key_{:08}", idx)] = idx; }
+  return document;
+}
+
+nlohmann::json long_array_document(const std::size_t scale)
+{
+  nlohmann::json document = nlohmann::json::array();
+  for (std::size_t idx = 0; idx < 50000 * scale; ++idx) {
+    if (idx % 2 == 0) {
+      document.push_back(idx);
+    } else {
+      document.push_back(static_cast<double>(idx) * 0.1);
+    }
+  }
+  return document;
+}
+
+nlohmann::json repeated_subtrees_document(const std::size_t scale)
+{
+  const nlohmann::json subtree = { { "name", "Construction Layer" },
+    { "roughness", "MediumRough" },
+    { "thickness", 0.1016 },
+    { "conductivity", 1.311 },
+    { "density", 2240 },
+    { "layers", { "Outside", "Inside", nullptr, true } } };
+
+  nlohmann::json document = nlohmann::json::object();
+  for (std::size_t idx = 0; idx < 2000 * scale; ++idx) { document[fmt::format("layer_{:08}", idx)] = subtree; }
+  return document;
+}
+
+nlohmann::json long_strings_document(const std::size_t scale)
+{
+  nlohmann::json document = nlohmann::json::array();
+  for (std::size_t idx = 0; idx < 500 * scale; ++idx) {
+    std::string value(4096, 'a');
+    for (std::size_t character = 0; character < value.size(); ++character) {
+      value[character] = static_cast<char>('a' + (character * 7 + idx) % 26);
+    }
+    document.push_back(std::move(value));
+  }
+  return document;
+}
+
+struct shape
+{
+  std::string_view name;
+  nlohmann::json (*generate)(std::size_t scale);
+};
+
+constexpr std::array shapes{ shape{ "deep", deep_document },
+  shape{ "wide", wide_document },
+  shape{ "long_array", long_array_document },
+  shape{ "repeated_subtrees", repeated_subtrees_document },
+  shape{ "long_strings", long_strings_document } };
+
+std::vector<std::string> split_arguments(const std::string &arguments)
+{
+  std::vector<std::string> result;
+  std::istringstream stream(arguments);
+  std::string argument;
+  while (stream >> argument) { result.push_back(argument); }
+  return result;
+}
+
+nlohmann::json to_json(const std::vector<process_result> &runs)
+{
+  std::vector<double> wall;
+  std::vector<double> cpu;
+  std::uint64_t peak_rss = 0;
+  for (const auto &run : runs) {
+    wall.push_back(run.wall_seconds);
+    cpu.push_back(run.cpu_seconds);
+    peak_rss = std::max(peak_rss, run.peak_rss_bytes);
+  }
+
+  const auto wall_stats = json2cpp::benchmark::summarize(wall);
+  return nlohmann::json{ { "wall_seconds",
+                           { { "min", wall_stats.min },
+                             { "median", wall_stats.median },
+                             { "max", wall_stats.max },
+                             { "stddev", wall_stats.stddev } } },
+    { "cpu_seconds_median", json2cpp::benchmark::summarize(cpu).median },
+    { "peak_rss_bytes", peak_rss } };
+}
+
+}// namespace
+
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app("build_benchmark version 0.0.1");
+
+    std::string json2cpp_executable = "json2cpp";
+    std::string json2cpp_arguments;
+    std::string compiler = JSON2CPP_CXX_COMPILER;
+    std::string compiler_flags = fmt::format("-std=c++{} -O2", JSON2CPP_CXX_STANDARD);
+    std::filesystem::path include_dir = JSON2CPP_INCLUDE_DIR;
+    std::filesystem::path work_dir = std::filesystem::temp_directory_path() / "json2cpp_build_benchmark";
+    std::filesystem::path json_output;
+    std::size_t scale = 1;
+    std::size_t repetitions = 1;
+    std::vector<std::string> selected_shapes;
+
+    app.add_option("--json2cpp", json2cpp_executable, "Path to the json2cpp executable");
+    app.add_option("--json2cpp-args", json2cpp_arguments, "Extra arguments for json2cpp, eg --low-compile-cost");
+    app.add_option("--compiler", compiler, "C++ compiler used to build the generated code");
+    app.add_option("--flags", compiler_flags, "Flags passed to the compiler");
+    app.add_option("--include", include_dir, "json2cpp include directory");
+    app.add_option("--work-dir", work_dir, "Directory for the generated documents and objects");
+    app.add_option("--scale", scale, "Multiplier for the size of every shape");
+    app.add_option("--repetitions", repetitions, "Number of times each step is repeated");
+    app.add_option(
+      "--shape", selected_shapes, "Only run these shapes (deep, wide, long_array, repeated_subtrees, long_strings)");
+    app.add_option("--json", json_output, "Write the results as JSON to this file");
+
+    CLI11_PARSE(app, argc, argv);
+
+    std::filesystem::create_directories(work_dir);
+
+    nlohmann::json output;
+    output["compiler"] = compiler;
+    output["flags"] = compiler_flags;
+    output["json2cpp_args"] = json2cpp_arguments;
+    output["scale"] = scale;
+    output["shapes"] = nlohmann::json::object();
+
+    fmt::print("{:<20} {:>12} {:>12} {:>14} {:>14} {:>14} {:>14}\n",
+      "shape",
+      "json2cpp s",
+      "compile s",
+      "compile RSS MB",
+      "object KiB",
+      ".rodata KiB",
+      ".data.rel.ro KiB");
+
+    for (const auto &current : shapes) {
+      if (!selected_shapes.empty()
+          && std::find(selected_shapes.begin(), selected_shapes.end(), current.name) == selected_shapes.end()) {
+        continue;
+      }
+
+      const std::string name{ current.name };
+      const auto input_file = work_dir / (name + ".json");
+      {
+        std::ofstream input(input_file);
+        input << current.generate(scale).dump();
+      }
+
+      std::vector<std::string> generate_command{ json2cpp_executable };
+      for (auto &argument : split_arguments(json2cpp_arguments)) { generate_command.push_back(std::move(argument)); }
+      generate_command.insert(generate_command.end(), { name, input_file.string(), (work_dir / name).string() });
+
+      std::vector<std::string> compile_command{ compiler };
+      for (auto &argument : split_arguments(compiler_flags)) { compile_command.push_back(std::move(argument)); }
+      const auto object_file = work_dir / (name + ".o");
+      compile_command.insert(compile_command.end(),
+        { fmt::format("-I{}", include_dir.string()),
+          "-c",
+          (work_dir / (name + ".cpp")).string(),
+          "-o",
+          object_file.string() });
+
+      std::vector<process_result> generate_runs;
+      std::vector<process_result> compile_runs;
+      for (std::size_t idx = 0; idx < repetitions; ++idx) {
+        generate_runs.push_back(run_process(generate_command, work_dir));
+        if (generate_runs.back().exit_code != 0) {
+          throw std::runtime_error(fmt::format("json2cpp failed for '{}'", name));
+        }
+        compile_runs.push_back(run_process(compile_command, work_dir));
+        if (compile_runs.back().exit_code != 0) {
+          throw std::runtime_error(fmt::format("compiler failed for '{}'", name));
+        }
+      }
+
+      const auto sections = section_sizes(object_file);
+      const auto section_size = [&](const std::string &section) {
+        const auto found = sections.find(section);
+        return found == sections.end() ? std::uint64_t{ 0 } : found->second;
+      };
+
+      auto &result = output["shapes"][name];
+      result["input_bytes"] = std::filesystem::file_size(input_file);
+      result["json2cpp"] = to_json(generate_runs);
+      result["compile"] = to_json(compile_runs);
+      result["object_bytes"] = std::filesystem::file_size(object_file);
+      result["sections"] = sections;
+
+      fmt::print("{:<20} {:>12.2f} {:>12.2f} {:>14.1f} {:>14.1f} {:>14.1f} {:>14.1f}\n",
+        name,
+        result["json2cpp"]["wall_seconds"]["median"].get<double>(),
+        result["compile"]["wall_seconds"]["median"].get<double>(),
+        static_cast<double>(result["compile"]["peak_rss_bytes"].get<std::uint64_t>()) / (1024.0 * 1024.0),
+        static_cast<double>(std::filesystem::file_size(object_file)) / 1024.0,
+        static_cast<double>(section_size(".rodata")) / 1024.0,
+        static_cast<double>(section_size(".data.rel.ro")) / 1024.0);
+    }
+
+    if (!json_output.empty()) {
+      std::ofstream json_file(json_output);
+      json_file << output.dump(2) << '\n';
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in main: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
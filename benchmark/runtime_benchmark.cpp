@@ -0,0 +1,560 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+#include <spdlog/spdlog.h>
+
+#include <json2cpp/json2cpp_adapter.hpp>
+#include <json2cpp/json2cpp_compressed.hpp>
+#include <json2cpp/json2cpp_cursor.hpp>
+#include <json2cpp/json2cpp_hash.hpp>
+#include <json2cpp/json2cpp_parallel.hpp>
+#include <json2cpp/json2cpp_parser.hpp>
+#include <json2cpp/json2cpp_schema_subset.hpp>
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
+#include <valijson/schema.hpp>
+#include <valijson/schema_parser.hpp>
+#include <valijson/validator.hpp>
+
+#include "allof_integers_and_numbers_schema.hpp"
+#include "array_integers_10_20_30_40.hpp"
+#include "benchmark.hpp"
+#include "epjson_model_schema.hpp"
+#include "epjson_model_schema_validator.hpp"
+#include "refbldg_compressed.hpp"
+#include "refbldg_medium_office.hpp"
+
+namespace {
+
+using json2cpp::benchmark::do_not_optimize;
+
+nlohmann::json load(const std::filesystem::path &filename)
+{
+  std::ifstream input(filename);
+  nlohmann::json document;
+  input >> document;
+  return document;
+}
+
+std::string_view string_of(const json2cpp::json &value) { return value.get<std::string_view>(); }
+std::string_view string_of(const nlohmann::json &value) { return value.get_ref<const std::string &>(); }
+
+// Keys used for the lookup benchmarks, taken from the document itself so both
+// representations see exactly the same queries
+struct lookup_keys
+{
+  std::vector<std::string> top_level;
+  std::vector<std::pair<std::string, std::string>> nested;
+  std::vector<std::string> missing;
+};
+
+lookup_keys collect_keys(const nlohmann::json &document)
+{
+  lookup_keys keys;
+  for (const auto &[key, value] : document.items()) {
+    keys.top_level.push_back(key);
+    keys.missing.push_back(key + "_missing");
+    if (value.is_object()) {
+      for (const auto &[child_key, child] : value.items()) { keys.nested.emplace_back(key, child_key); }
+    }
+  }
+  return keys;
+}
+
+template<typename JSON> struct typed_nodes
+{
+  std::vector<const JSON *> integers;
+  std::vector<const JSON *> doubles;
+  std::vector<const JSON *> strings;
+};
+
+template<typename JSON> void collect_nodes(const JSON &value, typed_nodes<JSON> &nodes)
+{
+  if (value.is_number_integer()) {
+    nodes.integers.push_back(&value);
+  } else if (value.is_number_float()) {
+    nodes.doubles.push_back(&value);
+  } else if (value.is_string()) {
+    nodes.strings.push_back(&value);
+  } else if (value.is_structured()) {
+    for (const auto &child : value) { collect_nodes(child, nodes); }
+  }
+}
+
+struct walk_totals
+{
+  std::int64_t int_sum{};
+  double double_sum{};
+  std::size_t string_sizes{};
+  std::size_t null_count{};
+  std::size_t array_count{};
+  std::size_t object_count{};
+};
+
+// same traversal as `walk_internal` in src/schema_validator.cpp
+template<typename JSON> void walk(const JSON &obj, walk_totals &totals)
+{
+  if (obj.is_number_integer()) {
+    totals.int_sum += obj.template get<std::int64_t>();
+  } else if (obj.is_number_float()) {
+    totals.double_sum += obj.template get<double>();
+  } else if (obj.is_string()) {
+    totals.string_sizes += string_of(obj).size();
+  } else if (obj.is_null()) {
+    ++totals.null_count;
+  } else if (obj.is_array()) {
+    ++totals.array_count;
+    for (const auto &child : obj) { walk(child, totals); }
+  } else if (obj.is_object()) {
+    ++totals.object_count;
+    for (const auto &child : obj) { walk(child, totals); }
+  }
+}
+
+// `walk` switching on each node's type once with json2cpp::visit
+void walk_visit(const json2cpp::json &obj, walk_totals &totals)
+{
+  json2cpp::visit(
+    [&](const auto &value) {
+      using type = std::decay_t<decltype(value)>;
+      if constexpr (std::is_same_v<type, std::int64_t> || std::is_same_v<type, std::uint64_t>) {
+        totals.int_sum += static_cast<std::int64_t>(value);
+      } else if constexpr (std::is_same_v<type, double>) {
+        totals.double_sum += value;
+      } else if constexpr (std::is_same_v<type, std::string_view>) {
+        totals.string_sizes += value.size();
+      } else if constexpr (std::is_same_v<type, std::nullptr_t>) {
+        ++totals.null_count;
+      } else if constexpr (std::is_same_v<type, json2cpp::array_t>) {
+        ++totals.array_count;
+        for (const auto &child : value) { walk_visit(child, totals); }
+      } else if constexpr (std::is_same_v<type, json2cpp::object_t>) {
+        ++totals.object_count;
+        for (const auto &member : value) { walk_visit(member.second, totals); }
+      }
+    },
+    obj);
+}
+
+// the part of `walk` for one node, for traversals that do the recursion themselves
+void add_node(const json2cpp::json &obj, walk_totals &totals)
+{
+  if (obj.is_number_integer()) {
+    totals.int_sum += obj.get<std::int64_t>();
+  } else if (obj.is_number_float()) {
+    totals.double_sum += obj.get<double>();
+  } else if (obj.is_string()) {
+    totals.string_sizes += obj.get<std::string_view>().size();
+  } else if (obj.is_null()) {
+    ++totals.null_count;
+  } else if (obj.is_array()) {
+    ++totals.array_count;
+  } else if (obj.is_object()) {
+    ++totals.object_count;
+  }
+}
+
+template<typename JSON> std::size_t count_nodes(const JSON &value)
+{
+  std::size_t count = 1;
+  if (value.is_structured()) {
+    for (const auto &child : value) { count += count_nodes(child); }
+  }
+  return count;
+}
+
+template<typename JSON>
+void run_document_benchmarks(std::string_view library,
+  const JSON &document,
+  const lookup_keys &keys,
+  json2cpp::benchmark::suite &suite)
+{
+  const auto name = [&](std::string_view benchmark) { return fmt::format("{}/{}", library, benchmark); };
+
+  suite.add(name("lookup_hit/top_level"), keys.top_level.size(), [&] {
+    std::size_t found = 0;
+    for (const auto &key : keys.top_level) { found += static_cast<std::size_t>(document.find(key) != document.end()); }
+    do_not_optimize(found);
+  });
+
+  suite.add(name("lookup_hit/nested"), keys.nested.size(), [&] {
+    std::size_t sizes = 0;
+    for (const auto &[outer, inner] : keys.nested) { sizes += document.at(outer).at(inner).size(); }
+    do_not_optimize(sizes);
+  });
+
+  suite.add(name("lookup_miss/top_level"), keys.missing.size(), [&] {
+    std::size_t found = 0;
+    for (const auto &key : keys.missing) { found += static_cast<std::size_t>(document.find(key) != document.end()); }
+    do_not_optimize(found);
+  });
+
+  const auto node_count = count_nodes(document);
+
+  suite.add(name("traversal/walk"), node_count, [&] {
+    walk_totals totals;
+    walk(document, totals);
+    do_not_optimize(totals);
+  });
+
+  const auto iterate_two_levels = [&] {
+    std::size_t elements = 0;
+    for (const auto &child : document) {
+      for (const auto &grandchild : child) {
+        do_not_optimize(grandchild);
+        ++elements;
+      }
+    }
+    return elements;
+  };
+
+  suite.add(name("iteration/two_levels"), iterate_two_levels(), [&] { do_not_optimize(iterate_two_levels()); });
+
+  typed_nodes<JSON> nodes;
+  collect_nodes(document, nodes);
+
+  suite.add(name("get/int64"), nodes.integers.size(), [&] {
+    std::int64_t sum = 0;
+    for (const auto *node : nodes.integers) { sum += node->template get<std::int64_t>(); }
+    do_not_optimize(sum);
+  });
+
+  suite.add(name("get/double"), nodes.doubles.size(), [&] {
+    double sum = 0;
+    for (const auto *node : nodes.doubles) { sum += node->template get<double>(); }
+    do_not_optimize(sum);
+  });
+
+  suite.add(name("get/string"), nodes.strings.size(), [&] {
+    std::size_t sizes = 0;
+    for (const auto *node : nodes.strings) { sizes += string_of(*node).size(); }
+    do_not_optimize(sizes);
+  });
+}
+
+void run_validation_benchmarks(const std::filesystem::path &examples, json2cpp::benchmark::suite &suite)
+{
+  using valijson::Schema;
+  using valijson::SchemaParser;
+  using valijson::Validator;
+  using valijson::adapters::json2cppJsonAdapter;
+  using valijson::adapters::NlohmannJsonAdapter;
+
+  const auto schema_document = load(examples / "allof_integers_and_numbers.schema.json");
+  const auto target_document = load(examples / "array_integers_10_20_30_40.json");
+
+  suite.add("json2cpp/valijson/populate_schema", 1, [&] {
+    Schema schema;
+    SchemaParser parser;
+    parser.populateSchema(json2cppJsonAdapter(compiled_json::allof_integers_and_numbers_schema::get()), schema);
+    do_not_optimize(schema);
+  });
+
+  suite.add("nlohmann/valijson/populate_schema", 1, [&] {
+    Schema schema;
+    SchemaParser parser;
+    parser.populateSchema(NlohmannJsonAdapter(schema_document), schema);
+    do_not_optimize(schema);
+  });
+
+  Schema schema;
+  SchemaParser parser;
+  parser.populateSchema(json2cppJsonAdapter(compiled_json::allof_integers_and_numbers_schema::get()), schema);
+
+  constexpr std::size_t validations = 1000;
+
+  suite.add("json2cpp/valijson/validate", validations, [&] {
+    Validator validator;
+    const json2cppJsonAdapter target(compiled_json::array_integers_10_20_30_40::get());
+    bool valid = true;
+    for (std::size_t idx = 0; idx < validations; ++idx) {
+      valid = validator.validate(schema, target, nullptr) && valid;
+    }
+    do_not_optimize(valid);
+  });
+
+  suite.add("nlohmann/valijson/validate", validations, [&] {
+    Validator validator;
+    const NlohmannJsonAdapter target(target_document);
+    bool valid = true;
+    for (std::size_t idx = 0; idx < validations; ++idx) {
+      valid = validator.validate(schema, target, nullptr) && valid;
+    }
+    do_not_optimize(valid);
+  });
+
+  // the reference building model against a schema of its structure: valijson interpreting
+  // the schema compared with the validator json2cpp --validator generated from it
+  const auto model = load(examples / "RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+
+  Schema model_schema;
+  parser.populateSchema(json2cppJsonAdapter(compiled_json::epjson_model_schema::get()), model_schema);
+
+  suite.add("json2cpp/valijson/populate_model_schema", 1, [&] {
+    Schema populated;
+    SchemaParser model_parser;
+    model_parser.populateSchema(json2cppJsonAdapter(compiled_json::epjson_model_schema::get()), populated);
+    do_not_optimize(populated);
+  });
+
+  suite.add("json2cpp/valijson/populate_model_schema_subset", 1, [&] {
+    const json2cpp::schema_subset subset{ compiled_json::epjson_model_schema::get(), model };
+    Schema populated;
+    SchemaParser model_parser;
+    model_parser.populateSchema(json2cppJsonAdapter(subset.get()), populated);
+    do_not_optimize(populated);
+  });
+
+  suite.add("nlohmann/valijson/validate_model", 1, [&] {
+    Validator validator;
+    do_not_optimize(validator.validate(model_schema, NlohmannJsonAdapter(model), nullptr));
+  });
+
+  suite.add("nlohmann/generated/validate_model", 1, [&] {
+    do_not_optimize(compiled_json::epjson_model_schema::validator::validate(model));
+  });
+
+  suite.add("json2cpp/generated/validate_model", 1, [&] {
+    do_not_optimize(
+      compiled_json::epjson_model_schema::validator::validate(compiled_json::refbldg_medium_office::get()));
+  });
+}
+
+// parsing the reference building model at runtime, into json2cpp's layout and into nlohmann::json
+void run_parse_benchmarks(const std::filesystem::path &examples, json2cpp::benchmark::suite &suite)
+{
+  std::ifstream input(examples / "RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  std::ostringstream buffer;
+  buffer << input.rdbuf();
+  const std::string text = buffer.str();
+
+  suite.add("json2cpp/parse/in_situ", 1, [&] { do_not_optimize(json2cpp::parse(text)); });
+  suite.add("json2cpp/parse/copy_strings", 1, [&] {
+    do_not_optimize(json2cpp::parse(text, json2cpp::parse_options{ true }));
+  });
+  suite.add("nlohmann/parse", 1, [&] { do_not_optimize(nlohmann::json::parse(text)); });
+}
+
+// comparing the compiled reference building model with a runtime copy of it, whole and with one member added
+void run_compare_benchmarks(const nlohmann::json &document, json2cpp::benchmark::suite &suite)
+{
+  const auto &compiled = compiled_json::refbldg_medium_office::get();
+  const auto &compiled_hashes = compiled_json::refbldg_medium_office::hashes();
+
+  const auto same_text = document.dump();
+  const auto same = json2cpp::parse(same_text);
+  const json2cpp::hash_index same_hashes{ same.root() };
+
+  const auto same_document = document;
+  auto changed_document = document;
+  changed_document["json2cpp_benchmark"] = 1;
+  const auto changed_text = changed_document.dump();
+  const auto changed = json2cpp::parse(changed_text);
+  const json2cpp::hash_index changed_hashes{ changed.root() };
+
+  suite.add("json2cpp/compare/hash_index", 1, [&] { do_not_optimize(json2cpp::hash_index{ same.root() }); });
+  suite.add("json2cpp/compare/operator==", 1, [&] { do_not_optimize(compiled == same.root()); });
+  suite.add("json2cpp/compare/equal", 1, [&] {
+    do_not_optimize(json2cpp::equal(compiled, compiled_hashes, same.root(), same_hashes));
+  });
+  suite.add("json2cpp/compare/diff_one_added", 1, [&] {
+    do_not_optimize(json2cpp::diff(compiled, compiled_hashes, changed.root(), changed_hashes));
+  });
+  suite.add("nlohmann/compare/operator==", 1, [&] { do_not_optimize(document == same_document); });
+  suite.add("nlohmann/compare/diff_one_added", 1, [&] {
+    do_not_optimize(nlohmann::json::diff(document, changed_document));
+  });
+}
+
+// the member views of compiled objects, json2cpp::visit and the cursors, against the generic iterator and type
+// checks in run_document_benchmarks
+void run_compiled_access_benchmarks(const lookup_keys &keys, json2cpp::benchmark::suite &suite)
+{
+  const auto &compiled = compiled_json::refbldg_medium_office::get();
+
+  const auto iterate_two_levels = [&] {
+    std::size_t elements = 0;
+    for (const auto &child : compiled.values()) {
+      for (const auto &grandchild : child.values()) {
+        do_not_optimize(grandchild);
+        ++elements;
+      }
+    }
+    return elements;
+  };
+  suite.add("json2cpp/iteration/two_levels_values", iterate_two_levels(), [&] {
+    do_not_optimize(iterate_two_levels());
+  });
+
+  suite.add("json2cpp/traversal/walk_visit", count_nodes(compiled), [&] {
+    walk_totals totals;
+    walk_visit(compiled, totals);
+    do_not_optimize(totals);
+  });
+
+  // the model is 5 levels deep, so the cursors can keep their path in a std::array
+  constexpr std::size_t depth = 8;
+  suite.add("json2cpp/traversal/depth_first_cursor", count_nodes(compiled), [&] {
+    walk_totals totals;
+    for (const auto &entry : json2cpp::depth_first_cursor<depth>{ compiled }) { add_node(*entry.node, totals); }
+    do_not_optimize(totals);
+  });
+  suite.add("json2cpp/traversal/breadth_first_cursor", count_nodes(compiled), [&] {
+    walk_totals totals;
+    for (const auto &entry : json2cpp::breadth_first_cursor<depth>{ compiled }) { add_node(*entry.node, totals); }
+    do_not_optimize(totals);
+  });
+
+  // generated objects are sorted unless laid out for a profile, and then keys() can
+  // be bisected where find() scans
+  const auto compiled_keys = compiled.keys();
+  if (!std::is_sorted(compiled_keys.begin(), compiled_keys.end())) { return; }
+  suite.add("json2cpp/lookup_hit/top_level_lower_bound", keys.top_level.size(), [&] {
+    std::size_t found = 0;
+    for (const auto &key : keys.top_level) {
+      const auto itr = std::lower_bound(compiled_keys.begin(), compiled_keys.end(), std::string_view{ key });
+      found += static_cast<std::size_t>(itr != compiled_keys.end() && *itr == key);
+    }
+    do_not_optimize(found);
+  });
+}
+
+// `walk` split over a thread pool, for several thread counts; compare with json2cpp/traversal/walk
+void run_parallel_benchmarks(json2cpp::benchmark::suite &suite)
+{
+  const auto &compiled = compiled_json::refbldg_medium_office::get();
+  const auto node_count = count_nodes(compiled);
+
+  const auto accumulate = [](walk_totals &totals, const json2cpp::json &obj) { add_node(obj, totals); };
+  const auto combine = [](walk_totals lhs, const walk_totals &rhs) {
+    lhs.int_sum += rhs.int_sum;
+    lhs.double_sum += rhs.double_sum;
+    lhs.string_sizes += rhs.string_sizes;
+    lhs.null_count += rhs.null_count;
+    lhs.array_count += rhs.array_count;
+    lhs.object_count += rhs.object_count;
+    return lhs;
+  };
+
+  std::vector<std::size_t> thread_counts{ 1, 2, 4 };
+  if (const std::size_t hardware = std::thread::hardware_concurrency(); hardware > 4) {
+    thread_counts.push_back(hardware);
+  }
+
+  for (const auto threads : thread_counts) {
+    json2cpp::thread_pool pool(threads);
+    const json2cpp::walk_plan plan{ compiled, pool.size() };
+    suite.add(fmt::format("json2cpp/traversal/parallel_walk_{}_threads", threads), node_count, [&] {
+      do_not_optimize(json2cpp::parallel_reduce(pool, plan, walk_totals{}, accumulate, combine));
+    });
+  }
+
+  suite.add("json2cpp/traversal/walk_plan", node_count, [&] {
+    do_not_optimize(json2cpp::walk_plan{ compiled, std::thread::hardware_concurrency() }.tasks().size());
+  });
+}
+
+// the first access of a compressed document, which decompresses and parses it
+void run_compressed_benchmarks(const nlohmann::json &document, json2cpp::benchmark::suite &suite)
+{
+  const auto text = document.dump();
+  const auto compressed = json2cpp::compress(text);
+  const auto *data = reinterpret_cast<const unsigned char *>(compressed.data());
+  spdlog::info("Reference building model compressed from {} to {} bytes", text.size(), compressed.size());
+
+  suite.add("json2cpp_compressed/decompress", 1, [&] {
+    do_not_optimize(json2cpp::decompress(data, compressed.size(), text.size()));
+  });
+  suite.add("json2cpp_compressed/first_access", 1, [&] {
+    const json2cpp::compressed_subtree subtree{ data, compressed.size(), text.size() };
+    do_not_optimize(subtree.get().size());
+  });
+}
+
+}// namespace
+
+int main(int argc, const char **argv)
+{
+  try {
+    CLI::App app("runtime_benchmark version 0.0.1");
+
+    json2cpp::benchmark::options opts;
+    std::filesystem::path examples{ JSON2CPP_EXAMPLES_DIR };
+    std::filesystem::path json_output;
+    std::string filter;
+
+    app.add_option("--repetitions", opts.repetitions, "Measured repetitions of each benchmark");
+    app.add_option("--warmup", opts.warmup, "Unmeasured warm-up runs of each benchmark");
+    app.add_flag("--perf", opts.perf_counters, "Collect hardware counters with perf_event_open (Linux only)");
+    app.add_option("--examples", examples, "Directory containing the example documents");
+    app.add_option("--json", json_output, "Write the results as JSON to this file");
+    app.add_option("--filter", filter, "Only report benchmarks whose name contains this string");
+
+    CLI11_PARSE(app, argc, argv);
+
+    spdlog::info("Loading nlohmann::json version of the document");
+    const auto document = load(examples / "RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+    const auto keys = collect_keys(document);
+
+    json2cpp::benchmark::suite suite(opts, filter);
+    run_document_benchmarks("json2cpp", compiled_json::refbldg_medium_office::get(), keys, suite);
+    run_document_benchmarks("nlohmann", document, keys, suite);
+    run_compiled_access_benchmarks(keys, suite);
+    run_parallel_benchmarks(suite);
+    // in situ: `parsed` refers to the strings of `model_text`
+    const auto model_text = document.dump();
+    const auto parsed = json2cpp::parse(model_text);
+    run_document_benchmarks("json2cpp_parsed", parsed.root(), keys, suite);
+    // steady state, every member already expanded
+    run_document_benchmarks("json2cpp_compressed", compiled_json::refbldg_compressed::get(), keys, suite);
+    run_parse_benchmarks(examples, suite);
+    run_compressed_benchmarks(document, suite);
+    run_compare_benchmarks(document, suite);
+    run_validation_benchmarks(examples, suite);
+
+    nlohmann::json output;
+    output["build"] = json2cpp::benchmark::build_information();
+    output["benchmarks"] = nlohmann::json::array();
+    for (const auto &result : suite.results()) {
+      output["benchmarks"].push_back(json2cpp::benchmark::to_json(result));
+    }
+
+    if (!json_output.empty()) {
+      std::ofstream json_file(json_output);
+      json_file << output.dump(2) << '\n';
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Unhandled exception in main: {}", e.what());
+    return EXIT_FAILURE;
+  }
+}
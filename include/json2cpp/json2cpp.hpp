@@ -30,9 +30,31 @@ SOFTWARE.
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <stdexcept>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+
+#ifdef JSON2CPP_PROFILE
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#endif
+
+// Placement of the arrays and objects that `json2cpp --profile` found unused: a
+// section of their own on ELF targets, which the default linker scripts put after
+// the rest of the document's data. Define it before including this header to
+// choose something else, or nothing.
+#ifndef JSON2CPP_COLD
+#if defined(__GNUC__) && defined(__ELF__)
+#define JSON2CPP_COLD __attribute__((section(".data.rel.ro.json2cpp_cold")))
+#else
+#define JSON2CPP_COLD
+#endif
+#endif
 
 // simple pair to speed up compilation a bit compared to std::pair
 namespace json2cpp {
@@ -52,6 +74,9 @@ template<typename T> struct span
 
   constexpr span() : begin_{ nullptr }, end_{ nullptr } {}
 
+  // a view of contiguous elements that outlive it, such as a std::vector's
+  constexpr span(const T *first, const T *last) : begin_{ first }, end_{ last } {}
+
   [[nodiscard]] constexpr const T *begin() const noexcept { return begin_; }
 
   [[nodiscard]] constexpr const T *end() const noexcept { return end_; }
@@ -61,17 +86,235 @@ template<typename T> struct span
     return static_cast<std::size_t>(std::distance(begin_, end_));
   }
 
+  [[nodiscard]] constexpr bool empty() const noexcept { return begin_ == end_; }
+
+  [[nodiscard]] constexpr const T &operator[](const std::size_t idx) const noexcept { return begin_[idx]; }
+
   const T *begin_;
   const T *end_;
 };
 
+#ifdef JSON2CPP_PROFILE
+// Access counts recorded by an instrumented build, one entry per array or object
+// keyed by the address of its children; json2cpp_profile.hpp writes them out
+namespace profile_detail {
+  struct key_counts
+  {
+    std::uint64_t lookups{ 0 };
+    // keys compared before the lookup found the member, or gave up
+    std::uint64_t comparisons{ 0 };
+  };
+
+  struct node_counts
+  {
+    std::uint64_t touches{ 0 };
+    std::unordered_map<std::string, key_counts> keys;
+  };
+
+  struct recorder
+  {
+    std::mutex mutex;
+    std::unordered_map<const void *, node_counts> nodes;
+  };
+
+  inline recorder &instance()
+  {
+    static recorder counts;
+    return counts;
+  }
+
+  // Recording never throws, so accessors keep their noexcept in a profiling build:
+  // an access that cannot be counted, for want of memory or the lock, is left out
+  inline void touch(const void *children) noexcept
+  {
+    try {
+      auto &counts = instance();
+      const std::lock_guard lock(counts.mutex);
+      ++counts.nodes[children].touches;
+    } catch (...) {
+      // not counted
+    }
+  }
+
+  inline void lookup(const void *children, const std::string_view key, const std::size_t comparisons) noexcept
+  {
+    try {
+      auto &counts = instance();
+      const std::lock_guard lock(counts.mutex);
+      auto &key_count = counts.nodes[children].keys[std::string{ key }];
+      ++key_count.lookups;
+      key_count.comparisons += comparisons;
+    } catch (...) {
+      // not counted
+    }
+  }
+
+  // nothing is recorded while the compiler evaluates constant expressions
+  [[nodiscard]] constexpr bool constant_evaluated() noexcept
+  {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#else
+    return __builtin_is_constant_evaluated();
+#endif
+  }
+}// namespace profile_detail
+#endif
+
 template<typename CharType> struct basic_json;
 template<typename CharType> using basic_array_t = span<basic_json<CharType>>;
 template<typename CharType> using basic_value_pair_t = pair<std::basic_string_view<CharType>, basic_json<CharType>>;
+// The members of an object. Their order is unspecified: the generator emits them
+// sorted by key, as nlohmann::json keeps them, but `json2cpp --profile` puts each
+// object's most looked-up keys first, so code that relies on the order has to
+// check it (`std::is_sorted`) rather than assume it.
 template<typename CharType> using basic_object_t = span<basic_value_pair_t<CharType>>;
 
 using binary_t = span<std::uint8_t>;
 
+// What the member iterators below yield of each member of an object
+struct member_key
+{
+  template<typename Member> constexpr const auto &operator()(const Member &member) const noexcept
+  {
+    return member.first;
+  }
+};
+
+struct member_value
+{
+  template<typename Member> constexpr const auto &operator()(const Member &member) const noexcept
+  {
+    return member.second;
+  }
+};
+
+struct whole_member
+{
+  template<typename Member> constexpr const Member &operator()(const Member &member) const noexcept { return member; }
+};
+
+// A random access iterator over the members of an object: a pointer to the current
+// member, yielding what `Projection` selects of it
+template<typename CharType, typename Projection> struct member_iterator
+{
+  using member_type = basic_value_pair_t<CharType>;
+  using iterator_category = std::random_access_iterator_tag;
+  using reference = decltype(Projection{}(std::declval<const member_type &>()));
+  using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::add_pointer_t<reference>;
+
+  constexpr member_iterator() noexcept = default;
+
+  constexpr explicit member_iterator(const member_type *member) noexcept : member_{ member } {}
+
+  constexpr reference operator*() const noexcept { return Projection{}(*member_); }
+
+  constexpr pointer operator->() const noexcept { return &(*(*this)); }
+
+  constexpr reference operator[](const std::ptrdiff_t offset) const noexcept { return Projection{}(member_[offset]); }
+
+  // the current member's key and value, whichever of them the iterator yields
+  constexpr std::basic_string_view<CharType> key() const noexcept { return member_->first; }
+
+  constexpr const basic_json<CharType> &value() const noexcept { return member_->second; }
+
+  constexpr member_iterator &operator++() noexcept
+  {
+    ++member_;
+    return *this;
+  }
+
+  [[nodiscard]] constexpr member_iterator operator++(int) noexcept
+  {
+    member_iterator result{ *this };
+    ++member_;
+    return result;
+  }
+
+  constexpr member_iterator &operator--() noexcept
+  {
+    --member_;
+    return *this;
+  }
+
+  [[nodiscard]] constexpr member_iterator operator--(int) noexcept
+  {
+    member_iterator result{ *this };
+    --member_;
+    return result;
+  }
+
+  constexpr member_iterator &operator+=(const std::ptrdiff_t offset) noexcept
+  {
+    member_ += offset;
+    return *this;
+  }
+
+  constexpr member_iterator &operator-=(const std::ptrdiff_t offset) noexcept
+  {
+    member_ -= offset;
+    return *this;
+  }
+
+  [[nodiscard]] friend constexpr member_iterator operator+(member_iterator itr, const std::ptrdiff_t offset) noexcept
+  {
+    return itr += offset;
+  }
+
+  [[nodiscard]] friend constexpr member_iterator operator+(const std::ptrdiff_t offset, member_iterator itr) noexcept
+  {
+    return itr += offset;
+  }
+
+  [[nodiscard]] friend constexpr member_iterator operator-(member_iterator itr, const std::ptrdiff_t offset) noexcept
+  {
+    return itr -= offset;
+  }
+
+  [[nodiscard]] friend constexpr std::ptrdiff_t operator-(const member_iterator &lhs,
+    const member_iterator &rhs) noexcept
+  {
+    return lhs.member_ - rhs.member_;
+  }
+
+  [[nodiscard]] constexpr bool operator==(const member_iterator &other) const noexcept
+  {
+    return member_ == other.member_;
+  }
+  [[nodiscard]] constexpr bool operator!=(const member_iterator &other) const noexcept { return !(*this == other); }
+  [[nodiscard]] constexpr bool operator<(const member_iterator &other) const noexcept
+  {
+    return member_ < other.member_;
+  }
+  [[nodiscard]] constexpr bool operator>(const member_iterator &other) const noexcept { return other < *this; }
+  [[nodiscard]] constexpr bool operator<=(const member_iterator &other) const noexcept { return !(other < *this); }
+  [[nodiscard]] constexpr bool operator>=(const member_iterator &other) const noexcept { return !(*this < other); }
+
+  const member_type *member_{ nullptr };
+};
+
+// The members of an object seen through `Iterator`, see basic_json::keys()
+template<typename Iterator> struct member_view
+{
+  [[nodiscard]] constexpr Iterator begin() const noexcept { return begin_; }
+
+  [[nodiscard]] constexpr Iterator end() const noexcept { return end_; }
+
+  [[nodiscard]] constexpr std::size_t size() const noexcept { return static_cast<std::size_t>(end_ - begin_); }
+
+  [[nodiscard]] constexpr bool empty() const noexcept { return begin_ == end_; }
+
+  [[nodiscard]] constexpr decltype(auto) operator[](const std::size_t idx) const noexcept
+  {
+    return begin_[static_cast<std::ptrdiff_t>(idx)];
+  }
+
+  Iterator begin_;
+  Iterator end_;
+};
+
 template<typename CharType> struct data_variant
 {
   struct monostate
@@ -227,27 +470,41 @@ template<typename CharType> struct basic_json
 {
   using data_t = data_variant<CharType>;
 
+  // Iterates the elements of an array, the values of an object's members, or a
+  // scalar once as itself. Which of them is fixed when the iterator is made, so
+  // dereferencing neither checks the type nor throws. Random access, as nlohmann's
+  // iterators are.
   struct iterator
   {
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = basic_json;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const basic_json *;
+    using reference = const basic_json &;
+
     constexpr iterator() noexcept = default;
 
     constexpr explicit iterator(const basic_json &value, std::size_t index = 0) noexcept
       : parent_value_(&value), index_{ index }
-    {}
-
-    constexpr const basic_json &operator*() const
     {
-      if (parent_value_->is_array()) {
-        return (*parent_value_)[index_];
-      } else if (parent_value_->is_object()) {
-        return std::next(parent_value_->object_data().begin(), static_cast<std::ptrdiff_t>(index_))->second;
+      if (value.is_object()) {
+        members_ = value.data.get_if_object()->begin();
+      } else if (value.is_array()) {
+        elements_ = value.data.get_if_array()->begin();
       } else {
-        return *parent_value_;
+        elements_ = &value;
       }
     }
 
+    constexpr const basic_json &operator*() const noexcept
+    {
+      return members_ != nullptr ? members_[index_].second : elements_[index_];
+    }
+
     constexpr const basic_json *operator->() const noexcept { return &(*(*this)); }
 
+    constexpr const basic_json &operator[](const std::ptrdiff_t offset) const noexcept { return *(*this + offset); }
+
     constexpr std::size_t index() const noexcept { return index_; }
 
     constexpr const basic_json &value() const noexcept { return *(*this); }
@@ -255,8 +512,8 @@ template<typename CharType> struct basic_json
 
     constexpr std::basic_string_view<CharType> key() const
     {
-      if (parent_value_->is_object()) {
-        return std::next(parent_value_->object_data().begin(), static_cast<std::ptrdiff_t>(index_))->first;
+      if (members_ != nullptr) {
+        return members_[index_].first;
       } else {
         throw std::runtime_error("json value is not an object, it has no key");
       }
@@ -273,6 +530,9 @@ template<typename CharType> struct basic_json
     {
       return other.parent_value_ == parent_value_ && index_ < other.index_;
     }
+    constexpr bool operator>(const iterator &other) const noexcept { return other < *this; }
+    constexpr bool operator<=(const iterator &other) const noexcept { return !(other < *this); }
+    constexpr bool operator>=(const iterator &other) const noexcept { return !(*this < other); }
 
     constexpr iterator &operator--() noexcept
     {
@@ -313,16 +573,67 @@ template<typename CharType> struct basic_json
       return *this;
     }
 
+    constexpr iterator &operator-=(const std::ptrdiff_t value) noexcept { return *this += -value; }
+
+    [[nodiscard]] friend constexpr iterator operator+(iterator itr, const std::ptrdiff_t value) noexcept
+    {
+      return itr += value;
+    }
+
+    [[nodiscard]] friend constexpr iterator operator+(const std::ptrdiff_t value, iterator itr) noexcept
+    {
+      return itr += value;
+    }
+
+    [[nodiscard]] friend constexpr iterator operator-(iterator itr, const std::ptrdiff_t value) noexcept
+    {
+      return itr -= value;
+    }
+
+    [[nodiscard]] friend constexpr std::ptrdiff_t operator-(const iterator &lhs, const iterator &rhs) noexcept
+    {
+      return static_cast<std::ptrdiff_t>(lhs.index_) - static_cast<std::ptrdiff_t>(rhs.index_);
+    }
+
     const basic_json *parent_value_{ nullptr };
     std::size_t index_{ 0 };
+    // one of them is set: the members of an object, or the elements of an array or
+    // the scalar itself
+    const basic_value_pair_t<CharType> *members_{ nullptr };
+    const basic_json *elements_{ nullptr };
   };
 
   using const_iterator = iterator;
 
-  [[nodiscard]] constexpr iterator begin() const noexcept { return iterator{ *this }; }
+  [[nodiscard]] constexpr iterator begin() const noexcept
+  {
+    profile_touch();
+    return iterator{ *this };
+  }
 
   [[nodiscard]] constexpr iterator end() const noexcept { return iterator{ *this, size() }; }
 
+  using key_iterator = member_iterator<CharType, member_key>;
+  using value_iterator = member_iterator<CharType, member_value>;
+  using item_iterator = member_iterator<CharType, whole_member>;
+
+  // The keys, values or whole members (`auto &[key, value]`) of an object, as
+  // ranges of random access iterators that are pointers to the members. They throw
+  // for anything but an object; the elements of an array are a range of pointers
+  // already, `array_data()`.
+  [[nodiscard]] constexpr member_view<key_iterator> keys() const { return members<key_iterator>(); }
+
+  [[nodiscard]] constexpr member_view<value_iterator> values() const { return members<value_iterator>(); }
+
+  [[nodiscard]] constexpr member_view<item_iterator> items() const { return members<item_iterator>(); }
+
+  template<typename Iterator> [[nodiscard]] constexpr member_view<Iterator> members() const
+  {
+    const auto &children = object_data();
+    profile_touch();
+    return member_view<Iterator>{ Iterator{ children.begin() }, Iterator{ children.end() } };
+  }
+
   [[nodiscard]] constexpr iterator cbegin() const noexcept { return begin(); }
 
   [[nodiscard]] constexpr iterator cend() const noexcept { return end(); }
@@ -343,6 +654,7 @@ template<typename CharType> struct basic_json
 
   [[nodiscard]] constexpr const basic_json &operator[](const std::size_t idx) const
   {
+    profile_touch();
     if (const auto &children = array_data(); idx < children.size()) {
       return *std::next(children.begin(), static_cast<std::ptrdiff_t>(idx));
     } else {
@@ -368,6 +680,8 @@ template<typename CharType> struct basic_json
     };
 
     const auto obj = finder();
+    profile_touch();
+    profile_lookup(key, obj == children.end() ? children.size() : static_cast<std::size_t>(obj - children.begin()) + 1);
 
     if (obj != children.end()) {
       return obj->second;
@@ -392,9 +706,13 @@ template<typename CharType> struct basic_json
   [[nodiscard]] constexpr iterator find(const std::basic_string_view<CharType> key) const
   {
     for (auto itr = begin(); itr != end(); ++itr) {
-      if (itr.key() == key) { return itr; }
+      if (itr.key() == key) {
+        profile_lookup(key, itr.index_ + 1);
+        return itr;
+      }
     }
 
+    profile_lookup(key, size());
     return end();
   }
 
@@ -493,11 +811,140 @@ template<typename CharType> struct basic_json
     return is_null() || is_string() || is_boolean() || is_number() || is_binary();
   }
 
+  // count an access of this array or object in a JSON2CPP_PROFILE build
+  constexpr void profile_touch() const
+  {
+#ifdef JSON2CPP_PROFILE
+    if (!profile_detail::constant_evaluated() && is_structured() && !empty()) {
+      profile_detail::touch(children_address());
+    }
+#endif
+  }
+
+  constexpr void profile_lookup([[maybe_unused]] const std::basic_string_view<CharType> key,
+    [[maybe_unused]] const std::size_t comparisons) const
+  {
+#ifdef JSON2CPP_PROFILE
+    if constexpr (std::is_same_v<CharType, char>) {
+      if (!profile_detail::constant_evaluated() && is_object() && !empty()) {
+        profile_detail::lookup(children_address(), key, comparisons);
+      }
+    }
+#endif
+  }
+
+  // the address that identifies a non-empty array or object in a profile
+  [[nodiscard]] constexpr const void *children_address() const
+  {
+    if (is_object()) { return object_data().begin(); }
+    return array_data().begin();
+  }
+
+  // Deep comparison of values, as nlohmann::json compares them: members of objects
+  // in any order, and numbers by value, so 1 == 1.0 (but never 2^53 + 1 == 2^53)
+  [[nodiscard]] friend constexpr bool operator==(const basic_json &lhs, const basic_json &rhs)
+  {
+    if (&lhs == &rhs) { return true; }
+    if (lhs.is_number() && rhs.is_number()) { return numbers_equal(lhs, rhs); }
+    if (lhs.data.selected != rhs.data.selected || lhs.size() != rhs.size()) { return false; }
+
+    if (lhs.is_object()) {
+      const auto *lhs_member = lhs.object_data().begin();
+      const auto *rhs_member = rhs.object_data().begin();
+      for (; lhs_member != lhs.object_data().end(); ++lhs_member, ++rhs_member) {
+        // equal objects generated alike list their members in the same order, so they
+        // usually line up without a search
+        if (rhs_member->first == lhs_member->first) {
+          if (!(rhs_member->second == lhs_member->second)) { return false; }
+        } else if (const auto found = rhs.find(lhs_member->first);
+                   found == rhs.end() || !(*found == lhs_member->second)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    if (lhs.is_array()) {
+      const auto *rhs_element = rhs.array_data().begin();
+      for (const auto &lhs_element : lhs.array_data()) {
+        if (!(lhs_element == *rhs_element++)) { return false; }
+      }
+      return true;
+    }
+    if (lhs.is_string()) { return lhs.data.value.string_view_ == rhs.data.value.string_view_; }
+    if (lhs.is_boolean()) { return lhs.data.value.bool_ == rhs.data.value.bool_; }
+    return true;
+  }
+
+  [[nodiscard]] friend constexpr bool operator!=(const basic_json &lhs, const basic_json &rhs) { return !(lhs == rhs); }
+
+  // a double equals an integer only if it holds exactly that integer
+  [[nodiscard]] static constexpr bool numbers_equal(const basic_json &lhs, const basic_json &rhs) noexcept
+  {
+    if (lhs.is_number_float() && rhs.is_number_float()) {
+      return lhs.data.value.double_ == rhs.data.value.double_;
+    }
+    if (lhs.is_number_float() || rhs.is_number_float()) {
+      const auto floating = (lhs.is_number_float() ? lhs : rhs).data.value.double_;
+      const auto &integer = lhs.is_number_float() ? rhs : lhs;
+      if (integer.is_number_unsigned()) {
+        const auto value = integer.data.value.uint64_t_;
+        return floating >= 0.0 && floating < 18446744073709551616.0 && static_cast<double>(value) == floating
+               && static_cast<std::uint64_t>(floating) == value;
+      }
+      const auto value = integer.data.value.int64_t_;
+      return floating >= -9223372036854775808.0 && floating < 9223372036854775808.0
+             && static_cast<double>(value) == floating && static_cast<std::int64_t>(floating) == value;
+    }
+    if (lhs.is_number_unsigned() && rhs.is_number_unsigned()) {
+      return lhs.data.value.uint64_t_ == rhs.data.value.uint64_t_;
+    }
+    if (lhs.is_number_signed() && rhs.is_number_signed()) {
+      return lhs.data.value.int64_t_ == rhs.data.value.int64_t_;
+    }
+    const auto signed_value = (lhs.is_number_signed() ? lhs : rhs).data.value.int64_t_;
+    const auto unsigned_value = (lhs.is_number_signed() ? rhs : lhs).data.value.uint64_t_;
+    return signed_value >= 0 && static_cast<std::uint64_t>(signed_value) == unsigned_value;
+  }
+
 
   data_t data;
   std::size_t size_{ basic_json::size(*this) };
 };
 
+// Calls `visitor` with the value `node` holds, switching on its type once: a bool,
+// std::int64_t, std::uint64_t, double, string_view, the array's elements
+// (basic_array_t), the object's members (basic_object_t), binary_t, or nullptr for
+// null. Every call must return the same type, which `visit` returns.
+template<typename Visitor, typename CharType>
+constexpr decltype(auto) visit(Visitor &&visitor, const basic_json<CharType> &node)
+{
+  using selected_type = typename basic_json<CharType>::data_t::selected_type;
+  const auto &value = node.data.value;
+
+  switch (node.data.selected) {
+  case selected_type::boolean:
+    return std::forward<Visitor>(visitor)(value.bool_);
+  case selected_type::integer:
+    return std::forward<Visitor>(visitor)(value.int64_t_);
+  case selected_type::uinteger:
+    return std::forward<Visitor>(visitor)(value.uint64_t_);
+  case selected_type::floating_point:
+    return std::forward<Visitor>(visitor)(value.double_);
+  case selected_type::string:
+    return std::forward<Visitor>(visitor)(value.string_view_);
+  case selected_type::array:
+    return std::forward<Visitor>(visitor)(value.array_);
+  case selected_type::object:
+    return std::forward<Visitor>(visitor)(value.object_);
+  case selected_type::binary:
+    return std::forward<Visitor>(visitor)(value.binary_);
+  case selected_type::nullish:
+  case selected_type::empty:
+  default:
+    return std::forward<Visitor>(visitor)(nullptr);
+  }
+}
+
 using json = basic_json<char>;
 using object_t = basic_object_t<char>;
 using value_pair_t = basic_value_pair_t<char>;
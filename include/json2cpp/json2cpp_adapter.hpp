@@ -50,7 +50,11 @@ SOFTWARE.
 #pragma once
 
 #include "json2cpp.hpp"
+#include <cstddef>
+#include <iterator>
+#include <new>
 #include <string>
+#include <string_view>
 
 #include <utility>
 #include <valijson/exceptions.hpp>
@@ -65,8 +69,80 @@ namespace adapters {
   class json2cppJsonArrayValueIterator;
   class json2cppJsonObjectMemberIterator;
 
+  /**
+   * valijson hands object member names around as `const std::string &` inside a
+   * copyable, assignable pair, so each dereferenced member carries its own copy
+   * of the key. Keys that fit the small string buffer (15 bytes with libstdc++
+   * and libc++) do not allocate; longer keys, which epJSON documents have many
+   * of, allocate on every dereference.
+   */
   typedef std::pair<std::string, json2cppJsonAdapter> json2cppJsonObjectMember;
 
+  namespace detail {
+    /**
+     * @brief   Free list recycling fixed size blocks on the current thread.
+     *
+     * valijson owns frozen values through raw pointers and releases them with
+     * `delete`, so the only way to avoid a heap allocation per freeze() or
+     * clone() is a class specific operator new/delete. Released blocks are kept
+     * on the releasing thread's list and handed out again by the next
+     * allocation on that thread.
+     */
+    template<std::size_t BlockSize> class block_pool
+    {
+    public:
+      block_pool(const block_pool &) = delete;
+      block_pool &operator=(const block_pool &) = delete;
+      block_pool(block_pool &&) = delete;
+      block_pool &operator=(block_pool &&) = delete;
+
+      ~block_pool()
+      {
+        while (m_free != nullptr) { ::operator delete(std::exchange(m_free, m_free->next)); }
+        s_destroyed = true;
+      }
+
+      static void *allocate()
+      {
+        auto *pool = local();
+        if (pool == nullptr || pool->m_free == nullptr) { return ::operator new(BlockSize); }
+        return std::exchange(pool->m_free, pool->m_free->next);
+      }
+
+      static void deallocate(void *block) noexcept
+      {
+        if (auto *pool = local(); pool != nullptr) {
+          pool->m_free = ::new (block) free_block{ pool->m_free };
+        } else {
+          ::operator delete(block);
+        }
+      }
+
+    private:
+      struct free_block
+      {
+        free_block *next;
+      };
+
+      static_assert(BlockSize >= sizeof(free_block));
+
+      block_pool() = default;
+
+      // nullptr once this thread's pool has been destroyed, which happens when
+      // a value is released during static destruction
+      static block_pool *local() noexcept
+      {
+        if (s_destroyed) { return nullptr; }
+        thread_local block_pool pool;
+        return &pool;
+      }
+
+      static inline thread_local bool s_destroyed = false;
+
+      free_block *m_free{ nullptr };
+    };
+  }// namespace detail
+
   /**
    * @brief  Light weight wrapper for a json2cppJson array value.
    *
@@ -223,7 +299,10 @@ namespace adapters {
    *
    * This class allows a json2cppJson value to be stored independent of its original
    * document. json2cppJson makes this easy to do, as it does not perform any
-   * custom memory management.
+   * custom memory management: the node is a small trivially copyable handle
+   * onto the document's static data, and instances are allocated from a
+   * per-thread pool, so freezing and cloning do not touch the heap once the
+   * pool has warmed up.
    *
    * @see FrozenValue
    */
@@ -235,12 +314,16 @@ namespace adapters {
      *
      * @param  source  the json2cppJson value to be copied
      */
-    explicit json2cppJsonFrozenValue(json2cpp::json source) : m_value(std::move(source)) {}
+    explicit json2cppJsonFrozenValue(const json2cpp::json &source) : m_value(source) {}
 
     FrozenValue *clone() const override { return new json2cppJsonFrozenValue(m_value); }
 
     bool equalTo(const Adapter &other, bool strict) const override;
 
+    static void *operator new(std::size_t size);
+
+    static void operator delete(void *block, std::size_t size) noexcept;
+
   private:
     /// Stored json2cppJson value
     json2cpp::json m_value;
@@ -386,7 +469,9 @@ namespace adapters {
     bool getString(std::string &result) const
     {
       if (m_value.is_string()) {
-        result = m_value.get<std::string_view>();
+        // assign() reuses the caller's buffer when it is already large enough
+        const auto value = m_value.get<std::string_view>();
+        result.assign(value.data(), value.size());
         return true;
       }
 
@@ -461,17 +546,17 @@ namespace adapters {
   public:
     using iterator_category = std::bidirectional_iterator_tag;
     using value_type = json2cppJsonAdapter;
-    using difference_type = json2cppJsonAdapter;
+    using difference_type = std::ptrdiff_t;
     using pointer = json2cppJsonAdapter *;
     using reference = json2cppJsonAdapter &;
 
     /**
-     * @brief   Construct a new json2cppJsonArrayValueIterator using an existing
-     *          json2cppJson iterator.
+     * @brief   Construct a new json2cppJsonArrayValueIterator pointing into the
+     *          contiguous storage of a json2cppJson array.
      *
-     * @param   itr  json2cppJson iterator to store
+     * @param   itr  pointer to the current element
      */
-    explicit json2cppJsonArrayValueIterator(const json2cpp::json::const_iterator &itr) : m_itr(itr) {}
+    explicit json2cppJsonArrayValueIterator(const json2cpp::json *itr) : m_itr(itr) {}
 
     /// Returns a json2cppJsonAdapter that contains the value of the current
     /// element.
@@ -522,7 +607,8 @@ namespace adapters {
     void advance(std::ptrdiff_t n) { m_itr += n; }
 
   private:
-    json2cpp::json::const_iterator m_itr;
+    /// Current element; arrays are stored contiguously, so a pointer is all we need
+    const json2cpp::json *m_itr;
   };
 
 
@@ -541,22 +627,27 @@ namespace adapters {
   public:
     using iterator_category = std::bidirectional_iterator_tag;
     using value_type = json2cppJsonObjectMember;
-    using difference_type = json2cppJsonObjectMember;
+    using difference_type = std::ptrdiff_t;
     using pointer = json2cppJsonObjectMember *;
     using reference = json2cppJsonObjectMember &;
 
     /**
-     * @brief   Construct an iterator from a json2cppJson iterator.
+     * @brief   Construct an iterator pointing into the contiguous member storage
+     *          of a json2cppJson object.
      *
-     * @param   itr  json2cppJson iterator to store
+     * @param   itr  pointer to the current member
      */
-    explicit json2cppJsonObjectMemberIterator(const json2cpp::json::const_iterator &itr) : m_itr(itr) {}
+    explicit json2cppJsonObjectMemberIterator(const json2cpp::value_pair_t *itr) : m_itr(itr) {}
 
     /**
      * @brief   Returns a json2cppJsonObjectMember that contains the key and value
      *          belonging to the object member identified by the iterator.
+     *
      */
-    json2cppJsonObjectMember operator*() const { return json2cppJsonObjectMember(m_itr.key(), m_itr.value()); }
+    json2cppJsonObjectMember operator*() const
+    {
+      return json2cppJsonObjectMember(std::string{ m_itr->first }, json2cppJsonAdapter(m_itr->second));
+    }
 
     DerefProxy<json2cppJsonObjectMember> operator->() const { return DerefProxy<json2cppJsonObjectMember>(**this); }
 
@@ -600,8 +691,8 @@ namespace adapters {
     }
 
   private:
-    /// Iternal copy of the original json2cppJson iterator
-    json2cpp::json::const_iterator m_itr;
+    /// Current member
+    const json2cpp::value_pair_t *m_itr;
   };
 
   /// Specialisation of the AdapterTraits template struct for json2cppJsonAdapter.
@@ -617,29 +708,49 @@ namespace adapters {
     return json2cppJsonAdapter(m_value).equalTo(other, strict);
   }
 
+  inline void *json2cppJsonFrozenValue::operator new(const std::size_t size)
+  {
+    if (size != sizeof(json2cppJsonFrozenValue)) { return ::operator new(size); }
+    return detail::block_pool<sizeof(json2cppJsonFrozenValue)>::allocate();
+  }
+
+  inline void json2cppJsonFrozenValue::operator delete(void *block, const std::size_t size) noexcept
+  {
+    if (block == nullptr) { return; }
+    if (size != sizeof(json2cppJsonFrozenValue)) {
+      ::operator delete(block);
+      return;
+    }
+    detail::block_pool<sizeof(json2cppJsonFrozenValue)>::deallocate(block);
+  }
+
   inline json2cppJsonArrayValueIterator json2cppJsonArray::begin() const
   {
-    return json2cppJsonArrayValueIterator{ m_value.begin() };
+    return json2cppJsonArrayValueIterator{ m_value.array_data().begin() };
   }
 
   inline json2cppJsonArrayValueIterator json2cppJsonArray::end() const
   {
-    return json2cppJsonArrayValueIterator{ m_value.end() };
+    return json2cppJsonArrayValueIterator{ m_value.array_data().end() };
   }
 
   inline json2cppJsonObjectMemberIterator json2cppJsonObject::begin() const
   {
-    return json2cppJsonObjectMemberIterator{ m_value.begin() };
+    return json2cppJsonObjectMemberIterator{ m_value.object_data().begin() };
   }
 
   inline json2cppJsonObjectMemberIterator json2cppJsonObject::end() const
   {
-    return json2cppJsonObjectMemberIterator{ m_value.end() };
+    return json2cppJsonObjectMemberIterator{ m_value.object_data().end() };
   }
 
   inline json2cppJsonObjectMemberIterator json2cppJsonObject::find(const std::string_view propertyName) const
   {
-    return json2cppJsonObjectMemberIterator{ m_value.find(propertyName) };
+    const auto &members = m_value.object_data();
+    for (const auto *member = members.begin(); member != members.end(); ++member) {
+      if (member->first == propertyName) { return json2cppJsonObjectMemberIterator{ member }; }
+    }
+    return json2cppJsonObjectMemberIterator{ members.end() };
   }
 
 }// namespace adapters
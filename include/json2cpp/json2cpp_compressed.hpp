@@ -0,0 +1,267 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Subtrees stored compressed and expanded on first use, for large documents that
+// are rarely read and where binary size matters more than the first access.
+//
+// `json2cpp --compress` stores each top-level member whose minified text reaches
+// `--compress-min-size` bytes as that text compressed with the LZ codec below,
+// and compiles the smaller members as usual. The first call of a compressed
+// member's accessor decompresses the text and parses it into an arena with
+// `json2cpp::parse`; later calls return the cached result. Concurrent first calls
+// are safe, one of them does the work and the others wait for it.
+//
+// The codec is LZ4's block format: each sequence is a token byte holding the
+// number of literals (high nibble) and the match length minus 4 (low nibble),
+// where 15 means more length bytes follow, each adding up to 255; then the
+// literals; then the match as a two byte little-endian offset back into the
+// output, and the extra length bytes. The last sequence has literals only.
+// Compression searches a chain of earlier positions with the same four bytes,
+// which is slow but happens once, in the generator.
+
+#ifndef JSON2CPP_COMPRESSED_HPP_INCLUDED
+#define JSON2CPP_COMPRESSED_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include "json2cpp_parser.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace json2cpp {
+
+namespace compression_detail {
+  constexpr std::size_t min_match = 4;
+  constexpr std::size_t max_offset = 65535;
+  constexpr std::size_t hash_bits = 16;
+  // positions with the same hash tried before settling for the longest match found
+  constexpr std::size_t max_chain = 64;
+
+  [[nodiscard]] inline std::uint32_t read32(const char *data) noexcept
+  {
+    std::uint32_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  [[nodiscard]] inline std::size_t hash(const char *data) noexcept
+  {
+    return static_cast<std::size_t>((read32(data) * 2654435761U) >> (32U - hash_bits));
+  }
+
+  inline void write_length(std::string &out, std::size_t length)
+  {
+    while (length >= 255) {
+      out += static_cast<char>(255);
+      length -= 255;
+    }
+    out += static_cast<char>(length);
+  }
+
+  inline void write_sequence(std::string &out,
+    const std::string_view literals,
+    const std::size_t offset,
+    const std::size_t match_length)
+  {
+    const auto literal_nibble = std::min<std::size_t>(literals.size(), 15);
+    const auto match_nibble = match_length == 0 ? 0 : std::min<std::size_t>(match_length - min_match, 15);
+    out += static_cast<char>((literal_nibble << 4U) | match_nibble);
+    if (literal_nibble == 15) { write_length(out, literals.size() - 15); }
+    out += literals;
+    if (match_length == 0) { return; }
+    out += static_cast<char>(offset & 0xffU);
+    out += static_cast<char>(offset >> 8U);
+    if (match_nibble == 15) { write_length(out, match_length - min_match - 15); }
+  }
+
+  [[noreturn]] inline void corrupt() { throw std::runtime_error("compressed subtree is corrupt"); }
+}// namespace compression_detail
+
+// `input` compressed
+[[nodiscard]] inline std::string compress(const std::string_view input)
+{
+  using namespace compression_detail;
+
+  std::string out;
+  std::vector<std::size_t> head(std::size_t{ 1 } << hash_bits, SIZE_MAX);
+  std::vector<std::size_t> previous(input.size(), SIZE_MAX);
+  const auto insert = [&](const std::size_t position) {
+    const auto bucket = hash(input.data() + position);
+    previous[position] = head[bucket];
+    head[bucket] = position;
+  };
+
+  std::size_t literal_start = 0;
+  std::size_t position = 0;
+  while (position + min_match <= input.size()) {
+    std::size_t best_length = 0;
+    std::size_t best_offset = 0;
+    auto candidate = head[hash(input.data() + position)];
+    for (std::size_t tries = 0; candidate != SIZE_MAX && position - candidate <= max_offset && tries < max_chain;
+         ++tries, candidate = previous[candidate]) {
+      std::size_t length = 0;
+      while (position + length < input.size() && input[candidate + length] == input[position + length]) { ++length; }
+      if (length > best_length) {
+        best_length = length;
+        best_offset = position - candidate;
+      }
+    }
+
+    if (best_length < min_match) {
+      insert(position++);
+      continue;
+    }
+
+    write_sequence(out, input.substr(literal_start, position - literal_start), best_offset, best_length);
+    for (const auto end = position + best_length; position < end; ++position) {
+      if (position + min_match <= input.size()) { insert(position); }
+    }
+    literal_start = position;
+  }
+  write_sequence(out, input.substr(literal_start), 0, 0);
+  return out;
+}
+
+// The `size` bytes compressed into `data`; throws std::runtime_error if `data` is
+// not the output of `compress`
+[[nodiscard]] inline std::string
+  decompress(const unsigned char *data, const std::size_t data_size, const std::size_t size)
+{
+  using compression_detail::corrupt;
+
+  std::string out(size, '\0');
+  std::size_t in = 0;
+  std::size_t written = 0;
+  const auto read_length = [&](std::size_t length) {
+    if (length != 15) { return length; }
+    for (;;) {
+      if (in == data_size) { corrupt(); }
+      const auto extra = data[in++];
+      length += extra;
+      if (extra != 255) { return length; }
+    }
+  };
+
+  while (in < data_size) {
+    const auto token = data[in++];
+    const auto literals = read_length(static_cast<std::size_t>(token >> 4U));
+    if (literals > data_size - in || literals > size - written) { corrupt(); }
+    std::memcpy(out.data() + written, data + in, literals);
+    in += literals;
+    written += literals;
+    if (in == data_size) { break; }
+
+    if (data_size - in < 2) { corrupt(); }
+    const auto offset = static_cast<std::size_t>(data[in]) | (static_cast<std::size_t>(data[in + 1]) << 8U);
+    in += 2;
+    const auto length = read_length(static_cast<std::size_t>(token & 0xfU)) + compression_detail::min_match;
+    if (offset == 0 || offset > written || length > size - written) { corrupt(); }
+    // byte by byte, since the match may overlap what it is copying
+    for (std::size_t idx = 0; idx < length; ++idx, ++written) { out[written] = out[written - offset]; }
+  }
+
+  if (written != size) { corrupt(); }
+  return out;
+}
+
+// One compressed subtree as the generator emits it, expanded on the first `get()`
+class compressed_subtree
+{
+public:
+  template<std::size_t Size>
+  compressed_subtree(const std::array<unsigned char, Size> &data, const std::size_t text_size) noexcept
+    : compressed_subtree(data.data(), Size, text_size)
+  {}
+
+  // `data` must outlive the subtree
+  compressed_subtree(const unsigned char *data, const std::size_t data_size, const std::size_t text_size) noexcept
+    : data_{ data }, data_size_{ data_size }, text_size_{ text_size }
+  {}
+
+  compressed_subtree(const compressed_subtree &) = delete;
+  compressed_subtree &operator=(const compressed_subtree &) = delete;
+  compressed_subtree(compressed_subtree &&) = delete;
+  compressed_subtree &operator=(compressed_subtree &&) = delete;
+  ~compressed_subtree() = default;
+
+  // the subtree, decompressed and parsed by whichever call comes first; throws
+  // std::runtime_error if the data is corrupt, and the next call tries again
+  [[nodiscard]] const json &get() const
+  {
+    std::call_once(once_, [this] {
+      // copying the strings into the arena lets the text go right away
+      document_ = parse(decompress(data_, data_size_, text_size_), parse_options{ true });
+      expanded_.store(true, std::memory_order_release);
+    });
+    return document_.root();
+  }
+
+  [[nodiscard]] bool expanded() const noexcept { return expanded_.load(std::memory_order_acquire); }
+
+  [[nodiscard]] std::size_t compressed_size() const noexcept { return data_size_; }
+  [[nodiscard]] std::size_t text_size() const noexcept { return text_size_; }
+
+private:
+  const unsigned char *data_;
+  std::size_t data_size_;
+  std::size_t text_size_;
+  mutable std::once_flag once_;
+  mutable std::atomic<bool> expanded_{ false };
+  mutable document document_;
+};
+
+// The root object of a document compiled with `--compress`, put together from the
+// accessors of its members on first use, which expands all compressed ones
+class assembled_object
+{
+public:
+  using accessor = const json &(*)();
+
+  assembled_object(const std::initializer_list<std::pair<std::string_view, accessor>> members)
+  {
+    members_.reserve(members.size());
+    for (const auto &[key, get] : members) { members_.push_back(value_pair_t{ key, get() }); }
+    root_ = json{ json::data_t{ object_t{ members_.data(), members_.data() + members_.size() } }, members_.size() };
+  }
+
+  [[nodiscard]] const json &root() const noexcept { return root_; }
+
+private:
+  std::vector<value_pair_t> members_;
+  json root_{ json::data_t{ nullptr }, 0 };
+};
+
+}// namespace json2cpp
+
+#endif
@@ -0,0 +1,700 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// A JSON Schema validator over two compiled documents that runs during constant
+// evaluation, so a resource can be checked against its schema when it is built:
+//
+//   static_assert(json2cpp::validate(compiled_json::schema::impl::document,
+//                                    compiled_json::resource::impl::document));
+//
+// It covers the common keywords: type, enum, const, the numeric, length, item
+// and property counts and bounds, multipleOf, required, properties,
+// patternProperties, additionalProperties, dependencies, propertyNames, items,
+// additionalItems, contains, uniqueItems, allOf, anyOf, oneOf, not,
+// if/then/else and local $refs. Keywords it does not know are annotations and
+// ignored. `pattern` and `patternProperties` support the regular expressions
+// that need no groups: literals, `.`, classes, the common escapes and
+// quantifiers. Anything it cannot decide (a group in a pattern, a remote $ref,
+// $dynamicRef, unevaluated*) throws, which fails the build rather than passing
+// a document that was not checked.
+//
+// Like the rest of json2cpp this only needs C++17. Large documents may need a
+// higher -fconstexpr-ops-limit (GCC) or -fconstexpr-steps (Clang).
+
+#ifndef JSON2CPP_CONSTEXPR_VALIDATION_HPP_INCLUDED
+#define JSON2CPP_CONSTEXPR_VALIDATION_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace json2cpp {
+
+namespace schema_detail {
+  using namespace std::string_view_literals;
+
+  [[nodiscard]] constexpr double absolute(const double value) noexcept { return value < 0 ? -value : value; }
+
+  // The member `key` of `object`, or nullptr
+  [[nodiscard]] constexpr const json *member(const json &object, const std::string_view key)
+  {
+    if (!object.is_object()) { return nullptr; }
+    for (const auto &pair : object.object_data()) {
+      if (pair.first == key) { return &pair.second; }
+    }
+    return nullptr;
+  }
+
+  [[nodiscard]] constexpr bool is_integral(const double value) noexcept
+  {
+    // every double beyond 2^52 is a whole number
+    if (absolute(value) >= 4503599627370496.0) { return true; }
+    return static_cast<double>(static_cast<std::int64_t>(value)) == value;
+  }
+
+  // Number of code points in a UTF-8 string, which is what minLength and maxLength count
+  [[nodiscard]] constexpr std::size_t utf8_length(const std::string_view string) noexcept
+  {
+    std::size_t length = 0;
+    for (const auto character : string) {
+      if ((static_cast<unsigned char>(character) & 0xC0U) != 0x80U) { ++length; }
+    }
+    return length;
+  }
+
+  // The code point at `position` and the number of bytes it takes
+  struct code_point
+  {
+    char32_t value;
+    std::size_t length;
+  };
+
+  [[nodiscard]] constexpr code_point decode(const std::string_view text, const std::size_t position) noexcept
+  {
+    const auto lead = static_cast<unsigned char>(text[position]);
+    std::size_t length = 1;
+    char32_t value = lead;
+    if (lead >= 0xF0U) {
+      length = 4;
+      value = lead & 0x07U;
+    } else if (lead >= 0xE0U) {
+      length = 3;
+      value = lead & 0x0FU;
+    } else if (lead >= 0xC0U) {
+      length = 2;
+      value = lead & 0x1FU;
+    }
+    if (position + length > text.size()) { return { lead, 1 }; }
+    for (std::size_t idx = 1; idx < length; ++idx) {
+      value = (value << 6U) | (static_cast<unsigned char>(text[position + idx]) & 0x3FU);
+    }
+    return { value, length };
+  }
+
+  // The start of the code point before `position`
+  [[nodiscard]] constexpr std::size_t previous(const std::string_view text, std::size_t position) noexcept
+  {
+    do { --position; } while (position > 0 && (static_cast<unsigned char>(text[position]) & 0xC0U) == 0x80U);
+    return position;
+  }
+
+  [[nodiscard]] constexpr bool is_space(const char32_t value) noexcept
+  {
+    return (value >= 0x09 && value <= 0x0D) || value == 0x20 || value == 0xA0 || value == 0x1680
+           || (value >= 0x2000 && value <= 0x200A) || value == 0x2028 || value == 0x2029 || value == 0x202F
+           || value == 0x205F || value == 0x3000 || value == 0xFEFF;
+  }
+
+  [[nodiscard]] constexpr bool is_digit(const char32_t value) noexcept { return value >= '0' && value <= '9'; }
+
+  [[nodiscard]] constexpr bool is_word(const char32_t value) noexcept
+  {
+    return is_digit(value) || (value >= 'a' && value <= 'z') || (value >= 'A' && value <= 'Z') || value == '_';
+  }
+
+  [[nodiscard]] constexpr std::uint32_t hex_value(const char character)
+  {
+    if (character >= '0' && character <= '9') { return static_cast<std::uint32_t>(character - '0'); }
+    if (character >= 'a' && character <= 'f') { return static_cast<std::uint32_t>(character - 'a' + 10); }
+    if (character >= 'A' && character <= 'F') { return static_cast<std::uint32_t>(character - 'A' + 10); }
+    throw std::runtime_error("invalid hexadecimal escape in pattern");
+  }
+
+  // One escape sequence of a pattern, starting after the backslash at `position`:
+  // either a class (\d \s \w and their negations) or a single code point
+  struct escape
+  {
+    char kind;// 'd', 's', 'w', 'D', 'S', 'W', or 0 for a code point
+    char32_t value;
+    std::size_t end;
+  };
+
+  [[nodiscard]] constexpr escape parse_escape(const std::string_view pattern, const std::size_t position)
+  {
+    if (position >= pattern.size()) { throw std::runtime_error("pattern ends with a backslash"); }
+    const auto character = pattern[position];
+    switch (character) {
+    case 'd':
+    case 's':
+    case 'w':
+    case 'D':
+    case 'S':
+    case 'W':
+      return { character, 0, position + 1 };
+    case 't':
+      return { 0, '\t', position + 1 };
+    case 'n':
+      return { 0, '\n', position + 1 };
+    case 'r':
+      return { 0, '\r', position + 1 };
+    case 'f':
+      return { 0, '\f', position + 1 };
+    case 'v':
+      return { 0, '\v', position + 1 };
+    case 'u':
+      if (position + 4 >= pattern.size()) { throw std::runtime_error("incomplete \\u escape in pattern"); }
+      return { 0,
+        static_cast<char32_t>((hex_value(pattern[position + 1]) << 12U) | (hex_value(pattern[position + 2]) << 8U)
+                              | (hex_value(pattern[position + 3]) << 4U) | hex_value(pattern[position + 4])),
+        position + 5 };
+    case 'x':
+      if (position + 2 >= pattern.size()) { throw std::runtime_error("incomplete \\x escape in pattern"); }
+      return { 0,
+        static_cast<char32_t>((hex_value(pattern[position + 1]) << 4U) | hex_value(pattern[position + 2])),
+        position + 3 };
+    default:
+      if (is_word(static_cast<unsigned char>(character))) {
+        // \b, \B, backreferences and the other letter escapes need more than this matcher offers
+        throw std::runtime_error("unsupported escape in pattern");
+      }
+      return { 0, decode(pattern, position).value, position + decode(pattern, position).length };
+    }
+  }
+
+  [[nodiscard]] constexpr bool escape_matches(const escape &esc, const char32_t value) noexcept
+  {
+    switch (esc.kind) {
+    case 'd':
+      return is_digit(value);
+    case 'D':
+      return !is_digit(value);
+    case 's':
+      return is_space(value);
+    case 'S':
+      return !is_space(value);
+    case 'w':
+      return is_word(value);
+    case 'W':
+      return !is_word(value);
+    default:
+      return esc.value == value;
+    }
+  }
+
+  // Where the atom (one code point, `.`, an escape or a class) starting at `position` ends
+  [[nodiscard]] constexpr std::size_t atom_end(const std::string_view pattern, const std::size_t position)
+  {
+    const auto character = pattern[position];
+    if (character == '(' || character == ')' || character == '|') {
+      throw std::runtime_error("groups and alternatives in patterns are not supported at compile time");
+    }
+    if (character == '\\') { return parse_escape(pattern, position + 1).end; }
+    if (character != '[') { return position + decode(pattern, position).length; }
+
+    auto idx = position + 1;
+    if (idx < pattern.size() && pattern[idx] == '^') { ++idx; }
+    // a ']' right after '[' or '[^' closes an empty class in ECMAScript
+    while (idx < pattern.size() && pattern[idx] != ']') {
+      idx = pattern[idx] == '\\' ? parse_escape(pattern, idx + 1).end : idx + decode(pattern, idx).length;
+    }
+    if (idx >= pattern.size()) { throw std::runtime_error("unterminated character class in pattern"); }
+    return idx + 1;
+  }
+
+  // Whether the atom pattern[first, last) matches the code point `value`
+  [[nodiscard]] constexpr bool atom_matches(const std::string_view pattern,
+    const std::size_t first,
+    const std::size_t last,
+    const char32_t value)
+  {
+    const auto character = pattern[first];
+    if (character == '.') { return value != '\n' && value != '\r' && value != 0x2028 && value != 0x2029; }
+    if (character == '\\') { return escape_matches(parse_escape(pattern, first + 1), value); }
+    if (character != '[') { return decode(pattern, first).value == value; }
+
+    auto idx = first + 1;
+    const bool negated = idx < last - 1 && pattern[idx] == '^';
+    if (negated) { ++idx; }
+    bool matched = false;
+    while (idx < last - 1) {
+      escape low{ 0, 0, 0 };
+      if (pattern[idx] == '\\') {
+        low = parse_escape(pattern, idx + 1);
+      } else {
+        const auto point = decode(pattern, idx);
+        low = escape{ 0, point.value, idx + point.length };
+      }
+      idx = low.end;
+
+      if (low.kind == 0 && idx + 1 < last - 1 && pattern[idx] == '-') {
+        // a range such as a-z
+        escape high{ 0, 0, 0 };
+        if (pattern[idx + 1] == '\\') {
+          high = parse_escape(pattern, idx + 2);
+        } else {
+          const auto point = decode(pattern, idx + 1);
+          high = escape{ 0, point.value, idx + 1 + point.length };
+        }
+        if (high.kind != 0) { throw std::runtime_error("invalid range in pattern character class"); }
+        idx = high.end;
+        matched = matched || (value >= low.value && value <= high.value);
+      } else {
+        matched = matched || escape_matches(low, value);
+      }
+    }
+    return matched != negated;
+  }
+
+  struct quantifier
+  {
+    std::size_t min;
+    std::size_t max;
+    std::size_t end;
+  };
+
+  inline constexpr std::size_t unbounded = static_cast<std::size_t>(-1);
+
+  // The quantifier following an atom, {1, 1} if there is none
+  [[nodiscard]] constexpr quantifier parse_quantifier(const std::string_view pattern, const std::size_t position)
+  {
+    quantifier result{ 1, 1, position };
+    if (position >= pattern.size()) { return result; }
+
+    const auto number = [&](std::size_t &idx) {
+      std::size_t value = 0;
+      const auto start = idx;
+      while (idx < pattern.size() && is_digit(static_cast<unsigned char>(pattern[idx]))) {
+        value = value * 10 + static_cast<std::size_t>(pattern[idx] - '0');
+        ++idx;
+      }
+      return idx == start ? unbounded : value;
+    };
+
+    switch (pattern[position]) {
+    case '*':
+      result = { 0, unbounded, position + 1 };
+      break;
+    case '+':
+      result = { 1, unbounded, position + 1 };
+      break;
+    case '?':
+      result = { 0, 1, position + 1 };
+      break;
+    case '{': {
+      auto idx = position + 1;
+      const auto min = number(idx);
+      if (min == unbounded) { return result; }// a literal '{' (Annex B)
+      auto max = min;
+      if (idx < pattern.size() && pattern[idx] == ',') {
+        ++idx;
+        max = number(idx);
+      }
+      if (idx >= pattern.size() || pattern[idx] != '}') { return result; }
+      result = { min, max, idx + 1 };
+      break;
+    }
+    default:
+      return result;
+    }
+
+    // lazy quantifiers find a match exactly when greedy ones do
+    if (result.end < pattern.size() && pattern[result.end] == '?') { ++result.end; }
+    return result;
+  }
+
+  // Whether pattern[position...] matches text[offset...], anchored at offset
+  [[nodiscard]] constexpr bool match_here(const std::string_view pattern,
+    const std::size_t position,
+    const std::string_view text,
+    const std::size_t offset)
+  {
+    if (position == pattern.size()) { return true; }
+    if (pattern[position] == '$') { return offset == text.size() && match_here(pattern, position + 1, text, offset); }
+    if (pattern[position] == '^') { return offset == 0 && match_here(pattern, position + 1, text, offset); }
+
+    const auto end = atom_end(pattern, position);
+    const auto repeat = parse_quantifier(pattern, end);
+
+    // take as many repetitions as possible, then give them back one at a time
+    std::size_t count = 0;
+    auto cursor = offset;
+    while (count < repeat.max && cursor < text.size()) {
+      const auto point = decode(text, cursor);
+      if (!atom_matches(pattern, position, end, point.value)) { break; }
+      cursor += point.length;
+      ++count;
+    }
+    if (count < repeat.min) { return false; }
+
+    while (true) {
+      if (match_here(pattern, repeat.end, text, cursor)) { return true; }
+      if (count == repeat.min) { return false; }
+      cursor = previous(text, cursor);
+      --count;
+    }
+  }
+
+  // ECMAScript search semantics: the pattern may match anywhere in `text`
+  [[nodiscard]] constexpr bool search(const std::string_view pattern, const std::string_view text)
+  {
+    for (std::size_t offset = 0;; offset += decode(text, offset).length) {
+      if (match_here(pattern, 0, text, offset)) { return true; }
+      if (offset == text.size()) { return false; }
+    }
+  }
+
+  // The value at a JSON Pointer fragment such as "#/definitions/name" within `root`
+  [[nodiscard]] constexpr const json &resolve(const json &root, const std::string_view ref)
+  {
+    if (ref.empty() || ref.front() != '#') {
+      throw std::runtime_error("only local $refs can be validated at compile time");
+    }
+
+    const json *node = &root;
+    std::size_t position = 1;
+    while (position < ref.size()) {
+      if (ref[position] != '/') { throw std::runtime_error("$ref is not a JSON Pointer"); }
+      ++position;
+      auto token_end = position;
+      while (token_end < ref.size() && ref[token_end] != '/') { ++token_end; }
+      const auto token = ref.substr(position, token_end - position);
+      position = token_end;
+
+      // compares the escaped token with a member name
+      const auto token_is = [&](const std::string_view name) {
+        std::size_t idx = 0;
+        std::size_t matched = 0;
+        while (idx < token.size()) {
+          char character = token[idx++];
+          if (character == '~' && idx < token.size()) {
+            character = token[idx++] == '0' ? '~' : '/';
+          } else if (character == '%' && idx + 1 < token.size()) {
+            character = static_cast<char>((hex_value(token[idx]) << 4U) | hex_value(token[idx + 1]));
+            idx += 2;
+          }
+          if (matched >= name.size() || name[matched] != character) { return false; }
+          ++matched;
+        }
+        return matched == name.size();
+      };
+
+      const json *next = nullptr;
+      if (node->is_object()) {
+        for (const auto &pair : node->object_data()) {
+          if (token_is(pair.first)) {
+            next = &pair.second;
+            break;
+          }
+        }
+      } else if (node->is_array()) {
+        std::size_t index = 0;
+        for (const auto character : token) {
+          if (!is_digit(static_cast<unsigned char>(character))) {
+            throw std::runtime_error("invalid array index in $ref");
+          }
+          index = index * 10 + static_cast<std::size_t>(character - '0');
+        }
+        if (index < node->size()) { next = &(*node)[index]; }
+      }
+      if (next == nullptr) { throw std::runtime_error("unable to resolve $ref"); }
+      node = next;
+    }
+    return *node;
+  }
+
+  [[nodiscard]] constexpr bool has_type(const json &value, const std::string_view type)
+  {
+    if (type == "null"sv) { return value.is_null(); }
+    if (type == "boolean"sv) { return value.is_boolean(); }
+    if (type == "object"sv) { return value.is_object(); }
+    if (type == "array"sv) { return value.is_array(); }
+    if (type == "number"sv) { return value.is_number(); }
+    if (type == "integer"sv) { return value.is_number_integer(); }
+    if (type == "string"sv) { return value.is_string(); }
+    throw std::runtime_error("unknown type in schema");
+  }
+
+  [[nodiscard]] constexpr bool flag(const json *keyword)
+  {
+    return keyword != nullptr && keyword->is_boolean() && keyword->get<bool>();
+  }
+
+  [[nodiscard]] constexpr bool is_multiple_of(const json &value, const json &divisor)
+  {
+    if (value.is_number_integer() && divisor.is_number_integer() && !value.is_number_unsigned()
+        && !divisor.is_number_unsigned() && divisor.get<std::int64_t>() != 0) {
+      return value.get<std::int64_t>() % divisor.get<std::int64_t>() == 0;
+    }
+    const auto quotient = value.get<double>() / divisor.get<double>();
+    if (quotient != quotient || absolute(quotient) > 1.7976931348623157e308) { return false; }
+    if (absolute(quotient) >= 4503599627370496.0) { return true; }
+    const auto whole = static_cast<double>(static_cast<std::int64_t>(quotient + (quotient < 0 ? -0.5 : 0.5)));
+    return absolute(quotient - whole) <= absolute(quotient) * 1e-12 + 1e-12;
+  }
+
+  constexpr bool valid(const json &root, const json &schema, const json &value);
+
+  [[nodiscard]] constexpr bool valid_number(const json &schema, const json &value)
+  {
+    if (!value.is_number()) { return true; }
+    const auto number = value.get<double>();
+
+    if (const auto *minimum = member(schema, "minimum"); minimum != nullptr && minimum->is_number()) {
+      const auto limit = minimum->get<double>();
+      if (flag(member(schema, "exclusiveMinimum")) ? !(number > limit) : !(number >= limit)) { return false; }
+    }
+    if (const auto *maximum = member(schema, "maximum"); maximum != nullptr && maximum->is_number()) {
+      const auto limit = maximum->get<double>();
+      if (flag(member(schema, "exclusiveMaximum")) ? !(number < limit) : !(number <= limit)) { return false; }
+    }
+    if (const auto *minimum = member(schema, "exclusiveMinimum"); minimum != nullptr && minimum->is_number()) {
+      if (!(number > minimum->get<double>())) { return false; }
+    }
+    if (const auto *maximum = member(schema, "exclusiveMaximum"); maximum != nullptr && maximum->is_number()) {
+      if (!(number < maximum->get<double>())) { return false; }
+    }
+    if (const auto *divisor = member(schema, "multipleOf"); divisor != nullptr && divisor->is_number()) {
+      if (!is_multiple_of(value, *divisor)) { return false; }
+    }
+    return true;
+  }
+
+  [[nodiscard]] constexpr bool valid_string(const json &schema, const json &value)
+  {
+    if (!value.is_string()) { return true; }
+    const auto text = value.get<std::string_view>();
+
+    if (const auto *length = member(schema, "minLength"); length != nullptr) {
+      if (utf8_length(text) < length->get<std::uint64_t>()) { return false; }
+    }
+    if (const auto *length = member(schema, "maxLength"); length != nullptr) {
+      if (utf8_length(text) > length->get<std::uint64_t>()) { return false; }
+    }
+    if (const auto *pattern = member(schema, "pattern"); pattern != nullptr) {
+      if (!search(pattern->get<std::string_view>(), text)) { return false; }
+    }
+    return true;
+  }
+
+  [[nodiscard]] constexpr bool valid_array(const json &root, const json &schema, const json &value)
+  {
+    if (!value.is_array()) { return true; }
+
+    if (const auto *count = member(schema, "minItems");
+        count != nullptr && value.size() < count->get<std::uint64_t>()) {
+      return false;
+    }
+    if (const auto *count = member(schema, "maxItems");
+        count != nullptr && value.size() > count->get<std::uint64_t>()) {
+      return false;
+    }
+    if (flag(member(schema, "uniqueItems"))) {
+      for (std::size_t outer = 0; outer < value.size(); ++outer) {
+        for (auto inner = outer + 1; inner < value.size(); ++inner) {
+          if (value[outer] == value[inner]) { return false; }
+        }
+      }
+    }
+    if (const auto *contained = member(schema, "contains"); contained != nullptr) {
+      bool found = false;
+      for (std::size_t idx = 0; !found && idx < value.size(); ++idx) { found = valid(root, *contained, value[idx]); }
+      if (!found) { return false; }
+    }
+
+    const auto *items = member(schema, "items");
+    if (items == nullptr) { return true; }
+    if (!items->is_array()) {
+      for (const auto &element : value.array_data()) {
+        if (!valid(root, *items, element)) { return false; }
+      }
+      return true;
+    }
+
+    const auto *additional = member(schema, "additionalItems");
+    for (std::size_t idx = 0; idx < value.size(); ++idx) {
+      if (idx < items->size()) {
+        if (!valid(root, (*items)[idx], value[idx])) { return false; }
+      } else if (additional != nullptr && !valid(root, *additional, value[idx])) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  [[nodiscard]] constexpr bool valid_object(const json &root, const json &schema, const json &value)
+  {
+    if (!value.is_object()) { return true; }
+
+    if (const auto *count = member(schema, "minProperties");
+        count != nullptr && value.size() < count->get<std::uint64_t>()) {
+      return false;
+    }
+    if (const auto *count = member(schema, "maxProperties");
+        count != nullptr && value.size() > count->get<std::uint64_t>()) {
+      return false;
+    }
+    if (const auto *required = member(schema, "required"); required != nullptr && required->is_array()) {
+      for (const auto &name : required->array_data()) {
+        if (member(value, name.get<std::string_view>()) == nullptr) { return false; }
+      }
+    }
+
+    const auto *properties = member(schema, "properties");
+    const auto *patterns = member(schema, "patternProperties");
+    const auto *additional = member(schema, "additionalProperties");
+    const auto *names = member(schema, "propertyNames");
+    for (const auto &pair : value.object_data()) {
+      if (names != nullptr && !valid(root, *names, json{ pair.first })) { return false; }
+
+      bool matched = false;
+      if (const auto *property = properties == nullptr ? nullptr : member(*properties, pair.first);
+          property != nullptr) {
+        matched = true;
+        if (!valid(root, *property, pair.second)) { return false; }
+      }
+      if (patterns != nullptr && patterns->is_object()) {
+        for (const auto &pattern : patterns->object_data()) {
+          if (!search(pattern.first, pair.first)) { continue; }
+          matched = true;
+          if (!valid(root, pattern.second, pair.second)) { return false; }
+        }
+      }
+      if (!matched && additional != nullptr && !valid(root, *additional, pair.second)) { return false; }
+    }
+
+    const auto dependencies = [&](const json *keyword) {
+      if (keyword == nullptr || !keyword->is_object()) { return true; }
+      for (const auto &dependency : keyword->object_data()) {
+        if (member(value, dependency.first) == nullptr) { continue; }
+        if (dependency.second.is_array()) {
+          for (const auto &name : dependency.second.array_data()) {
+            if (member(value, name.get<std::string_view>()) == nullptr) { return false; }
+          }
+        } else if (!valid(root, dependency.second, value)) {
+          return false;
+        }
+      }
+      return true;
+    };
+    return dependencies(member(schema, "dependencies")) && dependencies(member(schema, "dependentRequired"))
+           && dependencies(member(schema, "dependentSchemas"));
+  }
+
+  constexpr bool valid(const json &root, const json &schema, const json &value)
+  {
+    if (schema.is_boolean()) { return schema.get<bool>(); }
+    if (!schema.is_object()) { throw std::runtime_error("schema is not an object or a boolean"); }
+
+    for (const auto keyword : { "$dynamicRef"sv, "$recursiveRef"sv, "unevaluatedProperties"sv, "unevaluatedItems"sv }) {
+      if (member(schema, keyword) != nullptr) {
+        throw std::runtime_error("schema keyword is not supported at compile time");
+      }
+    }
+
+    if (const auto *ref = member(schema, "$ref"); ref != nullptr) {
+      // in the drafts this targets, $ref replaces its siblings
+      return valid(root, resolve(root, ref->get<std::string_view>()), value);
+    }
+
+    if (const auto *type = member(schema, "type"); type != nullptr) {
+      bool matched = false;
+      if (type->is_array()) {
+        for (const auto &name : type->array_data()) {
+          matched = matched || has_type(value, name.get<std::string_view>());
+        }
+      } else {
+        matched = has_type(value, type->get<std::string_view>());
+      }
+      if (!matched) { return false; }
+    }
+
+    if (const auto *constant = member(schema, "const"); constant != nullptr && *constant != value) {
+      return false;
+    }
+    if (const auto *values = member(schema, "enum"); values != nullptr) {
+      bool found = false;
+      for (const auto &candidate : values->array_data()) { found = found || candidate == value; }
+      if (!found) { return false; }
+    }
+
+    if (!valid_number(schema, value) || !valid_string(schema, value) || !valid_array(root, schema, value)
+        || !valid_object(root, schema, value)) {
+      return false;
+    }
+
+    if (const auto *all = member(schema, "allOf"); all != nullptr) {
+      for (const auto &subschema : all->array_data()) {
+        if (!valid(root, subschema, value)) { return false; }
+      }
+    }
+    if (const auto *any = member(schema, "anyOf"); any != nullptr) {
+      bool found = false;
+      for (const auto &subschema : any->array_data()) { found = found || valid(root, subschema, value); }
+      if (!found) { return false; }
+    }
+    if (const auto *one = member(schema, "oneOf"); one != nullptr) {
+      std::size_t matches = 0;
+      for (const auto &subschema : one->array_data()) {
+        if (matches < 2 && valid(root, subschema, value)) { ++matches; }
+      }
+      if (matches != 1) { return false; }
+    }
+    if (const auto *negated = member(schema, "not"); negated != nullptr && valid(root, *negated, value)) {
+      return false;
+    }
+    if (const auto *condition = member(schema, "if"); condition != nullptr) {
+      const auto *branch = valid(root, *condition, value) ? member(schema, "then") : member(schema, "else");
+      if (branch != nullptr && !valid(root, *branch, value)) { return false; }
+    }
+    return true;
+  }
+}// namespace schema_detail
+
+// true if `document` is valid against the JSON Schema `schema`; usable in a
+// constant expression such as static_assert
+[[nodiscard]] constexpr bool validate(const json &schema, const json &document)
+{
+  return schema_detail::valid(schema, schema, document);
+}
+
+// Validates against `schema`, a subschema of `root` against which its $refs are resolved
+[[nodiscard]] constexpr bool validate(const json &schema, const json &document, const json &root)
+{
+  return schema_detail::valid(root, schema, document);
+}
+
+}// namespace json2cpp
+
+#endif
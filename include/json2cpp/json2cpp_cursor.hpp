@@ -0,0 +1,389 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Non-recursive traversals of a json2cpp::json that hand out one node at a time,
+// so a consumer can pull nodes lazily and deep documents cost no call stack.
+//
+//   for (const auto &entry : json2cpp::depth_first_cursor<16>{ document }) {
+//     // entry.depth, entry.key or entry.index, *entry.node
+//   }
+//
+// The cursors keep their path in a std::array of `MaxDepth` frames, so they never
+// allocate and work in constant expressions; `max_depth(document)` gives the depth
+// a document needs, at compile time for a compiled one. With `unbounded_depth`
+// the path lives in a std::vector instead. Going deeper than `MaxDepth` throws.
+//
+// Where C++20 coroutines are available, `depth_first(document)` and
+// `breadth_first(document)` wrap the cursors in a `json2cpp::generator`.
+
+#ifndef JSON2CPP_CURSOR_HPP_INCLUDED
+#define JSON2CPP_CURSOR_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+#define JSON2CPP_HAS_COROUTINES
+#endif
+#endif
+
+namespace json2cpp {
+
+inline constexpr std::size_t unbounded_depth = std::numeric_limits<std::size_t>::max();
+
+// the greatest depth of a node below `node`, which is at depth 0
+template<typename CharType> [[nodiscard]] constexpr std::size_t max_depth(const basic_json<CharType> &node)
+{
+  std::size_t deepest = 0;
+  if (node.is_array()) {
+    for (const auto &element : node.array_data()) { deepest = std::max(deepest, max_depth(element) + 1); }
+  } else if (node.is_object()) {
+    for (const auto &member : node.object_data()) { deepest = std::max(deepest, max_depth(member.second) + 1); }
+  }
+  return deepest;
+}
+
+template<typename CharType> struct basic_cursor_entry
+{
+  // 0 for the node the traversal started from
+  std::size_t depth{};
+  // position among the children of the parent
+  std::size_t index{};
+  // the member name, if the parent is an object
+  std::basic_string_view<CharType> key{};
+  bool is_member{};
+  const basic_json<CharType> *node{};
+};
+
+namespace cursor_detail {
+  template<typename CharType> struct frame
+  {
+    const basic_json<CharType> *container{};
+    std::size_t next{};
+  };
+
+  template<typename Frame, std::size_t Capacity> class frame_stack
+  {
+  public:
+    constexpr void push(const Frame &frame)
+    {
+      if (size_ == Capacity) { throw std::runtime_error("document is deeper than the cursor's maximum depth"); }
+      frames_[size_++] = frame;
+    }
+    constexpr void pop() noexcept { --size_; }
+    constexpr void clear() noexcept { size_ = 0; }
+    [[nodiscard]] constexpr Frame &top() noexcept { return frames_[size_ - 1]; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return size_; }
+
+  private:
+    std::array<Frame, Capacity> frames_{};
+    std::size_t size_{};
+  };
+
+  template<typename Frame> class frame_stack<Frame, unbounded_depth>
+  {
+  public:
+    void push(const Frame &frame) { frames_.push_back(frame); }
+    void pop() noexcept { frames_.pop_back(); }
+    void clear() noexcept { frames_.clear(); }
+    [[nodiscard]] Frame &top() noexcept { return frames_.back(); }
+    [[nodiscard]] bool empty() const noexcept { return frames_.empty(); }
+    [[nodiscard]] std::size_t size() const noexcept { return frames_.size(); }
+
+  private:
+    std::vector<Frame> frames_;
+  };
+
+  template<typename CharType> [[nodiscard]] constexpr bool has_children(const basic_json<CharType> &node) noexcept
+  {
+    return node.is_structured() && !node.empty();
+  }
+
+  // moves `frame` to the next child of its container and describes it
+  template<typename CharType>
+  [[nodiscard]] constexpr basic_cursor_entry<CharType> next_child(frame<CharType> &frame, const std::size_t depth)
+  {
+    basic_cursor_entry<CharType> entry;
+    entry.depth = depth;
+    entry.index = frame.next++;
+    if (frame.container->is_array()) {
+      entry.node = &frame.container->array_data()[entry.index];
+    } else {
+      const auto &member = frame.container->object_data()[entry.index];
+      entry.key = member.first;
+      entry.is_member = true;
+      entry.node = &member.second;
+    }
+    return entry;
+  }
+}// namespace cursor_detail
+
+struct cursor_sentinel
+{
+};
+
+// Lets a cursor be used in a range-for; the cursor itself holds the position.
+template<typename Cursor> class cursor_iterator
+{
+public:
+  using value_type = typename Cursor::entry_type;
+
+  constexpr explicit cursor_iterator(Cursor &cursor) noexcept : cursor_{ &cursor } {}
+
+  [[nodiscard]] constexpr const value_type &operator*() const noexcept { return cursor_->current(); }
+  [[nodiscard]] constexpr const value_type *operator->() const noexcept { return &cursor_->current(); }
+
+  constexpr cursor_iterator &operator++()
+  {
+    cursor_->next();
+    return *this;
+  }
+
+  [[nodiscard]] constexpr bool operator==(cursor_sentinel) const noexcept { return cursor_->done(); }
+  [[nodiscard]] constexpr bool operator!=(cursor_sentinel) const noexcept { return !cursor_->done(); }
+
+private:
+  Cursor *cursor_;
+};
+
+// Parents before their children, members and elements in document order.
+template<typename CharType, std::size_t MaxDepth = unbounded_depth> class basic_depth_first_cursor
+{
+public:
+  using entry_type = basic_cursor_entry<CharType>;
+
+  constexpr explicit basic_depth_first_cursor(const basic_json<CharType> &root) { current_.node = &root; }
+
+  [[nodiscard]] constexpr bool done() const noexcept { return current_.node == nullptr; }
+  [[nodiscard]] constexpr const entry_type &current() const noexcept { return current_; }
+
+  // Moves to the next node. Does not descend into the current node's children
+  // if skip_children() was called since the last move.
+  constexpr void next()
+  {
+    if (!skip_ && cursor_detail::has_children(*current_.node)) {
+      path_.push(cursor_detail::frame<CharType>{ current_.node, 0 });
+    }
+    skip_ = false;
+
+    while (!path_.empty()) {
+      auto &top = path_.top();
+      if (top.next != top.container->size()) {
+        current_ = cursor_detail::next_child(top, path_.size());
+        return;
+      }
+      path_.pop();
+    }
+    current_ = entry_type{};
+  }
+
+  constexpr void skip_children() noexcept { skip_ = true; }
+
+  [[nodiscard]] constexpr cursor_iterator<basic_depth_first_cursor> begin() noexcept
+  {
+    return cursor_iterator<basic_depth_first_cursor>{ *this };
+  }
+  [[nodiscard]] constexpr cursor_sentinel end() const noexcept { return {}; }
+
+private:
+  entry_type current_{};
+  cursor_detail::frame_stack<cursor_detail::frame<CharType>, MaxDepth> path_{};
+  bool skip_{ false };
+};
+
+// One depth after the other, each in document order. It keeps only the path to
+// the current node, not a queue of the nodes still to visit, so each level walks
+// again through the containers above it: a document of depth d costs up to d
+// passes over its containers, and nothing over its other nodes.
+template<typename CharType, std::size_t MaxDepth = unbounded_depth> class basic_breadth_first_cursor
+{
+public:
+  using entry_type = basic_cursor_entry<CharType>;
+
+  constexpr explicit basic_breadth_first_cursor(const basic_json<CharType> &root) : root_{ &root }
+  {
+    current_.node = root_;
+    deeper_ = cursor_detail::has_children(root);
+  }
+
+  [[nodiscard]] constexpr bool done() const noexcept { return current_.node == nullptr; }
+  [[nodiscard]] constexpr const entry_type &current() const noexcept { return current_; }
+
+  constexpr void next()
+  {
+    while (true) {
+      if (path_.empty()) {
+        // this level is done, start the next one from the root
+        if (!deeper_) {
+          current_ = entry_type{};
+          return;
+        }
+        ++level_;
+        deeper_ = false;
+        path_.push(cursor_detail::frame<CharType>{ root_, 0 });
+      }
+
+      auto &top = path_.top();
+      if (top.next == top.container->size()) {
+        path_.pop();
+        continue;
+      }
+
+      const auto entry = cursor_detail::next_child(top, path_.size());
+      if (entry.depth == level_) {
+        current_ = entry;
+        deeper_ = deeper_ || cursor_detail::has_children(*entry.node);
+        return;
+      }
+      if (cursor_detail::has_children(*entry.node)) {
+        path_.push(cursor_detail::frame<CharType>{ entry.node, 0 });
+      }
+    }
+  }
+
+  [[nodiscard]] constexpr cursor_iterator<basic_breadth_first_cursor> begin() noexcept
+  {
+    return cursor_iterator<basic_breadth_first_cursor>{ *this };
+  }
+  [[nodiscard]] constexpr cursor_sentinel end() const noexcept { return {}; }
+
+private:
+  const basic_json<CharType> *root_;
+  entry_type current_{};
+  cursor_detail::frame_stack<cursor_detail::frame<CharType>, MaxDepth> path_{};
+  std::size_t level_{};
+  bool deeper_{};
+};
+
+using cursor_entry = basic_cursor_entry<char>;
+template<std::size_t MaxDepth = unbounded_depth>
+using depth_first_cursor = basic_depth_first_cursor<char, MaxDepth>;
+template<std::size_t MaxDepth = unbounded_depth>
+using breadth_first_cursor = basic_breadth_first_cursor<char, MaxDepth>;
+
+#if defined(JSON2CPP_HAS_COROUTINES)
+// A minimal lazy sequence for the coroutines below, until std::generator is
+// available everywhere. The coroutine frame is allocated when it starts unless
+// the compiler elides it; use the cursors directly to never allocate.
+template<typename Type> class generator
+{
+public:
+  struct promise_type
+  {
+    const Type *value{};
+    std::exception_ptr exception;
+
+    generator get_return_object() { return generator{ handle::from_promise(*this) }; }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    std::suspend_always yield_value(const Type &yielded) noexcept
+    {
+      value = &yielded;
+      return {};
+    }
+    void return_void() noexcept {}
+    void unhandled_exception() { exception = std::current_exception(); }
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  class iterator
+  {
+  public:
+    explicit iterator(handle coroutine) : coroutine_{ coroutine } { advance(); }
+
+    [[nodiscard]] const Type &operator*() const noexcept { return *coroutine_.promise().value; }
+    [[nodiscard]] const Type *operator->() const noexcept { return coroutine_.promise().value; }
+
+    iterator &operator++()
+    {
+      advance();
+      return *this;
+    }
+
+    [[nodiscard]] bool operator==(std::default_sentinel_t) const noexcept { return coroutine_.done(); }
+
+  private:
+    void advance()
+    {
+      coroutine_.resume();
+      if (coroutine_.done() && coroutine_.promise().exception) {
+        std::rethrow_exception(coroutine_.promise().exception);
+      }
+    }
+
+    handle coroutine_;
+  };
+
+  generator(const generator &) = delete;
+  generator &operator=(const generator &) = delete;
+  generator(generator &&other) noexcept : coroutine_{ std::exchange(other.coroutine_, nullptr) } {}
+  generator &operator=(generator &&other) noexcept
+  {
+    std::swap(coroutine_, other.coroutine_);
+    return *this;
+  }
+  ~generator()
+  {
+    if (coroutine_) { coroutine_.destroy(); }
+  }
+
+  // a generator can be iterated once
+  [[nodiscard]] iterator begin() { return iterator{ coroutine_ }; }
+  [[nodiscard]] std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+  explicit generator(handle coroutine) noexcept : coroutine_{ coroutine } {}
+
+  handle coroutine_;
+};
+
+template<std::size_t MaxDepth = unbounded_depth, typename CharType>
+[[nodiscard]] generator<basic_cursor_entry<CharType>> depth_first(const basic_json<CharType> &root)
+{
+  for (const auto &entry : basic_depth_first_cursor<CharType, MaxDepth>{ root }) { co_yield entry; }
+}
+
+template<std::size_t MaxDepth = unbounded_depth, typename CharType>
+[[nodiscard]] generator<basic_cursor_entry<CharType>> breadth_first(const basic_json<CharType> &root)
+{
+  for (const auto &entry : basic_breadth_first_cursor<CharType, MaxDepth>{ root }) { co_yield entry; }
+}
+#endif
+
+}// namespace json2cpp
+
+#endif
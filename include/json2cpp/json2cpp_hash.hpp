@@ -0,0 +1,304 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Structural hashes of JSON values, and the comparisons and diffs they speed up.
+//
+// `structural_hash` gives equal values the same 64-bit hash in any document and on
+// any platform: object members are combined without regard to their order, and
+// numbers by value, as `operator==` compares them. `json2cpp --emit-hashes` runs it
+// over the document at generation time and stores the hash of every non-empty array
+// and object, keyed by the address of its children as `text_range` is; a
+// `hash_index` finds them by binary search, so nothing is hashed at runtime.
+//
+// `equal` and `diff` take an index for each side and treat arrays and objects whose
+// hashes match as equal without looking inside them. Different values passing for
+// equal would take a 64-bit hash collision. `operator==` never relies on hashes.
+
+#ifndef JSON2CPP_HASH_HPP_INCLUDED
+#define JSON2CPP_HASH_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include "json2cpp_hash_detail.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace json2cpp {
+
+// The structural hash of `value`, a `json2cpp::json` or a `nlohmann::json`. Hashing
+// an array or object hashes everything in it once and passes each array and object
+// met on the way, with its hash, to `on_subtree`.
+template<typename JSON, typename Callback = hash_detail::ignore_subtrees>
+[[nodiscard]] std::uint64_t structural_hash(const JSON &value, Callback &&on_subtree = {})
+{
+  return hash_detail::hash_tree<hash_detail::doubles::by_value>(value, on_subtree);
+}
+
+// The hash of one array or object, keyed by the address of its first child and its
+// number of children, so a node viewing only some of a compiled container's
+// children does not match it
+struct subtree_hash
+{
+  const void *children;
+  std::size_t size;
+  std::uint64_t hash;
+};
+
+// The structural hashes of the arrays and objects of one document
+class hash_index
+{
+public:
+  hash_index() = default;
+
+  // the hashes `json2cpp --emit-hashes` generates
+  template<std::size_t Size> explicit hash_index(const std::array<subtree_hash, Size> &hashes)
+    : entries_(hashes.begin(), hashes.end())
+  {
+    sort();
+  }
+
+  // hashes `document` now, for documents parsed or built at runtime
+  explicit hash_index(const json &document)
+  {
+    static_cast<void>(structural_hash(document, [this](const json &subtree, const std::uint64_t hash) {
+      if (!subtree.empty()) { entries_.push_back(subtree_hash{ children_of(subtree), subtree.size(), hash }); }
+    }));
+    sort();
+  }
+
+  // the structural hash of `value`: looked up for the arrays and objects of this
+  // document, otherwise computed
+  [[nodiscard]] std::uint64_t hash(const json &value) const
+  {
+    if (value.is_structured() && !value.empty()) {
+      const auto *children = children_of(value);
+      const auto before = [](const subtree_hash &entry, const void *key) {
+        return std::less<const void *>{}(entry.children, key);
+      };
+      const auto found = std::lower_bound(entries_.begin(), entries_.end(), children, before);
+      if (found != entries_.end() && found->children == children && found->size == value.size()) {
+        return found->hash;
+      }
+    }
+    return structural_hash(value);
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+private:
+  [[nodiscard]] static const void *children_of(const json &value)
+  {
+    if (value.is_object()) { return value.object_data().begin(); }
+    return value.array_data().begin();
+  }
+
+  void sort()
+  {
+    std::sort(entries_.begin(), entries_.end(), [](const subtree_hash &lhs, const subtree_hash &rhs) {
+      return std::less<const void *>{}(lhs.children, rhs.children);
+    });
+  }
+
+  std::vector<subtree_hash> entries_;
+};
+
+// `lhs == rhs`, deciding arrays and objects by their hashes alone
+[[nodiscard]] inline bool
+  equal(const json &lhs, const hash_index &lhs_hashes, const json &rhs, const hash_index &rhs_hashes)
+{
+  if (lhs.is_structured() && rhs.is_structured()) { return lhs_hashes.hash(lhs) == rhs_hashes.hash(rhs); }
+  return lhs == rhs;
+}
+
+// One difference between two documents
+struct difference
+{
+  enum class kind { added, removed, replaced };
+
+  // a JSON pointer (RFC 6901) to the value
+  std::string pointer;
+  kind change;
+  // the value in the first document, nullptr if it was added
+  const json *before;
+  // the value in the second document, nullptr if it was removed
+  const json *after;
+};
+
+namespace hash_detail {
+  inline void append_pointer_token(std::string &pointer, const std::string_view token)
+  {
+    pointer += '/';
+    for (const auto character : token) {
+      if (character == '~') {
+        pointer += "~0";
+      } else if (character == '/') {
+        pointer += "~1";
+      } else {
+        pointer += character;
+      }
+    }
+  }
+
+  class differ
+  {
+  public:
+    differ(const hash_index &before_hashes, const hash_index &after_hashes, std::vector<difference> &differences)
+      : before_hashes_{ before_hashes }, after_hashes_{ after_hashes }, differences_{ differences }
+    {}
+
+    void compare(const json &before, const json &after)
+    {
+      const bool same_kind = before.is_object() == after.is_object() && before.is_array() == after.is_array();
+      if (!same_kind || !before.is_structured()) {
+        if (!(before == after)) { add(difference::kind::replaced, &before, &after); }
+      } else if (before_hashes_.hash(before) == after_hashes_.hash(after)) {
+        return;
+      } else if (before.is_array()) {
+        compare_arrays(before, after);
+      } else {
+        compare_objects(before, after);
+      }
+    }
+
+  private:
+    void compare_arrays(const json &before, const json &after)
+    {
+      const auto common = std::min(before.size(), after.size());
+      for (std::size_t idx = 0; idx < std::max(before.size(), after.size()); ++idx) {
+        const auto length = pointer_.size();
+        append_pointer_token(pointer_, std::to_string(idx));
+        if (idx < common) {
+          compare(before[idx], after[idx]);
+        } else if (idx < before.size()) {
+          add(difference::kind::removed, &before[idx], nullptr);
+        } else {
+          add(difference::kind::added, nullptr, &after[idx]);
+        }
+        pointer_.resize(length);
+      }
+    }
+
+    void compare_objects(const json &before, const json &after)
+    {
+      if (sorted(before) && sorted(after)) {
+        merge_sorted_objects(before, after);
+        return;
+      }
+
+      const auto length = pointer_.size();
+      for (auto itr = before.begin(); itr != before.end(); ++itr) {
+        append_pointer_token(pointer_, itr.key());
+        if (const auto found = after.find(itr.key()); found == after.end()) {
+          add(difference::kind::removed, &itr.value(), nullptr);
+        } else {
+          compare(itr.value(), found.value());
+        }
+        pointer_.resize(length);
+      }
+      for (auto itr = after.begin(); itr != after.end(); ++itr) {
+        if (before.find(itr.key()) != before.end()) { continue; }
+        append_pointer_token(pointer_, itr.key());
+        add(difference::kind::added, nullptr, &itr.value());
+        pointer_.resize(length);
+      }
+    }
+
+    // compiled objects not laid out for a profile, and objects parsed from nlohmann::json
+    // output, have their keys in order, which lets both sides be walked once together
+    // instead of searched
+    [[nodiscard]] static bool sorted(const json &object)
+    {
+      const auto &members = object.object_data();
+      return std::is_sorted(members.begin(), members.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first < rhs.first;
+      });
+    }
+
+    void merge_sorted_objects(const json &before, const json &after)
+    {
+      const auto length = pointer_.size();
+      std::vector<const value_pair_t *> added;
+      const auto *before_member = before.object_data().begin();
+      const auto *after_member = after.object_data().begin();
+      while (before_member != before.object_data().end() || after_member != after.object_data().end()) {
+        if (after_member == after.object_data().end()
+            || (before_member != before.object_data().end() && before_member->first < after_member->first)) {
+          append_pointer_token(pointer_, before_member->first);
+          add(difference::kind::removed, &before_member->second, nullptr);
+          ++before_member;
+        } else if (before_member == before.object_data().end() || after_member->first < before_member->first) {
+          added.push_back(after_member++);
+          continue;
+        } else {
+          append_pointer_token(pointer_, before_member->first);
+          compare((before_member++)->second, (after_member++)->second);
+        }
+        pointer_.resize(length);
+      }
+      // reported after the members of `before`, as for unsorted objects
+      for (const auto *member : added) {
+        append_pointer_token(pointer_, member->first);
+        add(difference::kind::added, nullptr, &member->second);
+        pointer_.resize(length);
+      }
+    }
+
+    void add(const difference::kind change, const json *before, const json *after)
+    {
+      differences_.push_back(difference{ pointer_, change, before, after });
+    }
+
+    const hash_index &before_hashes_;
+    const hash_index &after_hashes_;
+    std::vector<difference> &differences_;
+    std::string pointer_;
+  };
+}// namespace hash_detail
+
+// What changed from `before` to `after`: values added, removed and replaced, in the
+// order of `before` and then of the members `after` adds. Arrays compare element by
+// element, and arrays and objects whose hashes match are skipped whole.
+[[nodiscard]] inline std::vector<difference>
+  diff(const json &before, const hash_index &before_hashes, const json &after, const hash_index &after_hashes)
+{
+  std::vector<difference> differences;
+  hash_detail::differ{ before_hashes, after_hashes, differences }.compare(before, after);
+  return differences;
+}
+
+// `diff` for documents without generated hashes, hashing both first
+[[nodiscard]] inline std::vector<difference> diff(const json &before, const json &after)
+{
+  return diff(before, hash_index{ before }, after, hash_index{ after });
+}
+
+}// namespace json2cpp
+
+#endif
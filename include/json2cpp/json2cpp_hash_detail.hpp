@@ -0,0 +1,172 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Internal: the hashing that json2cpp_hash.hpp and the memo of json2cpp_validation.hpp
+// share. Works on json2cpp::json and nlohmann::json alike and does not include either.
+
+#ifndef JSON2CPP_HASH_DETAIL_HPP_INCLUDED
+#define JSON2CPP_HASH_DETAIL_HPP_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace json2cpp::hash_detail {
+// the splitmix64 finalizer, which spreads every input bit over the whole word
+[[nodiscard]] constexpr std::uint64_t mix(std::uint64_t value) noexcept
+{
+  value ^= value >> 30U;
+  value *= 0xbf58476d1ce4e5b9ULL;
+  value ^= value >> 27U;
+  value *= 0x94d049bb133111ebULL;
+  value ^= value >> 31U;
+  return value;
+}
+
+// eight bytes per step, assembled little-endian whatever the byte order of the host,
+// so the generator and the program agree
+[[nodiscard]] constexpr std::uint64_t hash_string(const std::string_view string, const std::uint64_t seed) noexcept
+{
+  std::uint64_t hash = seed ^ (string.size() * 0x9e3779b97f4a7c15ULL);
+  std::uint64_t word = 0;
+  std::size_t filled = 0;
+  for (const auto character : string) {
+    word |= std::uint64_t{ static_cast<unsigned char>(character) } << (8U * filled);
+    if (++filled == sizeof(word)) {
+      hash = mix(hash ^ word);
+      word = 0;
+      filled = 0;
+    }
+  }
+  if (filled != 0) { hash = mix(hash ^ word); }
+  return mix(hash);
+}
+
+[[nodiscard]] constexpr std::uint64_t hash_unsigned(const std::uint64_t value) noexcept
+{
+  return mix(value ^ 0x75696e74ULL);
+}
+
+[[nodiscard]] constexpr std::uint64_t hash_signed(const std::int64_t value) noexcept
+{
+  if (value >= 0) { return hash_unsigned(static_cast<std::uint64_t>(value)); }
+  return mix(static_cast<std::uint64_t>(value) ^ 0x696e74ULL);
+}
+
+// a double by its representation, never equal to the hash of an integer
+[[nodiscard]] inline std::uint64_t hash_double_bits(const double value) noexcept
+{
+  std::uint64_t bits = 0;
+  static_assert(sizeof(bits) == sizeof(value));
+  std::memcpy(&bits, &value, sizeof(bits));
+  return mix(bits ^ 0x666c6f6174ULL);
+}
+
+// a double holding an integer hashes as that integer, so 1 and 1.0 hash alike
+[[nodiscard]] inline std::uint64_t hash_double(const double value) noexcept
+{
+  if (value >= 0.0 && value < 18446744073709551616.0) {
+    const auto integer = static_cast<std::uint64_t>(value);
+    if (static_cast<double>(integer) == value) { return hash_unsigned(integer); }
+  } else if (value < 0.0 && value >= -9223372036854775808.0) {
+    const auto integer = static_cast<std::int64_t>(value);
+    if (static_cast<double>(integer) == value) { return hash_signed(integer); }
+  }
+  return hash_double_bits(value);
+}
+
+template<typename JSON, typename = void> struct has_get_ref : std::false_type
+{
+};
+
+template<typename JSON>
+struct has_get_ref<JSON, std::void_t<decltype(std::declval<const JSON &>().template get_ref<const std::string &>())>>
+  : std::true_type
+{
+};
+
+// the string held by `value`, without a copy for nlohmann::json
+template<typename JSON> [[nodiscard]] constexpr std::string_view string_of(const JSON &value)
+{
+  if constexpr (has_get_ref<JSON>::value) {
+    return value.template get_ref<const std::string &>();
+  } else {
+    return value.template get<std::string_view>();
+  }
+}
+
+// How a tree hashes its doubles: by value, as operator== compares numbers, or by
+// representation, for callers that must tell 1.0 from 1
+enum class doubles { by_value, by_representation };
+
+// Hashes everything in `value` once and passes each array and object met on the
+// way, with its hash, to `on_subtree`. Object members are combined without regard
+// to their order. A nonzero `seed` keys every hash, so hashes made with a secret
+// seed cannot be predicted, and colliding values cannot be built, from outside.
+template<doubles Doubles, typename JSON, typename Callback>
+[[nodiscard]] std::uint64_t hash_tree(const JSON &value, Callback &on_subtree, const std::uint64_t seed = 0)
+{
+  std::uint64_t hash = 0;
+  if (value.is_object()) {
+    hash = (0x6f626a656374ULL + value.size()) ^ seed;
+    for (auto itr = value.begin(); itr != value.end(); ++itr) {
+      hash += mix(hash_string(itr.key(), seed) ^ hash_tree<Doubles>(itr.value(), on_subtree, seed));
+    }
+  } else if (value.is_array()) {
+    hash = (0x6172726179ULL + value.size()) ^ seed;
+    for (const auto &element : value) { hash = mix(hash * 31U + hash_tree<Doubles>(element, on_subtree, seed)); }
+  } else if (value.is_string()) {
+    return hash_string(string_of(value), seed ^ 1U);
+  } else if (value.is_number_float()) {
+    if constexpr (Doubles == doubles::by_value) {
+      return hash_double(value.template get<double>()) ^ seed;
+    } else {
+      return hash_double_bits(value.template get<double>()) ^ seed;
+    }
+  } else if (value.is_number_unsigned()) {
+    return hash_unsigned(value.template get<std::uint64_t>()) ^ seed;
+  } else if (value.is_number_integer()) {
+    return hash_signed(value.template get<std::int64_t>()) ^ seed;
+  } else if (value.is_boolean()) {
+    return mix(value.template get<bool>() ? 3U : 2U) ^ seed;
+  } else {
+    return mix(1U) ^ seed;
+  }
+
+  hash = mix(hash);
+  on_subtree(value, hash);
+  return hash;
+}
+
+// receives nothing, for callers that only want the hash of the root
+struct ignore_subtrees
+{
+  template<typename JSON> constexpr void operator()(const JSON &, std::uint64_t) const noexcept {}
+};
+}// namespace json2cpp::hash_detail
+
+#endif
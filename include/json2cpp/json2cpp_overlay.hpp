@@ -0,0 +1,302 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// A compiled document seen through a JSON Merge Patch (RFC 7386), without copying
+// either. `json2cpp::overlay{ base, patch }` behaves like the result of applying
+// `patch` to `base`: a member the patch sets to null is gone, an object in the
+// patch is merged member by member into the base object, and any other value in
+// the patch replaces the base value, arrays included. Lookups consult the patch
+// before falling through to the base and iteration interleaves the two, base
+// members first in their order, then members only the patch has. An overlay is
+// two pointers and never allocates. The patch is typically small and parsed at
+// runtime with json2cpp::parse; both documents must outlive their overlays.
+
+#ifndef JSON2CPP_OVERLAY_HPP_INCLUDED
+#define JSON2CPP_OVERLAY_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+
+namespace json2cpp {
+
+class overlay
+{
+public:
+  // `base` with `patch` applied
+  overlay(const json &base, const json &patch) noexcept : base_{ &base }, patch_{ &patch } {}
+
+  // `base` unchanged
+  explicit overlay(const json &base) noexcept : base_{ &base }, patch_{ nullptr } {}
+
+  class iterator
+  {
+  public:
+    iterator() noexcept = default;
+
+    [[nodiscard]] overlay operator*() const
+    {
+      if (!parent().merged()) { return overlay{ *source_iterator() }; }
+      const auto &member = current_member();
+      if (in_patch_) { return overlay{ nullptr, &member.second }; }
+      return overlay{ &member.second, overlay::member(*patch_, member.first) };
+    }
+
+    [[nodiscard]] std::string_view key() const
+    {
+      if (!parent().merged()) { return source_iterator().key(); }
+      return current_member().first;
+    }
+
+    iterator &operator++()
+    {
+      ++index_;
+      skip_removed();
+      return *this;
+    }
+
+    [[nodiscard]] iterator operator++(int)
+    {
+      iterator result{ *this };
+      ++(*this);
+      return result;
+    }
+
+    [[nodiscard]] bool operator==(const iterator &other) const noexcept
+    {
+      return base_ == other.base_ && patch_ == other.patch_ && in_patch_ == other.in_patch_ && index_ == other.index_;
+    }
+    [[nodiscard]] bool operator!=(const iterator &other) const noexcept { return !(*this == other); }
+
+  private:
+    friend class overlay;
+
+    iterator(const overlay &owner, const bool at_end) : base_{ owner.base_ }, patch_{ owner.patch_ }
+    {
+      if (!owner.merged()) {
+        index_ = at_end ? owner.source()->size() : 0;
+        return;
+      }
+      if (at_end) {
+        in_patch_ = true;
+        index_ = owner.patch_->size();
+        return;
+      }
+      in_patch_ = owner.base_ == nullptr || !owner.base_->is_object();
+      skip_removed();
+    }
+
+    [[nodiscard]] json::iterator source_iterator() const { return json::iterator{ *parent().source(), index_ }; }
+
+    [[nodiscard]] const value_pair_t &current_member() const
+    {
+      const auto &members = in_patch_ ? patch_->object_data() : base_->object_data();
+      return *std::next(members.begin(), static_cast<std::ptrdiff_t>(index_));
+    }
+
+    // moves past base members the patch deletes, and patch members that are
+    // deletions or were already visited as base members; each member skipped or
+    // stopped at is looked up by a linear search of the other object
+    void skip_removed()
+    {
+      if (!parent().merged()) { return; }
+      const auto &patch = *patch_;
+      if (!in_patch_) {
+        const auto &members = base_->object_data();
+        for (; index_ < members.size(); ++index_) {
+          const auto &candidate = *std::next(members.begin(), static_cast<std::ptrdiff_t>(index_));
+          const auto *patched = overlay::member(patch, candidate.first);
+          if (patched == nullptr || !patched->is_null()) { return; }
+        }
+        in_patch_ = true;
+        index_ = 0;
+      }
+      const auto &members = patch.object_data();
+      const bool has_base = base_ != nullptr && base_->is_object();
+      for (; index_ < members.size(); ++index_) {
+        const auto &candidate = *std::next(members.begin(), static_cast<std::ptrdiff_t>(index_));
+        if (candidate.second.is_null()) { continue; }
+        if (!has_base || overlay::member(*base_, candidate.first) == nullptr) { return; }
+      }
+    }
+
+    [[nodiscard]] overlay parent() const noexcept { return overlay{ base_, patch_ }; }
+
+    const json *base_{ nullptr };
+    const json *patch_{ nullptr };
+    bool in_patch_{ false };
+    std::size_t index_{ 0 };
+  };
+
+  using const_iterator = iterator;
+
+  [[nodiscard]] iterator begin() const { return iterator{ *this, false }; }
+  [[nodiscard]] iterator end() const { return iterator{ *this, true }; }
+
+  [[nodiscard]] bool is_object() const noexcept { return merged() || source()->is_object(); }
+  [[nodiscard]] bool is_array() const noexcept { return !merged() && source()->is_array(); }
+  [[nodiscard]] bool is_string() const noexcept { return !merged() && source()->is_string(); }
+  [[nodiscard]] bool is_boolean() const noexcept { return !merged() && source()->is_boolean(); }
+  [[nodiscard]] bool is_null() const noexcept { return !merged() && source()->is_null(); }
+  [[nodiscard]] bool is_number() const noexcept { return !merged() && source()->is_number(); }
+  [[nodiscard]] bool is_number_integer() const noexcept { return !merged() && source()->is_number_integer(); }
+  [[nodiscard]] bool is_number_signed() const noexcept { return !merged() && source()->is_number_signed(); }
+  [[nodiscard]] bool is_number_unsigned() const noexcept { return !merged() && source()->is_number_unsigned(); }
+  [[nodiscard]] bool is_number_float() const noexcept { return !merged() && source()->is_number_float(); }
+  [[nodiscard]] bool is_structured() const noexcept { return is_object() || is_array(); }
+  [[nodiscard]] bool is_primitive() const noexcept { return !is_structured(); }
+
+  template<typename Type> [[nodiscard]] auto get() const
+  {
+    if (merged()) { throw std::runtime_error("Unexpected type: value is an object"); }
+    return source()->template get<Type>();
+  }
+
+  // number of members or elements; for a patched object this counts them, in
+  // time linear in the base and the patch when both have their keys in order, as
+  // compiled objects and objects parsed from nlohmann::json output do, and in
+  // time proportional to their product otherwise
+  [[nodiscard]] std::size_t size() const
+  {
+    if (!merged()) { return source()->size(); }
+    if (base_ == nullptr || !base_->is_object()) { return count_members(); }
+    if (ascending(*base_) && ascending(*patch_)) { return merge_count(); }
+    std::size_t count = 0;
+    for (auto itr = begin(); itr != end(); ++itr) { ++count; }
+    return count;
+  }
+
+  [[nodiscard]] bool empty() const { return begin() == end(); }
+
+  [[nodiscard]] bool contains(const std::string_view key) const { return lookup(key).has_value; }
+  [[nodiscard]] std::size_t count(const std::string_view key) const { return contains(key) ? 1 : 0; }
+
+  [[nodiscard]] overlay at(const std::string_view key) const
+  {
+    if (!is_object()) { throw std::runtime_error("value is not an object type"); }
+    const auto found = lookup(key);
+    if (!found.has_value) { throw std::runtime_error("Key not found"); }
+    return overlay{ found.base, found.patch };
+  }
+
+  [[nodiscard]] overlay operator[](const std::string_view key) const { return at(key); }
+
+  // elements of arrays are never patched: a patch replaces an array as a whole
+  [[nodiscard]] overlay operator[](const std::size_t idx) const
+  {
+    if (merged()) { throw std::runtime_error("value is not an array type"); }
+    return overlay{ (*source())[idx] };
+  }
+
+  // whether the patch touches this value or anything below it
+  [[nodiscard]] bool patched() const noexcept { return patch_ != nullptr; }
+
+private:
+  overlay(const json *base, const json *patch) noexcept : base_{ base }, patch_{ patch } {}
+
+  struct lookup_result
+  {
+    bool has_value;
+    const json *base;
+    const json *patch;
+  };
+
+  [[nodiscard]] static const json *member(const json &object, const std::string_view key)
+  {
+    if (!object.is_object()) { return nullptr; }
+    for (const auto &pair : object.object_data()) {
+      if (pair.first == key) { return &pair.second; }
+    }
+    return nullptr;
+  }
+
+  [[nodiscard]] lookup_result lookup(const std::string_view key) const
+  {
+    if (!merged()) {
+      const auto *found = member(*source(), key);
+      return { found != nullptr, found, nullptr };
+    }
+    const auto *patched = member(*patch_, key);
+    if (patched != nullptr && patched->is_null()) { return { false, nullptr, nullptr }; }
+    const auto *original = base_ == nullptr ? nullptr : member(*base_, key);
+    return { patched != nullptr || original != nullptr, original, patched };
+  }
+
+  // members of an object patch applied to a non-object, which only the patch has
+  [[nodiscard]] std::size_t count_members() const
+  {
+    const auto &members = patch_->object_data();
+    return static_cast<std::size_t>(
+      std::count_if(members.begin(), members.end(), [](const auto &member) { return !member.second.is_null(); }));
+  }
+
+  // keys strictly increasing, so no key repeats
+  [[nodiscard]] static bool ascending(const json &object)
+  {
+    const auto &members = object.object_data();
+    return std::adjacent_find(members.begin(), members.end(), [](const auto &lhs, const auto &rhs) {
+      return !(lhs.first < rhs.first);
+    }) == members.end();
+  }
+
+  // walks the base and the patch once together
+  [[nodiscard]] std::size_t merge_count() const
+  {
+    const auto &base = base_->object_data();
+    const auto &patch = patch_->object_data();
+    const auto *base_member = base.begin();
+    const auto *patch_member = patch.begin();
+    std::size_t count = 0;
+    while (base_member != base.end() && patch_member != patch.end()) {
+      if (base_member->first < patch_member->first) {
+        ++count;
+        ++base_member;
+      } else {
+        if (!patch_member->second.is_null()) { ++count; }
+        if (!(patch_member->first < base_member->first)) { ++base_member; }
+        ++patch_member;
+      }
+    }
+    count += static_cast<std::size_t>(std::distance(base_member, base.end()));
+    for (; patch_member != patch.end(); ++patch_member) {
+      if (!patch_member->second.is_null()) { ++count; }
+    }
+    return count;
+  }
+
+  // an object patch applies member by member; anything else replaces the base
+  [[nodiscard]] bool merged() const noexcept { return patch_ != nullptr && patch_->is_object(); }
+
+  // the value an unmerged overlay shows
+  [[nodiscard]] const json *source() const noexcept { return patch_ != nullptr ? patch_ : base_; }
+
+  const json *base_;// nullptr where only the patch has the value
+  const json *patch_;// nullptr where the patch does not reach
+};
+
+}// namespace json2cpp
+
+#endif
@@ -0,0 +1,242 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Whole-document passes (sums, counts, searches) split over a json2cpp::thread_pool.
+// Compiled data is immutable, so any number of threads can read it at once.
+//
+// A `walk_plan` cuts the document into tasks of roughly equal numbers of nodes:
+// it counts the nodes of every subtree, keeps each small enough subtree whole and
+// splits the bigger ones, grouping runs of consecutive siblings. The containers
+// that were split are visited on their own, outside the tasks. Counting takes one
+// serial pass over the document, so build the plan once and reuse it:
+//
+//   json2cpp::thread_pool pool;
+//   const json2cpp::walk_plan plan{ document, pool.size() };
+//   const auto strings = json2cpp::parallel_reduce(pool, plan, std::size_t{ 0 },
+//     [](std::size_t &count, const json2cpp::json &node) { count += node.is_string() ? 1 : 0; },
+//     [](std::size_t lhs, std::size_t rhs) { return lhs + rhs; });
+//
+// `parallel_reduce` combines the partial results in the order of the plan, so the
+// result only depends on the plan, not on the number of threads or their timing.
+
+#ifndef JSON2CPP_PARALLEL_HPP_INCLUDED
+#define JSON2CPP_PARALLEL_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include "json2cpp_thread_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace json2cpp {
+
+namespace parallel_detail {
+  template<typename CharType>
+  [[nodiscard]] const basic_json<CharType> &child(const basic_json<CharType> &container, const std::size_t idx)
+  {
+    if (container.is_array()) { return container.array_data()[idx]; }
+    return container.object_data()[idx].second;
+  }
+
+  // the size of the subtree of an array or object, and how many of the plan's
+  // `subtree_size` entries it spans: its own and those of the arrays and objects in it
+  struct subtree_size
+  {
+    std::size_t nodes;
+    std::size_t entries;
+  };
+
+  // Appends the sizes of the arrays and objects of `node` to `sizes`, parents before
+  // their children, and returns the number of nodes in it
+  template<typename CharType>
+  std::size_t measure(const basic_json<CharType> &node, std::vector<subtree_size> &sizes)
+  {
+    if (!node.is_structured()) { return 1; }
+    const auto entry = sizes.size();
+    sizes.emplace_back();
+    std::size_t count = 1;
+    for (std::size_t idx = 0; idx < node.size(); ++idx) { count += measure(child(node, idx), sizes); }
+    sizes[entry] = subtree_size{ count, sizes.size() - entry };
+    return count;
+  }
+
+  // `node` and everything below it, parents before their children
+  template<typename CharType, typename Function> void walk(const basic_json<CharType> &node, Function &function)
+  {
+    function(node);
+    if (node.is_array()) {
+      for (const auto &element : node.array_data()) { walk(element, function); }
+    } else if (node.is_object()) {
+      for (const auto &member : node.object_data()) { walk(member.second, function); }
+    }
+  }
+}// namespace parallel_detail
+
+template<typename CharType> class basic_walk_plan
+{
+public:
+  using json_type = basic_json<CharType>;
+
+  // the children [first, last) of `container` and all of their descendants
+  struct task
+  {
+    const json_type *container;
+    std::size_t first;
+    std::size_t last;
+  };
+
+  // Aims for `tasks_per_thread` tasks per thread so that threads finishing early
+  // can steal work from the others, but no task smaller than `min_task_nodes`
+  // unless the whole document is.
+  basic_walk_plan(const json_type &root,
+    const std::size_t thread_count,
+    const std::size_t tasks_per_thread = 4,
+    const std::size_t min_task_nodes = 1024)
+  {
+    std::vector<parallel_detail::subtree_size> sizes;
+    node_count_ = parallel_detail::measure(root, sizes);
+    const auto wanted_tasks = std::max<std::size_t>(thread_count * tasks_per_thread, 1);
+    grain_ = std::max(node_count_ / wanted_tasks, std::max<std::size_t>(min_task_nodes, 1));
+    split(root, sizes, 0);
+  }
+
+  [[nodiscard]] std::size_t node_count() const noexcept { return node_count_; }
+  [[nodiscard]] const std::vector<const json_type *> &split_nodes() const noexcept { return split_nodes_; }
+  [[nodiscard]] const std::vector<task> &tasks() const noexcept { return tasks_; }
+
+private:
+  // `entry` is the position of `container` in `sizes`
+  void split(const json_type &container, const std::vector<parallel_detail::subtree_size> &sizes, std::size_t entry)
+  {
+    split_nodes_.push_back(&container);
+    if (!container.is_structured()) { return; }
+
+    std::size_t first = 0;
+    std::size_t run_nodes = 0;
+    const auto flush = [&](const std::size_t last) {
+      if (first != last) { tasks_.push_back(task{ &container, first, last }); }
+      first = last;
+      run_nodes = 0;
+    };
+
+    // the entries of the children follow their parent's, each child's own entries together
+    ++entry;
+    for (std::size_t idx = 0; idx < container.size(); ++idx) {
+      const auto &element = parallel_detail::child(container, idx);
+      const auto size = element.is_structured() ? sizes[entry] : parallel_detail::subtree_size{ 1, 0 };
+      if (size.nodes > grain_ && element.is_structured()) {
+        flush(idx);
+        split(element, sizes, entry);
+        first = idx + 1;
+      } else {
+        run_nodes += size.nodes;
+        if (run_nodes >= grain_) { flush(idx + 1); }
+      }
+      entry += size.entries;
+    }
+    flush(container.size());
+  }
+
+  std::size_t node_count_{};
+  std::size_t grain_{};
+  std::vector<const json_type *> split_nodes_;
+  std::vector<task> tasks_;
+};
+
+using walk_plan = basic_walk_plan<char>;
+
+// Calls `function(node)` once for every node of the planned document, from
+// several threads at once: it must be safe to call concurrently. Within a task
+// parents come before their children; there is no order between tasks.
+template<typename CharType, typename Function>
+void parallel_walk(thread_pool &pool, const basic_walk_plan<CharType> &plan, Function &&function)
+{
+  task_group group(pool);
+  for (const auto &work : plan.tasks()) {
+    group.run([&function, work] {
+      for (auto idx = work.first; idx < work.last; ++idx) {
+        parallel_detail::walk(parallel_detail::child(*work.container, idx), function);
+      }
+    });
+  }
+  for (const auto *node : plan.split_nodes()) { function(*node); }
+  group.wait();
+}
+
+template<typename CharType, typename Function>
+void parallel_walk(thread_pool &pool, const basic_json<CharType> &root, Function &&function)
+{
+  parallel_walk(pool, basic_walk_plan<CharType>{ root, pool.size() }, std::forward<Function>(function));
+}
+
+// Folds every node into a `Result`: each task starts from a copy of `identity`
+// and calls `accumulate(partial, node)` for its nodes, then the partial results
+// are merged in plan order with `combine(lhs, rhs)`, which returns the merged
+// value. `identity` must be neutral for `combine`.
+template<typename CharType, typename Result, typename Accumulate, typename Combine>
+[[nodiscard]] Result parallel_reduce(thread_pool &pool,
+  const basic_walk_plan<CharType> &plan,
+  const Result &identity,
+  Accumulate &&accumulate,
+  Combine &&combine)
+{
+  const auto &tasks = plan.tasks();
+  std::vector<Result> partials(tasks.size(), identity);
+
+  task_group group(pool);
+  for (std::size_t idx = 0; idx < tasks.size(); ++idx) {
+    group.run([&accumulate, &partial = partials[idx], work = tasks[idx]] {
+      const auto add = [&](const basic_json<CharType> &node) { accumulate(partial, node); };
+      for (auto child = work.first; child < work.last; ++child) {
+        parallel_detail::walk(parallel_detail::child(*work.container, child), add);
+      }
+    });
+  }
+
+  auto result = identity;
+  for (const auto *node : plan.split_nodes()) { accumulate(result, *node); }
+  group.wait();
+
+  for (auto &partial : partials) { result = combine(std::move(result), std::move(partial)); }
+  return result;
+}
+
+template<typename CharType, typename Result, typename Accumulate, typename Combine>
+[[nodiscard]] Result parallel_reduce(thread_pool &pool,
+  const basic_json<CharType> &root,
+  const Result &identity,
+  Accumulate &&accumulate,
+  Combine &&combine)
+{
+  return parallel_reduce(pool,
+    basic_walk_plan<CharType>{ root, pool.size() },
+    identity,
+    std::forward<Accumulate>(accumulate),
+    std::forward<Combine>(combine));
+}
+
+}// namespace json2cpp
+
+#endif
@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Lets the validators generated by `json2cpp --validator` check the members of
+// large objects and arrays on a json2cpp::thread_pool:
+//
+//   json2cpp::thread_pool pool;
+//   json2cpp::validation::pool_executor parallel{ pool };
+//   json2cpp::validation::context ctx{ errors, parallel };
+//   compiled_json::<name>::validator::validate(document, ctx);
+//
+// Errors are reported in the same order whatever the number of threads.
+
+#ifndef JSON2CPP_PARALLEL_VALIDATION_HPP_INCLUDED
+#define JSON2CPP_PARALLEL_VALIDATION_HPP_INCLUDED
+
+#include "json2cpp_thread_pool.hpp"
+#include "json2cpp_validation.hpp"
+#include <algorithm>
+
+namespace json2cpp::validation {
+
+class pool_executor final : public executor
+{
+public:
+  explicit pool_executor(thread_pool &pool, const std::size_t min_parallel_size = 32) : pool_{ pool }
+  {
+    grain = min_parallel_size;
+  }
+
+  void run(const std::size_t count, const std::function<void(std::size_t)> &task) override
+  {
+    // a few chunks per worker keeps the threads busy when member sizes vary
+    // without paying for one task per member
+    const auto chunk = std::max<std::size_t>(count / (pool_.size() * 4), 1);
+
+    task_group group(pool_);
+    for (std::size_t first = 0; first < count; first += chunk) {
+      group.run([&task, first, last = std::min(first + chunk, count)] {
+        for (auto idx = first; idx < last; ++idx) { task(idx); }
+      });
+    }
+    group.wait();
+  }
+
+private:
+  thread_pool &pool_;
+};
+
+}// namespace json2cpp::validation
+
+#endif
@@ -0,0 +1,654 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// A runtime JSON parser producing a `json2cpp::json`, so documents that only
+// arrive at runtime can use the same API, templates and valijson adapter as
+// compiled ones.
+//
+// Parsing takes two passes over the input. The first checks the syntax and
+// counts the nodes, members and string bytes and the size of every array and
+// object; the second writes each value straight into its final place in a
+// single arena, the children of every array and object contiguous as in
+// generated code. A `json2cpp::document` owns that arena, so destroying it is one
+// deallocation. Strings without escapes point into the input unless
+// `parse_options::copy_strings` is set, in which case the input may be
+// discarded after parsing.
+//
+// Strings and member names must be valid UTF-8, as RFC 8259 requires and
+// nlohmann::json::parse checks: overlong forms, surrogates, code points past
+// U+10FFFF and truncated sequences are rejected like any other syntax error.
+
+#ifndef JSON2CPP_PARSER_HPP_INCLUDED
+#define JSON2CPP_PARSER_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace json2cpp {
+
+struct parse_options
+{
+  // copy every string into the arena instead of referring to the input
+  bool copy_strings{ false };
+  // arrays and objects nested deeper than this are rejected
+  std::size_t max_depth{ 1024 };
+};
+
+namespace parser_detail {
+  static_assert(std::is_trivially_destructible_v<json> && std::is_trivially_destructible_v<value_pair_t>,
+    "arena nodes are released without running destructors");
+
+  [[noreturn]] inline void fail(const std::string_view what, const std::size_t offset)
+  {
+    throw std::runtime_error("JSON parse error at offset " + std::to_string(offset) + ": " + std::string{ what });
+  }
+
+  [[nodiscard]] inline bool is_digit(const char character) noexcept { return character >= '0' && character <= '9'; }
+
+  [[nodiscard]] inline int hex_value(const char character) noexcept
+  {
+    if (character >= '0' && character <= '9') { return character - '0'; }
+    if (character >= 'a' && character <= 'f') { return character - 'a' + 10; }
+    if (character >= 'A' && character <= 'F') { return character - 'A' + 10; }
+    return -1;
+  }
+
+  // true if any of the 8 bytes in `word` is a quote, a backslash, a control character
+  // or part of a multi-byte UTF-8 sequence
+  [[nodiscard]] inline bool has_string_special(const std::uint64_t word) noexcept
+  {
+    constexpr std::uint64_t ones = 0x0101010101010101ULL;
+    constexpr std::uint64_t highs = 0x8080808080808080ULL;
+    const auto has_zero = [](const std::uint64_t value) { return ((value - ones) & ~value & highs) != 0; };
+    const bool control = ((word - ones * 0x20) & ~word & highs) != 0;
+    return control || (word & highs) != 0 || has_zero(word ^ (ones * '"')) || has_zero(word ^ (ones * '\\'));
+  }
+
+  // Checks the syntax of a document and reports its values to `Handler` in document order:
+  // null(), boolean(b), number(text, integral), string(raw, escaped), and for containers
+  // `auto token = begin_array()`, element(token, index) before each element and
+  // end_array(token, count), or the same with begin_object, key(token, index, raw, escaped)
+  // and end_object. `raw` strings are the text between the quotes, escapes undecoded.
+  template<typename Handler> class tokenizer
+  {
+  public:
+    tokenizer(const std::string_view input, const std::size_t max_depth, Handler &handler)
+      : first_{ input.data() }, pos_{ input.data() }, end_{ input.data() + input.size() }, max_depth_{ max_depth },
+        handler_{ handler }
+    {}
+
+    void parse()
+    {
+      skip_whitespace();
+      value(0);
+      skip_whitespace();
+      if (pos_ != end_) { error("unexpected data after the document"); }
+    }
+
+  private:
+    [[noreturn]] void error(const std::string_view what) const
+    {
+      fail(what, static_cast<std::size_t>(pos_ - first_));
+    }
+
+    void skip_whitespace() noexcept
+    {
+      while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) { ++pos_; }
+    }
+
+    void expect(const char character)
+    {
+      if (pos_ == end_ || *pos_ != character) { error(std::string{ "expected '" } + character + '\''); }
+      ++pos_;
+    }
+
+    void value(const std::size_t depth)
+    {
+      if (pos_ == end_) { error("unexpected end of input"); }
+      switch (*pos_) {
+      case '{':
+        object(depth);
+        break;
+      case '[':
+        array(depth);
+        break;
+      case '"': {
+        bool escaped = false;
+        const auto raw = string(escaped);
+        handler_.string(raw, escaped);
+        break;
+      }
+      case 't':
+        literal("true");
+        handler_.boolean(true);
+        break;
+      case 'f':
+        literal("false");
+        handler_.boolean(false);
+        break;
+      case 'n':
+        literal("null");
+        handler_.null();
+        break;
+      default:
+        number();
+      }
+    }
+
+    void literal(const std::string_view text)
+    {
+      if (static_cast<std::size_t>(end_ - pos_) < text.size() || std::memcmp(pos_, text.data(), text.size()) != 0) {
+        error("expected value");
+      }
+      pos_ += text.size();
+    }
+
+    void array(const std::size_t depth)
+    {
+      if (depth >= max_depth_) { error("document is nested too deeply"); }
+      ++pos_;
+      auto token = handler_.begin_array();
+      std::size_t count = 0;
+      skip_whitespace();
+      if (pos_ != end_ && *pos_ == ']') {
+        ++pos_;
+      } else {
+        while (true) {
+          handler_.element(token, count);
+          skip_whitespace();
+          value(depth + 1);
+          ++count;
+          skip_whitespace();
+          if (pos_ != end_ && *pos_ == ',') {
+            ++pos_;
+            continue;
+          }
+          expect(']');
+          break;
+        }
+      }
+      handler_.end_array(token, count);
+    }
+
+    void object(const std::size_t depth)
+    {
+      if (depth >= max_depth_) { error("document is nested too deeply"); }
+      ++pos_;
+      auto token = handler_.begin_object();
+      std::size_t count = 0;
+      skip_whitespace();
+      if (pos_ != end_ && *pos_ == '}') {
+        ++pos_;
+      } else {
+        while (true) {
+          skip_whitespace();
+          if (pos_ == end_ || *pos_ != '"') { error("expected member name"); }
+          bool escaped = false;
+          const auto raw = string(escaped);
+          handler_.key(token, count, raw, escaped);
+          skip_whitespace();
+          expect(':');
+          skip_whitespace();
+          value(depth + 1);
+          ++count;
+          skip_whitespace();
+          if (pos_ != end_ && *pos_ == ',') {
+            ++pos_;
+            continue;
+          }
+          expect('}');
+          break;
+        }
+      }
+      handler_.end_object(token, count);
+    }
+
+    [[nodiscard]] std::string_view string(bool &escaped)
+    {
+      const char *start = ++pos_;
+      while (true) {
+        // skip 8 ASCII bytes at a time
+        while (end_ - pos_ >= 8) {
+          std::uint64_t word{};
+          std::memcpy(&word, pos_, sizeof(word));
+          if (has_string_special(word)) { break; }
+          pos_ += 8;
+        }
+        if (pos_ == end_) { error("unterminated string"); }
+
+        const auto character = static_cast<unsigned char>(*pos_);
+        if (character == '"') { break; }
+        if (character < 0x20) { error("control character in string"); }
+        if (character >= 0x80) {
+          utf8_sequence();
+          continue;
+        }
+        if (character != '\\') {
+          ++pos_;
+          continue;
+        }
+
+        escaped = true;
+        if (++pos_ == end_) { error("unterminated string"); }
+        switch (*pos_) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          ++pos_;
+          break;
+        case 'u':
+          if (end_ - pos_ < 5 || hex_value(pos_[1]) < 0 || hex_value(pos_[2]) < 0 || hex_value(pos_[3]) < 0
+              || hex_value(pos_[4]) < 0) {
+            error("invalid \\u escape");
+          }
+          pos_ += 5;
+          break;
+        default:
+          error("invalid escape");
+        }
+      }
+      const std::string_view raw(start, static_cast<std::size_t>(pos_ - start));
+      ++pos_;
+      return raw;
+    }
+
+    // steps over one multi-byte UTF-8 sequence; the bounds on the second byte
+    // rule out overlong forms, surrogates and code points past U+10FFFF
+    void utf8_sequence()
+    {
+      const auto lead = static_cast<unsigned char>(*pos_);
+      std::ptrdiff_t length = 0;
+      unsigned char low = 0x80;
+      unsigned char high = 0xBF;
+      if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+      } else if (lead == 0xE0) {
+        length = 3;
+        low = 0xA0;
+      } else if (lead == 0xED) {
+        length = 3;
+        high = 0x9F;
+      } else if (lead >= 0xE1 && lead <= 0xEF) {
+        length = 3;
+      } else if (lead == 0xF0) {
+        length = 4;
+        low = 0x90;
+      } else if (lead == 0xF4) {
+        length = 4;
+        high = 0x8F;
+      } else if (lead >= 0xF1 && lead <= 0xF3) {
+        length = 4;
+      } else {
+        error("invalid UTF-8 in string");
+      }
+      if (end_ - pos_ < length) { error("invalid UTF-8 in string"); }
+      for (std::ptrdiff_t idx = 1; idx < length; ++idx) {
+        const auto continuation = static_cast<unsigned char>(pos_[idx]);
+        if (continuation < (idx == 1 ? low : 0x80) || continuation > (idx == 1 ? high : 0xBF)) {
+          error("invalid UTF-8 in string");
+        }
+      }
+      pos_ += length;
+    }
+
+    void number()
+    {
+      const char *start = pos_;
+      bool integral = true;
+      if (*pos_ == '-') { ++pos_; }
+      if (pos_ == end_ || !is_digit(*pos_)) { error("expected value"); }
+      if (*pos_ == '0') {
+        ++pos_;
+      } else {
+        while (pos_ != end_ && is_digit(*pos_)) { ++pos_; }
+      }
+      if (pos_ != end_ && *pos_ == '.') {
+        integral = false;
+        ++pos_;
+        if (pos_ == end_ || !is_digit(*pos_)) { error("expected digits after the decimal point"); }
+        while (pos_ != end_ && is_digit(*pos_)) { ++pos_; }
+      }
+      if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+        integral = false;
+        ++pos_;
+        if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-')) { ++pos_; }
+        if (pos_ == end_ || !is_digit(*pos_)) { error("expected digits in the exponent"); }
+        while (pos_ != end_ && is_digit(*pos_)) { ++pos_; }
+      }
+      handler_.number(std::string_view(start, static_cast<std::size_t>(pos_ - start)), integral, start - first_);
+    }
+
+    const char *first_;
+    const char *pos_;
+    const char *end_;
+    std::size_t max_depth_;
+    Handler &handler_;
+  };
+
+  // First pass: how large the arena must be and how many children each container has
+  class counter
+  {
+  public:
+    explicit counter(const bool copy_strings) : copy_strings_{ copy_strings } {}
+
+    void null() noexcept {}
+    void boolean(bool) noexcept {}
+    void number(std::string_view, bool, std::ptrdiff_t) noexcept {}
+    void string(const std::string_view raw, const bool escaped) noexcept
+    {
+      // decoding never makes a string longer
+      if (escaped || copy_strings_) { chars += raw.size(); }
+    }
+
+    [[nodiscard]] std::size_t begin_array()
+    {
+      sizes.push_back(0);
+      return sizes.size() - 1;
+    }
+    void element(std::size_t, std::size_t) noexcept {}
+    void end_array(const std::size_t token, const std::size_t count) noexcept
+    {
+      sizes[token] = count;
+      nodes += count;
+    }
+
+    [[nodiscard]] std::size_t begin_object() { return begin_array(); }
+    void key(std::size_t, std::size_t, const std::string_view raw, const bool escaped) noexcept
+    {
+      string(raw, escaped);
+    }
+    void end_object(const std::size_t token, const std::size_t count) noexcept
+    {
+      sizes[token] = count;
+      pairs += count;
+    }
+
+    std::vector<std::size_t> sizes;// in the order the containers open
+    std::size_t nodes{ 0 };
+    std::size_t pairs{ 0 };
+    std::size_t chars{ 0 };
+
+  private:
+    bool copy_strings_;
+  };
+
+  // Second pass: constructs every value in the place the first pass reserved for it
+  class builder
+  {
+  public:
+    builder(json *root,
+      const std::vector<std::size_t> &sizes,
+      value_pair_t *pairs,
+      json *nodes,
+      char *chars,
+      bool copy_strings)
+      : slot_{ root }, sizes_{ sizes }, pairs_{ pairs }, nodes_{ nodes }, chars_{ chars }, copy_strings_{ copy_strings }
+    {}
+
+    void null() { place(json{ json::data_t{ nullptr }, 0 }); }
+    void boolean(const bool value) { place(json{ json::data_t{ value }, 1 }); }
+
+    void number(const std::string_view text, const bool integral, const std::ptrdiff_t offset)
+    {
+      if (integral) {
+        const bool negative = text.front() == '-';
+        std::uint64_t magnitude = 0;
+        bool overflow = false;
+        for (const auto digit : text.substr(negative ? 1 : 0)) {
+          const auto value = static_cast<std::uint64_t>(digit - '0');
+          if (magnitude > (std::numeric_limits<std::uint64_t>::max() - value) / 10) {
+            overflow = true;
+            break;
+          }
+          magnitude = magnitude * 10 + value;
+        }
+
+        constexpr auto int64_limit = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max()) + 1;
+        if (!overflow && !negative) {
+          place(json{ json::data_t{ magnitude }, 1 });
+          return;
+        }
+        if (!overflow && magnitude <= int64_limit) {
+          const auto value = magnitude == int64_limit ? std::numeric_limits<std::int64_t>::min()
+                                                      : -static_cast<std::int64_t>(magnitude);
+          place(json{ json::data_t{ value }, 1 });
+          return;
+        }
+      }
+      place(json{ json::data_t{ to_double(text, offset) }, 1 });
+    }
+
+    void string(const std::string_view raw, const bool escaped)
+    {
+      place(json{ json::data_t{ store(raw, escaped) }, 1 });
+    }
+
+    [[nodiscard]] json *begin_array()
+    {
+      const auto count = sizes_[next_size_++];
+      json *children = nodes_;
+      nodes_ += count;
+      place(json{ json::data_t{ array_t{ children, children + count } }, count });
+      return children;
+    }
+    void element(json *children, const std::size_t index) noexcept { slot_ = children + index; }
+    void end_array(json *, std::size_t) noexcept {}
+
+    [[nodiscard]] value_pair_t *begin_object()
+    {
+      const auto count = sizes_[next_size_++];
+      value_pair_t *members = pairs_;
+      pairs_ += count;
+      place(json{ json::data_t{ object_t{ members, members + count } }, count });
+      return members;
+    }
+    void key(value_pair_t *members, const std::size_t index, const std::string_view raw, const bool escaped)
+    {
+      auto *member = ::new (static_cast<void *>(members + index))
+        value_pair_t{ store(raw, escaped), json{ json::data_t{ nullptr }, 0 } };
+      slot_ = &member->second;
+    }
+    void end_object(value_pair_t *, std::size_t) noexcept {}
+
+  private:
+    void place(const json &value) { ::new (static_cast<void *>(slot_)) json{ value }; }
+
+    [[nodiscard]] static double to_double(const std::string_view text, const std::ptrdiff_t offset)
+    {
+      double value{};
+#if defined(__cpp_lib_to_chars)
+      const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (result.ec != std::errc{}) { fail("number out of range", static_cast<std::size_t>(offset)); }
+#else
+      const std::string copy{ text };
+      value = std::strtod(copy.c_str(), nullptr);
+      if (value == HUGE_VAL || value == -HUGE_VAL) { fail("number out of range", static_cast<std::size_t>(offset)); }
+#endif
+      return value;
+    }
+
+    // `raw` as it will be stored: a view of the input or a (decoded) copy in the arena
+    [[nodiscard]] std::string_view store(const std::string_view raw, const bool escaped)
+    {
+      if (!escaped) {
+        if (!copy_strings_) { return raw; }
+        std::memcpy(chars_, raw.data(), raw.size());
+        const std::string_view copy(chars_, raw.size());
+        chars_ += raw.size();
+        return copy;
+      }
+
+      char *const start = chars_;
+      for (std::size_t idx = 0; idx < raw.size(); ++idx) {
+        if (raw[idx] != '\\') {
+          *chars_++ = raw[idx];
+          continue;
+        }
+        switch (raw[++idx]) {
+        case 'b':
+          *chars_++ = '\b';
+          break;
+        case 'f':
+          *chars_++ = '\f';
+          break;
+        case 'n':
+          *chars_++ = '\n';
+          break;
+        case 'r':
+          *chars_++ = '\r';
+          break;
+        case 't':
+          *chars_++ = '\t';
+          break;
+        case 'u': {
+          auto code_point = hex4(raw, idx + 1);
+          idx += 4;
+          if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+            // a high surrogate must be followed by an escaped low surrogate
+            if (idx + 6 >= raw.size() || raw[idx + 1] != '\\' || raw[idx + 2] != 'u') {
+              throw std::runtime_error("JSON parse error: unpaired surrogate in string");
+            }
+            const auto low = hex4(raw, idx + 3);
+            if (low < 0xDC00 || low > 0xDFFF) { throw std::runtime_error("JSON parse error: invalid surrogate pair"); }
+            code_point = 0x10000 + ((code_point - 0xD800) << 10U) + (low - 0xDC00);
+            idx += 6;
+          } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+            throw std::runtime_error("JSON parse error: unpaired surrogate in string");
+          }
+          append_utf8(code_point);
+          break;
+        }
+        default:// '"', '\\' and '/'
+          *chars_++ = raw[idx];
+        }
+      }
+      return { start, static_cast<std::size_t>(chars_ - start) };
+    }
+
+    [[nodiscard]] static std::uint32_t hex4(const std::string_view raw, const std::size_t position) noexcept
+    {
+      std::uint32_t value = 0;
+      for (std::size_t idx = position; idx < position + 4; ++idx) {
+        value = (value << 4U) | static_cast<std::uint32_t>(hex_value(raw[idx]));
+      }
+      return value;
+    }
+
+    void append_utf8(const std::uint32_t code_point) noexcept
+    {
+      const auto put = [&](const std::uint32_t byte) {
+        *chars_++ = static_cast<char>(static_cast<unsigned char>(byte));
+      };
+      if (code_point < 0x80) {
+        put(code_point);
+      } else if (code_point < 0x800) {
+        put(0xC0U | (code_point >> 6U));
+        put(0x80U | (code_point & 0x3FU));
+      } else if (code_point < 0x10000) {
+        put(0xE0U | (code_point >> 12U));
+        put(0x80U | ((code_point >> 6U) & 0x3FU));
+        put(0x80U | (code_point & 0x3FU));
+      } else {
+        put(0xF0U | (code_point >> 18U));
+        put(0x80U | ((code_point >> 12U) & 0x3FU));
+        put(0x80U | ((code_point >> 6U) & 0x3FU));
+        put(0x80U | (code_point & 0x3FU));
+      }
+    }
+
+    json *slot_;
+    const std::vector<std::size_t> &sizes_;
+    std::size_t next_size_{ 0 };
+    value_pair_t *pairs_;
+    json *nodes_;
+    char *chars_;
+    bool copy_strings_;
+  };
+}// namespace parser_detail
+
+// A parsed document. The values live in one arena owned by this object; unless
+// parsed with `copy_strings`, strings may also refer to the input text, which
+// must then outlive the document.
+class document
+{
+public:
+  document() = default;
+
+  [[nodiscard]] const json &root() const noexcept { return root_; }
+
+  // bytes allocated for the arena
+  [[nodiscard]] std::size_t arena_size() const noexcept { return arena_size_; }
+
+private:
+  friend document parse(std::string_view input, const parse_options &options);
+
+  std::unique_ptr<std::byte[]> arena_;
+  std::size_t arena_size_{ 0 };
+  json root_{ json::data_t{ nullptr }, 0 };
+};
+
+// Parses a JSON text (RFC 8259) into a document; throws std::runtime_error, naming
+// the byte offset, if it is not valid JSON
+[[nodiscard]] inline document parse(const std::string_view input, const parse_options &options = {})
+{
+  parser_detail::counter counter{ options.copy_strings };
+  parser_detail::tokenizer<parser_detail::counter>{ input, options.max_depth, counter }.parse();
+
+  document result;
+  const auto pair_bytes = counter.pairs * sizeof(value_pair_t);
+  const auto node_bytes = counter.nodes * sizeof(json);
+  static_assert(sizeof(value_pair_t) % alignof(json) == 0);
+  result.arena_size_ = pair_bytes + node_bytes + counter.chars;
+  if (result.arena_size_ != 0) { result.arena_.reset(new std::byte[result.arena_size_]); }
+
+  auto *pairs = reinterpret_cast<value_pair_t *>(result.arena_.get());
+  auto *nodes = reinterpret_cast<json *>(result.arena_.get() + pair_bytes);
+  auto *chars = reinterpret_cast<char *>(result.arena_.get() + pair_bytes + node_bytes);
+
+  parser_detail::builder builder{ &result.root_, counter.sizes, pairs, nodes, chars, options.copy_strings };
+  parser_detail::tokenizer<parser_detail::builder>{ input, options.max_depth, builder }.parse();
+  return result;
+}
+
+}// namespace json2cpp
+
+#endif
@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Access profiles of compiled documents, for `json2cpp --profile`.
+//
+// A program built with JSON2CPP_PROFILE defined (everywhere it includes
+// json2cpp.hpp) counts, for each non-empty array and object, how often it was
+// reached through `at()`, `find()`, `operator[]` or `begin()`, and for each key
+// looked up in an object how often it was looked up and how many keys those
+// lookups compared. `write_profile` writes the counts for the nodes of one
+// document as JSON:
+//
+//   {"json2cpp_profile":1,"nodes":[{"pointer":"/a","touches":3,
+//     "keys":{"b":{"lookups":2,"comparisons":4}}}, ...]}
+//
+// Given that file, the generator scans each object's most looked-up keys first
+// and moves the arrays and objects that were never reached out of the way, see
+// JSON2CPP_COLD in json2cpp.hpp. Recording takes a lock per access, so profile
+// with a representative workload, not in production.
+
+#ifndef JSON2CPP_PROFILE_HPP_INCLUDED
+#define JSON2CPP_PROFILE_HPP_INCLUDED
+
+#ifndef JSON2CPP_PROFILE
+#error "json2cpp_profile.hpp needs JSON2CPP_PROFILE defined before json2cpp.hpp is included"
+#endif
+
+#include "json2cpp.hpp"
+#include "json2cpp_serializer.hpp"
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace json2cpp {
+
+namespace profile_detail {
+  inline void append_pointer_token(std::string &pointer, const std::string_view token)
+  {
+    pointer += '/';
+    for (const auto character : token) {
+      if (character == '~') {
+        pointer += "~0";
+      } else if (character == '/') {
+        pointer += "~1";
+      } else {
+        pointer += character;
+      }
+    }
+  }
+
+  inline void write_nodes(const json &value, std::string &pointer, std::string &out, bool &first)
+  {
+    if (!value.is_structured() || value.empty()) { return; }
+
+    if (const auto recorded = instance().nodes.find(value.children_address()); recorded != instance().nodes.end()) {
+      const auto &counts = recorded->second;
+      out += first ? "{\"pointer\":" : ",{\"pointer\":";
+      first = false;
+      serializer_detail::append_escaped(out, pointer);
+      out += ",\"touches\":";
+      serializer_detail::append_integer(out, counts.touches);
+      out += ",\"keys\":{";
+      bool first_key = true;
+      for (const auto &[key, key_count] : counts.keys) {
+        if (!first_key) { out += ','; }
+        first_key = false;
+        serializer_detail::append_escaped(out, key);
+        out += ":{\"lookups\":";
+        serializer_detail::append_integer(out, key_count.lookups);
+        out += ",\"comparisons\":";
+        serializer_detail::append_integer(out, key_count.comparisons);
+        out += '}';
+      }
+      out += "}}";
+    }
+
+    // walked through the children directly, so writing the profile records nothing
+    const auto length = pointer.size();
+    if (value.is_object()) {
+      for (const auto &member : value.object_data()) {
+        append_pointer_token(pointer, member.first);
+        write_nodes(member.second, pointer, out, first);
+        pointer.resize(length);
+      }
+    } else {
+      std::size_t index = 0;
+      for (const auto &element : value.array_data()) {
+        pointer += '/';
+        serializer_detail::append_integer(pointer, index++);
+        write_nodes(element, pointer, out, first);
+        pointer.resize(length);
+      }
+    }
+  }
+}// namespace profile_detail
+
+// Writes what has been recorded so far for the arrays and objects of the document
+// `root`; counts for other documents are left out
+inline void write_profile(std::ostream &out, const json &root)
+{
+  std::string text = "{\"json2cpp_profile\":1,\"nodes\":[";
+  {
+    auto &counts = profile_detail::instance();
+    const std::lock_guard lock(counts.mutex);
+    std::string pointer;
+    bool first = true;
+    profile_detail::write_nodes(root, pointer, text, first);
+  }
+  text += "]}\n";
+  out << text;
+}
+
+// Forgets everything recorded so far, to profile one phase of a program
+inline void reset_profile()
+{
+  auto &counts = profile_detail::instance();
+  const std::lock_guard lock(counts.mutex);
+  counts.nodes.clear();
+}
+
+}// namespace json2cpp
+
+#endif
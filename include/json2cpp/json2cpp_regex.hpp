@@ -0,0 +1,75 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Matcher for the pattern DFAs that `json2cpp --validator` compiles from a schema's
+// `pattern` and `patternProperties` at generation time. It answers the same question
+// as `std::regex_search` with one table lookup per input byte, is constexpr and
+// never allocates.
+
+#ifndef JSON2CPP_REGEX_HPP_INCLUDED
+#define JSON2CPP_REGEX_HPP_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace json2cpp {
+
+template<std::size_t States, std::size_t Classes> struct regex_dfa
+{
+  static_assert(States >= 2, "a DFA has at least the dead and the start state");
+
+  static constexpr std::uint16_t dead_state = 0;
+  static constexpr std::uint16_t start_state = 1;
+
+  static constexpr std::uint8_t accept_none = 0;
+  // a match has been found, whatever follows
+  static constexpr std::uint8_t accept_now = 1;
+  // a match ending at the end of the input (a pattern ending in `$`)
+  static constexpr std::uint8_t accept_at_end = 2;
+
+  std::array<std::uint8_t, 256> byte_class;
+  std::array<std::uint16_t, States * Classes> transitions;
+  std::array<std::uint8_t, States> accept;
+
+  [[nodiscard]] constexpr bool search(const std::string_view text) const noexcept
+  {
+    std::uint16_t state = start_state;
+    if (accept[state] == accept_now) { return true; }
+
+    for (const char character : text) {
+      state = transitions[static_cast<std::size_t>(state) * Classes
+                          + byte_class[static_cast<std::size_t>(static_cast<unsigned char>(character))]];
+      if (accept[state] == accept_now) { return true; }
+      if (state == dead_state) { return false; }
+    }
+
+    return accept[state] != accept_none;
+  }
+};
+
+}// namespace json2cpp
+
+#endif
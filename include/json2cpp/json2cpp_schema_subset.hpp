@@ -0,0 +1,184 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Populating a valijson::Schema builds constraints for every subschema it
+// reaches, so a schema with thousands of object types costs the same to
+// populate whether a document uses three of them or all of them. A
+// schema_subset is a compiled schema whose root `properties` keeps only the
+// members a document actually has:
+//
+//   const json2cpp::schema_subset subset{ compiled_json::<name>::get(), document };
+//   parser.populateSchema(valijson::adapters::json2cppJsonAdapter(subset.get()), schema);
+//
+// Validating that document against the result gives the same answer as against
+// the whole schema. A property the document lacks is still kept when a local
+// `$ref` anywhere in the schema points into it (`#/properties/<name>/...`),
+// and every property is kept when one points at the root or at its
+// `properties`, since other values are then validated against them too.
+// Otherwise such a property can only be named by `required`, which is kept and
+// checks presence alone. Finding the references takes one pass over the schema;
+// nothing is copied but the root's members, and every subschema is still the
+// compiled one.
+
+#ifndef JSON2CPP_SCHEMA_SUBSET_HPP_INCLUDED
+#define JSON2CPP_SCHEMA_SUBSET_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace json2cpp {
+
+class schema_subset
+{
+public:
+  // `document` is a json2cpp::json or nlohmann::json; its member names select the properties
+  template<typename Document> schema_subset(const json &schema, const Document &document)
+  {
+    std::vector<std::string_view> names;
+    if (document.is_object()) {
+      for (auto itr = document.begin(); itr != document.end(); ++itr) { names.emplace_back(itr.key()); }
+    }
+    select(schema, std::move(names));
+  }
+
+  // Keeps the properties named in `names`, which need not be sorted
+  schema_subset(const json &schema, std::vector<std::string_view> names) { select(schema, std::move(names)); }
+
+  // root_ points into the vectors, whose buffers a move keeps but a copy does not
+  schema_subset(const schema_subset &) = delete;
+  schema_subset &operator=(const schema_subset &) = delete;
+  schema_subset(schema_subset &&) noexcept = default;
+  schema_subset &operator=(schema_subset &&) noexcept = default;
+  ~schema_subset() = default;
+
+  // the reduced schema, valid for as long as this object and the compiled schema
+  [[nodiscard]] const json &get() const noexcept { return root_; }
+
+  // how many of the schema's properties were kept
+  [[nodiscard]] std::size_t property_count() const noexcept { return properties_.size(); }
+
+private:
+  void select(const json &schema, std::vector<std::string_view> names)
+  {
+    if (!schema.is_object()) {
+      root_ = schema;
+      return;
+    }
+
+    std::vector<std::string> referenced;
+    bool keep_all = false;
+    find_references(schema, referenced, keep_all);
+    names.insert(names.end(), referenced.begin(), referenced.end());
+    std::sort(names.begin(), names.end());
+
+    members_.assign(schema.object_data().begin(), schema.object_data().end());
+    for (auto &member : members_) {
+      if (member.first != "properties" || !member.second.is_object()) { continue; }
+
+      for (const auto &property : member.second.object_data()) {
+        if (keep_all || std::binary_search(names.begin(), names.end(), property.first)) {
+          properties_.push_back(property);
+        }
+      }
+      member.second = json{ object_t{ properties_.data(), properties_.data() + properties_.size() } };
+    }
+    root_ = json{ object_t{ members_.data(), members_.data() + members_.size() } };
+  }
+
+  // Adds the root properties local `$ref`s in `value` point into to `names`, and
+  // sets `keep_all` if one points at the root or at its `properties`
+  static void find_references(const json &value, std::vector<std::string> &names, bool &keep_all)
+  {
+    if (value.is_array()) {
+      for (const auto &element : value) { find_references(element, names, keep_all); }
+      return;
+    }
+    if (!value.is_object()) { return; }
+
+    for (const auto &member : value.object_data()) {
+      if (member.first == "$ref" && member.second.is_string()) {
+        add_reference(member.second.get<std::string_view>(), names, keep_all);
+      } else {
+        find_references(member.second, names, keep_all);
+      }
+    }
+  }
+
+  static void add_reference(const std::string_view ref, std::vector<std::string> &names, bool &keep_all)
+  {
+    if (ref.empty() || ref.front() != '#') { return; }
+    const auto pointer = unescape(ref.substr(1));
+    constexpr std::string_view prefix = "/properties";
+    if (pointer.empty() || pointer == "/" || pointer == prefix) {
+      keep_all = true;
+      return;
+    }
+    if (pointer.compare(0, prefix.size() + 1, "/properties/") != 0) { return; }
+
+    const auto token = std::string_view{ pointer }.substr(prefix.size() + 1);
+    std::string name;
+    for (std::size_t idx = 0; idx < token.size() && token[idx] != '/'; ++idx) {
+      if (token[idx] == '~' && idx + 1 < token.size() && (token[idx + 1] == '0' || token[idx + 1] == '1')) {
+        name += token[++idx] == '0' ? '~' : '/';
+      } else {
+        name += token[idx];
+      }
+    }
+    names.push_back(std::move(name));
+  }
+
+  // the JSON pointer in a URI fragment, with its %XX escapes decoded
+  static std::string unescape(const std::string_view fragment)
+  {
+    const auto digit = [](const char character) -> int {
+      if (character >= '0' && character <= '9') { return character - '0'; }
+      if (character >= 'a' && character <= 'f') { return character - 'a' + 10; }
+      if (character >= 'A' && character <= 'F') { return character - 'A' + 10; }
+      return -1;
+    };
+    std::string pointer;
+    for (std::size_t idx = 0; idx < fragment.size(); ++idx) {
+      if (fragment[idx] == '%' && idx + 2 < fragment.size() && digit(fragment[idx + 1]) >= 0
+          && digit(fragment[idx + 2]) >= 0) {
+        pointer += static_cast<char>(digit(fragment[idx + 1]) * 16 + digit(fragment[idx + 2]));
+        idx += 2;
+      } else {
+        pointer += fragment[idx];
+      }
+    }
+    return pointer;
+  }
+
+  std::vector<value_pair_t> members_;
+  std::vector<value_pair_t> properties_;
+  json root_{ json::object() };
+};
+
+}// namespace json2cpp
+
+#endif
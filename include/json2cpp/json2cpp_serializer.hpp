@@ -0,0 +1,275 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Writing json2cpp documents back out as minified JSON text, laid out as
+// nlohmann::json::dump() lays it out. Doubles are written with the shortest digits
+// that read back to the same value, which in rare cases is one digit shorter or
+// differs in the last place from nlohmann's grisu2 output.
+//
+// Documents generated with `json2cpp --emit-text` also carry their text and the
+// byte range of every array and object in it; `compiled_json::<name>::dump()`
+// returns those ranges as views through a `text_index`, copying nothing.
+// `json2cpp::serialize` covers every other value, appending to a caller-supplied
+// string whose capacity can be reused from call to call.
+
+#ifndef JSON2CPP_SERIALIZER_HPP_INCLUDED
+#define JSON2CPP_SERIALIZER_HPP_INCLUDED
+
+#include "json2cpp.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace json2cpp {
+
+namespace serializer_detail {
+  inline void append_escaped(std::string &out, const std::string_view text)
+  {
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+    out += '"';
+    std::size_t run = 0;
+    for (std::size_t idx = 0; idx < text.size(); ++idx) {
+      const auto character = static_cast<unsigned char>(text[idx]);
+      if (character >= 0x20 && character != '"' && character != '\\') { continue; }
+
+      out.append(text.data() + run, idx - run);
+      run = idx + 1;
+      switch (character) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\b':
+        out += "\\b";
+        break;
+      case '\f':
+        out += "\\f";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        out += "\\u00";
+        out += hex_digits[character >> 4U];
+        out += hex_digits[character & 0x0FU];
+      }
+    }
+    out.append(text.data() + run, text.size() - run);
+    out += '"';
+  }
+
+  template<typename Integer> void append_integer(std::string &out, const Integer value)
+  {
+    char buffer[24];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.append(std::begin(buffer), result.ptr);
+  }
+
+  // The shortest text that reads back as `value`, laid out like nlohmann::json's
+  // grisu2 output: fixed notation for decimal exponents in (-4, 15], always with a
+  // fraction, and scientific notation with at least two exponent digits otherwise
+  inline void append_double(std::string &out, const double value)
+  {
+    if (!std::isfinite(value)) {
+      out += "null";
+      return;
+    }
+
+    char buffer[32];
+#if defined(__cpp_lib_to_chars)
+    const auto length = static_cast<std::size_t>(
+      std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::scientific).ptr - buffer);
+#else
+    const auto length = static_cast<std::size_t>(std::snprintf(buffer, sizeof(buffer), "%.16e", value));
+#endif
+    std::string_view scientific(buffer, length);
+
+    if (scientific.front() == '-') {
+      out += '-';
+      scientific.remove_prefix(1);
+    }
+    const auto exponent_position = scientific.find('e');
+    int exponent = 0;
+    std::from_chars(scientific.data() + exponent_position + 1 + (scientific[exponent_position + 1] == '+' ? 1 : 0),
+      scientific.data() + scientific.size(),
+      exponent);
+
+    char digits[20];
+    int count = 0;
+    for (const auto character : scientific.substr(0, exponent_position)) {
+      if (character != '.') { digits[count++] = character; }
+    }
+#if !defined(__cpp_lib_to_chars)
+    while (count > 1 && digits[count - 1] == '0') { --count; }
+#endif
+
+    // the decimal point goes after `point` digits
+    const int point = exponent + 1;
+    if (count <= point && point <= 15) {
+      out.append(digits, static_cast<std::size_t>(count));
+      out.append(static_cast<std::size_t>(point - count), '0');
+      out += ".0";
+    } else if (0 < point && point <= 15) {
+      out.append(digits, static_cast<std::size_t>(point));
+      out += '.';
+      out.append(digits + point, static_cast<std::size_t>(count - point));
+    } else if (-4 < point && point <= 0) {
+      out += "0.";
+      out.append(static_cast<std::size_t>(-point), '0');
+      out.append(digits, static_cast<std::size_t>(count));
+    } else {
+      out += digits[0];
+      if (count > 1) {
+        out += '.';
+        out.append(digits + 1, static_cast<std::size_t>(count - 1));
+      }
+      out += exponent < 0 ? "e-" : "e+";
+      const auto magnitude = exponent < 0 ? -exponent : exponent;
+      if (magnitude < 10) { out += '0'; }
+      append_integer(out, magnitude);
+    }
+  }
+}// namespace serializer_detail
+
+// Appends the minified text of `value` to `out`
+inline void serialize(const json &value, std::string &out)
+{
+  if (value.is_object()) {
+    out += '{';
+    bool first = true;
+    for (const auto &member : value.object_data()) {
+      if (!first) { out += ','; }
+      first = false;
+      serializer_detail::append_escaped(out, member.first);
+      out += ':';
+      serialize(member.second, out);
+    }
+    out += '}';
+  } else if (value.is_array()) {
+    out += '[';
+    bool first = true;
+    for (const auto &element : value.array_data()) {
+      if (!first) { out += ','; }
+      first = false;
+      serialize(element, out);
+    }
+    out += ']';
+  } else if (value.is_string()) {
+    serializer_detail::append_escaped(out, value.get<std::string_view>());
+  } else if (value.is_number_unsigned()) {
+    serializer_detail::append_integer(out, value.get<std::uint64_t>());
+  } else if (value.is_number_signed()) {
+    serializer_detail::append_integer(out, value.get<std::int64_t>());
+  } else if (value.is_number_float()) {
+    serializer_detail::append_double(out, value.get<double>());
+  } else if (value.is_boolean()) {
+    out += value.get<bool>() ? "true" : "false";
+  } else {
+    out += "null";
+  }
+}
+
+// The minified text of `value`
+[[nodiscard]] inline std::string serialize(const json &value)
+{
+  std::string out;
+  serialize(value, out);
+  return out;
+}
+
+// Where the text of one array or object lies in a document's minified text,
+// keyed by the address of its first child and its number of children, so a node
+// viewing only some of a compiled container's children does not match it
+struct text_range
+{
+  const void *children;
+  std::size_t size;
+  std::size_t offset;
+  std::size_t length;
+};
+
+// Finds the stored text of arrays and objects from the ranges `json2cpp --emit-text`
+// generates; built once per document, then each lookup is a binary search
+class text_index
+{
+public:
+  template<std::size_t Size>
+  text_index(const std::string_view text, const std::array<text_range, Size> &ranges)
+    : text_{ text }, ranges_(ranges.begin(), ranges.end())
+  {
+    std::sort(ranges_.begin(), ranges_.end(), [](const text_range &lhs, const text_range &rhs) {
+      return std::less<const void *>{}(lhs.children, rhs.children);
+    });
+  }
+
+  // the text of `node`, or an empty view if it is not an array or object of this document
+  [[nodiscard]] std::string_view find(const json &node) const
+  {
+    const void *children = nullptr;
+    if (node.is_object()) {
+      if (node.empty()) { return "{}"; }
+      children = node.object_data().begin();
+    } else if (node.is_array()) {
+      if (node.empty()) { return "[]"; }
+      children = node.array_data().begin();
+    } else {
+      return {};
+    }
+
+    const auto before = [](const text_range &range, const void *key) {
+      return std::less<const void *>{}(range.children, key);
+    };
+    const auto found = std::lower_bound(ranges_.begin(), ranges_.end(), children, before);
+    if (found == ranges_.end() || found->children != children || found->size != node.size()) { return {}; }
+    return text_.substr(found->offset, found->length);
+  }
+
+  // the whole document
+  [[nodiscard]] std::string_view text() const noexcept { return text_; }
+
+private:
+  std::string_view text_;
+  std::vector<text_range> ranges_;
+};
+
+}// namespace json2cpp
+
+#endif
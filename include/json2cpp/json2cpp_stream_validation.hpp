@@ -0,0 +1,285 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Validation driven by the events of a SAX parser, so a document is checked while
+// it is read instead of after it has been loaded into a DOM:
+//
+//   json2cpp::validation::stream_validator<nlohmann::json> handler{
+//     compiled_json::<name>::validator::stream_schema<nlohmann::json>(), options };
+//   nlohmann::json::sax_parse(begin, end, &handler);
+//
+// Objects and arrays whose subschema allows it (see stream_object and
+// stream_array) are checked member by member and never stored. Any other value is
+// collected into a DOM of its own, validated as soon as it is complete and then
+// dropped, so memory use is bounded by the largest such value rather than by the
+// document. Values no subschema looks at are skipped.
+
+#ifndef JSON2CPP_STREAM_VALIDATION_HPP_INCLUDED
+#define JSON2CPP_STREAM_VALIDATION_HPP_INCLUDED
+
+#include "json2cpp_validation.hpp"
+#include <deque>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace json2cpp::validation {
+
+struct stream_options
+{
+  // stop parsing at the first failure
+  bool stop_at_first_error{ false };
+  // called with every failure as soon as it is found
+  std::function<void(const error &)> on_error{};
+};
+
+// A SAX handler for nlohmann::json's sax_parse
+template<typename JSON> class stream_validator
+{
+public:
+  using number_integer_t = typename JSON::number_integer_t;
+  using number_unsigned_t = typename JSON::number_unsigned_t;
+  using number_float_t = typename JSON::number_float_t;
+  using string_t = typename JSON::string_t;
+  using binary_t = typename JSON::binary_t;
+
+  explicit stream_validator(const stream_schema<JSON> &schema, stream_options options = {})
+    : schema_{ schema }, options_{ std::move(options) }
+  {}
+
+  // true once the whole document was read and no check failed
+  [[nodiscard]] bool valid() const noexcept { return complete_ && error_count_ == 0; }
+  [[nodiscard]] std::size_t error_count() const noexcept { return error_count_; }
+
+  bool null() { return scalar(JSON(nullptr)); }
+  bool boolean(const bool value) { return scalar(JSON(value)); }
+  bool number_integer(const number_integer_t value) { return scalar(JSON(value)); }
+  bool number_unsigned(const number_unsigned_t value) { return scalar(JSON(value)); }
+  bool number_float(const number_float_t value, const string_t & /*text*/) { return scalar(JSON(value)); }
+  bool string(string_t &value) { return scalar(JSON(std::move(value))); }
+  bool binary(binary_t &value) { return scalar(JSON::binary(std::move(value))); }
+
+  bool start_object(std::size_t /*size*/) { return start_container(false); }
+  bool start_array(std::size_t /*size*/) { return start_container(true); }
+  bool end_object() { return end_container(); }
+  bool end_array() { return end_container(); }
+
+  bool key(string_t &name)
+  {
+    if (skip_depth_ > 0) { return true; }
+    if (!buffer_stack_.empty()) {
+      buffer_key_ = std::move(name);
+      return true;
+    }
+
+    auto &top = frames_.back();
+    top.key = std::move(name);
+    top.keys.push_back(top.key);
+    top.targets.clear();
+    if (!schema_.nodes[top.function].object->members(top.key, top.targets)) {
+      const path_node member_path{ top.path, std::string_view{ top.key } };
+      report(member_path, "property is not allowed");
+    }
+    return keep_going();
+  }
+
+  template<typename Exception>
+  bool parse_error(const std::size_t position, const std::string & /*token*/, const Exception &exception)
+  {
+    const path_node root{};
+    report(root, "parse error at byte " + std::to_string(position) + ": " + exception.what());
+    return false;
+  }
+
+private:
+  struct frame
+  {
+    path_node path;
+    // the function whose stream tables check this container
+    std::size_t function{ 0 };
+    bool array{ false };
+    std::size_t count{ 0 };
+    // objects: every member name so far, the current one, and its subschemas
+    std::vector<std::string> keys{};
+    std::string key{};
+    std::vector<std::size_t> targets{};
+  };
+
+  // the subschemas of the value that starts now, and its location
+  std::pair<std::vector<std::size_t>, path_node> next_value()
+  {
+    if (frames_.empty()) { return { { schema_.root }, path_node{} }; }
+
+    auto &top = frames_.back();
+    if (!top.array) { return { top.targets, path_node{ top.path, std::string_view{ top.key } } }; }
+
+    const auto index = top.count++;
+    const auto items = schema_.nodes[top.function].array->items;
+    if (items == npos) { return { {}, path_node{ top.path, index } }; }
+    return { { items }, path_node{ top.path, index } };
+  }
+
+  bool scalar(JSON value)
+  {
+    if (skip_depth_ > 0) { return true; }
+    if (!buffer_stack_.empty()) {
+      add_to_buffer(std::move(value));
+      return true;
+    }
+
+    const auto [targets, path] = next_value();
+    for (const auto function : targets) { check(function, value, path); }
+    if (frames_.empty()) { complete_ = true; }
+    return keep_going();
+  }
+
+  bool start_container(const bool array)
+  {
+    if (skip_depth_ > 0) {
+      ++skip_depth_;
+      return true;
+    }
+    if (!buffer_stack_.empty()) {
+      buffer_stack_.push_back(add_to_buffer(JSON(array ? JSON::value_t::array : JSON::value_t::object)));
+      return true;
+    }
+
+    auto [targets, path] = next_value();
+    if (targets.empty()) {
+      skip_depth_ = 1;
+      return true;
+    }
+
+    if (targets.size() == 1) {
+      const auto &node = schema_.nodes[targets.front()];
+      if (array ? node.array != nullptr : node.object != nullptr) {
+        frames_.push_back(frame{ path, targets.front(), array });
+        return true;
+      }
+    }
+
+    buffer_ = JSON(array ? JSON::value_t::array : JSON::value_t::object);
+    buffer_stack_.push_back(&buffer_);
+    buffer_targets_ = std::move(targets);
+    buffer_path_ = path;
+    return true;
+  }
+
+  bool end_container()
+  {
+    if (skip_depth_ > 0) {
+      --skip_depth_;
+      if (skip_depth_ == 0 && frames_.empty()) { complete_ = true; }
+      return true;
+    }
+
+    if (!buffer_stack_.empty()) {
+      buffer_stack_.pop_back();
+      if (!buffer_stack_.empty()) { return true; }
+      for (const auto function : buffer_targets_) { check(function, buffer_, buffer_path_); }
+      buffer_ = JSON();
+    } else {
+      const auto &top = frames_.back();
+      const auto &node = schema_.nodes[top.function];
+      if (top.array) {
+        flush(node.array->count(top.count, ctx_, top.path));
+      } else {
+        flush(node.object->keys(top.keys, ctx_, top.path));
+      }
+      frames_.pop_back();
+    }
+
+    if (frames_.empty()) { complete_ = true; }
+    return keep_going();
+  }
+
+  JSON *add_to_buffer(JSON value)
+  {
+    auto &parent = *buffer_stack_.back();
+    if (parent.is_array()) {
+      parent.push_back(std::move(value));
+      return &parent.back();
+    }
+    auto &member = parent[buffer_key_];
+    member = std::move(value);
+    return &member;
+  }
+
+  void check(const std::size_t function, const JSON &value, const path_node &path)
+  {
+    flush(schema_.nodes[function].validate(value, ctx_, path));
+  }
+
+  void report(const path_node &path, const std::string_view message)
+  {
+    static_cast<void>(ctx_.report(path, message));
+    flush(false);
+  }
+
+  // hands new failures to the callback
+  void flush(const bool passed)
+  {
+    if (passed && errors_.empty()) { return; }
+    for (const auto &failure : errors_) {
+      if (options_.on_error) { options_.on_error(failure); }
+    }
+    error_count_ += std::max<std::size_t>(errors_.size(), passed ? 0 : 1);
+    errors_.clear();
+  }
+
+  [[nodiscard]] bool keep_going() const noexcept { return !options_.stop_at_first_error || error_count_ == 0; }
+
+  const stream_schema<JSON> &schema_;
+  stream_options options_;
+
+  std::vector<error> errors_;
+  context ctx_{ errors_ };
+  std::size_t error_count_{ 0 };
+  bool complete_{ false };
+
+  // containers checked member by member; a deque so paths can point at their parents
+  std::deque<frame> frames_;
+  // nesting depth inside a value nothing checks
+  std::size_t skip_depth_{ 0 };
+  // a value collected for validation as a whole
+  JSON buffer_{};
+  std::vector<JSON *> buffer_stack_;
+  std::string buffer_key_;
+  std::vector<std::size_t> buffer_targets_;
+  path_node buffer_path_{};
+};
+
+// Validates the JSON text in [first, last) while parsing it. Returns true if the
+// text is well formed and valid.
+template<typename JSON, typename Iterator>
+bool validate_stream(const stream_schema<JSON> &schema, Iterator first, Iterator last, stream_options options = {})
+{
+  stream_validator<JSON> handler{ schema, std::move(options) };
+  return JSON::sax_parse(first, last, &handler) && handler.valid();
+}
+
+}// namespace json2cpp::validation
+
+#endif
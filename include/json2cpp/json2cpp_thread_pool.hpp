@@ -0,0 +1,265 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// A small work-stealing thread pool for the tools that validate or walk many
+// documents at once. Each worker owns a deque: it pushes and pops its own tasks
+// at the back and steals from the front of the others when it runs dry. Tasks
+// submitted from outside the pool go through a shared injection queue.
+
+#ifndef JSON2CPP_THREAD_POOL_HPP_INCLUDED
+#define JSON2CPP_THREAD_POOL_HPP_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace json2cpp {
+
+class thread_pool
+{
+public:
+  using task = std::function<void()>;
+
+  static constexpr std::size_t no_worker = std::numeric_limits<std::size_t>::max();
+
+  explicit thread_pool(const std::size_t thread_count = std::thread::hardware_concurrency())
+  {
+    const auto count = std::max<std::size_t>(thread_count, 1);
+    for (std::size_t idx = 0; idx < count; ++idx) { queues_.push_back(std::make_unique<work_queue>()); }
+    threads_.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      threads_.emplace_back([this, idx] { worker_loop(idx); });
+    }
+  }
+
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  thread_pool(thread_pool &&) = delete;
+  thread_pool &operator=(thread_pool &&) = delete;
+
+  // finishes every queued task, then joins the workers
+  ~thread_pool()
+  {
+    {
+      const std::lock_guard lock(sleep_mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto &thread : threads_) { thread.join(); }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return threads_.size(); }
+
+  // Index in [0, size()) of the worker of this pool running the caller, or
+  // `no_worker` for any other thread. Handy for per-thread state.
+  [[nodiscard]] std::size_t current_worker() const noexcept
+  {
+    return current_pool_ == this ? current_index_ : no_worker;
+  }
+
+  // `function` must not throw; use a task_group to get exceptions back
+  void submit(task function)
+  {
+    const auto worker = current_worker();
+    auto &queue = worker == no_worker ? injected_ : *queues_[worker];
+    // counted before it is queued so the count never drops below zero
+    {
+      const std::lock_guard lock(sleep_mutex_);
+      ++pending_;
+    }
+    {
+      const std::lock_guard lock(queue.mutex);
+      queue.tasks.push_back(std::move(function));
+    }
+    wake_.notify_one();
+  }
+
+  // Runs one queued task on the calling thread. Returns false if there was none.
+  bool run_pending_task()
+  {
+    auto function = find_task(current_worker());
+    if (!function) { return false; }
+    (*function)();
+    return true;
+  }
+
+private:
+  struct work_queue
+  {
+    std::mutex mutex;
+    std::deque<task> tasks;
+
+    std::optional<task> pop_back()
+    {
+      const std::lock_guard lock(mutex);
+      if (tasks.empty()) { return std::nullopt; }
+      auto function = std::move(tasks.back());
+      tasks.pop_back();
+      return function;
+    }
+
+    std::optional<task> pop_front()
+    {
+      const std::lock_guard lock(mutex);
+      if (tasks.empty()) { return std::nullopt; }
+      auto function = std::move(tasks.front());
+      tasks.pop_front();
+      return function;
+    }
+  };
+
+  std::optional<task> find_task(const std::size_t worker)
+  {
+    if (pending_.load(std::memory_order_acquire) == 0) { return std::nullopt; }
+
+    std::optional<task> function;
+    // newest own work first (it is likely still in cache), then outside work,
+    // then the oldest work of the other workers
+    if (worker != no_worker) { function = queues_[worker]->pop_back(); }
+    if (!function) { function = injected_.pop_front(); }
+    for (std::size_t offset = 1; !function && offset <= queues_.size(); ++offset) {
+      const auto victim = worker == no_worker ? offset - 1 : (worker + offset) % queues_.size();
+      if (victim != worker) { function = queues_[victim]->pop_front(); }
+    }
+
+    if (function) { pending_.fetch_sub(1, std::memory_order_acq_rel); }
+    return function;
+  }
+
+  void worker_loop(const std::size_t index)
+  {
+    current_pool_ = this;
+    current_index_ = index;
+
+    while (true) {
+      if (auto function = find_task(index)) {
+        (*function)();
+        continue;
+      }
+
+      std::unique_lock lock(sleep_mutex_);
+      wake_.wait(lock, [&] { return stopping_ || pending_.load(std::memory_order_acquire) != 0; });
+      if (stopping_ && pending_.load(std::memory_order_acquire) == 0) { return; }
+    }
+  }
+
+  static inline thread_local const thread_pool *current_pool_ = nullptr;
+  static inline thread_local std::size_t current_index_ = no_worker;
+
+  std::vector<std::unique_ptr<work_queue>> queues_;
+  work_queue injected_;
+  std::atomic<std::size_t> pending_{ 0 };
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_{ false };
+
+  std::vector<std::thread> threads_;
+};
+
+// A set of tasks run on a thread_pool that can be waited for together. Tasks may
+// add more tasks to the same group, and waiting from inside a worker is fine:
+// the waiting thread runs queued tasks instead of blocking.
+class task_group
+{
+public:
+  explicit task_group(thread_pool &pool) : pool_{ pool } {}
+
+  task_group(const task_group &) = delete;
+  task_group &operator=(const task_group &) = delete;
+  task_group(task_group &&) = delete;
+  task_group &operator=(task_group &&) = delete;
+
+  ~task_group()
+  {
+    try {
+      wait();
+    } catch (...) {
+      // already reported by an explicit wait(), or nobody is interested
+    }
+  }
+
+  template<typename Function> void run(Function &&function)
+  {
+    {
+      const std::lock_guard lock(mutex_);
+      ++outstanding_;
+    }
+    pool_.submit([this, function = std::forward<Function>(function)]() mutable {
+      std::exception_ptr failure;
+      try {
+        function();
+      } catch (...) {
+        failure = std::current_exception();
+      }
+
+      // the waiting thread may destroy the group as soon as it sees zero, so the
+      // count only changes under the lock that wait() takes last
+      const std::lock_guard lock(mutex_);
+      if (failure && !exception_) { exception_ = failure; }
+      if (--outstanding_ == 0) { done_.notify_all(); }
+    });
+  }
+
+  // Waits for every task run so far and rethrows the first exception one of them threw
+  void wait()
+  {
+    std::unique_lock lock(mutex_);
+    while (outstanding_ != 0) {
+      lock.unlock();
+      const bool ran = pool_.run_pending_task();
+      lock.lock();
+      // nothing to help with: sleep until done, looking again now and then for
+      // stealable work spawned by the tasks still running
+      if (!ran) {
+        done_.wait_for(lock, std::chrono::microseconds{ 200 }, [&] { return outstanding_ == 0; });
+      }
+    }
+
+    if (exception_) { std::rethrow_exception(std::exchange(exception_, nullptr)); }
+  }
+
+private:
+  thread_pool &pool_;
+  std::mutex mutex_;
+  std::condition_variable done_;
+  std::size_t outstanding_{ 0 };
+  std::exception_ptr exception_;
+};
+
+}// namespace json2cpp
+
+#endif
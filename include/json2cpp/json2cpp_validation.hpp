@@ -0,0 +1,652 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Runtime support for the validators that `json2cpp --validator` generates from a
+// JSON Schema. The generated functions are templates over the document type and
+// only use the API that json2cpp::json and nlohmann::json have in common, plus the
+// helpers in this file.
+
+#ifndef JSON2CPP_VALIDATION_HPP_INCLUDED
+#define JSON2CPP_VALIDATION_HPP_INCLUDED
+
+#include "json2cpp_hash_detail.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace json2cpp {
+template<typename CharType> struct basic_json;
+}// namespace json2cpp
+
+namespace json2cpp::validation {
+
+// One step of the location being validated. Nodes live on the stack of the
+// generated functions and link to their parent, so a path costs nothing until
+// an error has to be reported.
+struct path_node
+{
+  const path_node *parent{ nullptr };
+  std::string_view key{};
+  std::size_t index{ 0 };
+  bool is_index{ false };
+
+  constexpr path_node() = default;
+  constexpr path_node(const path_node &parent_node, const std::string_view member_key)
+    : parent{ &parent_node }, key{ member_key }
+  {}
+  constexpr path_node(const path_node &parent_node, const std::size_t element_index)
+    : parent{ &parent_node }, index{ element_index }, is_index{ true }
+  {}
+
+  // the location as a JSON Pointer (RFC 6901), "" for the document root
+  [[nodiscard]] std::string pointer() const
+  {
+    std::vector<const path_node *> nodes;
+    for (const auto *node = this; node->parent != nullptr; node = node->parent) { nodes.push_back(node); }
+
+    std::string result;
+    for (auto itr = nodes.rbegin(); itr != nodes.rend(); ++itr) {
+      result += '/';
+      if ((*itr)->is_index) {
+        result += std::to_string((*itr)->index);
+        continue;
+      }
+      for (const auto character : (*itr)->key) {
+        if (character == '~') {
+          result += "~0";
+        } else if (character == '/') {
+          result += "~1";
+        } else {
+          result += character;
+        }
+      }
+    }
+    return result;
+  }
+};
+
+struct error
+{
+  std::string path;
+  std::string message;
+};
+
+// Runs the member and element checks of large objects and arrays concurrently.
+// Validation itself has no threads; json2cpp_parallel_validation.hpp provides an
+// executor backed by json2cpp::thread_pool.
+class executor
+{
+public:
+  executor() = default;
+  executor(const executor &) = default;
+  executor &operator=(const executor &) = default;
+  executor(executor &&) = default;
+  executor &operator=(executor &&) = default;
+
+  // objects and arrays with fewer members are checked on the calling thread
+  std::size_t grain{ 32 };
+
+  // Calls task(0) ... task(count - 1), possibly concurrently, and returns once all have finished
+  virtual void run(std::size_t count, const std::function<void(std::size_t)> &task) = 0;
+
+protected:
+  ~executor() = default;
+};
+
+class memo;
+class subtree_hashes;
+
+// Decides what happens when a check fails. A default constructed context stops at
+// the first failure, which is all that is needed to answer "is this valid?". A
+// context constructed with an error list records every failure and lets
+// validation continue. Either kind can be given an executor to check large
+// containers in parallel, and a memo to skip subtrees it has already seen.
+class context
+{
+public:
+  constexpr context() = default;
+  explicit context(std::vector<error> &errors) : errors_{ &errors } {}
+  explicit context(executor &parallel) : executor_{ &parallel } {}
+  context(std::vector<error> &errors, executor &parallel) : errors_{ &errors }, executor_{ &parallel } {}
+
+  [[nodiscard]] constexpr bool collecting() const noexcept { return errors_ != nullptr; }
+  [[nodiscard]] constexpr executor *parallel() const noexcept { return executor_; }
+
+  // Remembers in `results` which subschemas the subtrees indexed by `hashes` pass;
+  // `hashes` must have been built for `results`, or nothing is remembered
+  context &use_memo(memo &results, const subtree_hashes &hashes) noexcept
+  {
+    memo_ = &results;
+    hashes_ = &hashes;
+    return *this;
+  }
+
+  [[nodiscard]] constexpr memo *memo_results() const noexcept { return memo_; }
+  [[nodiscard]] constexpr const subtree_hashes *memo_hashes() const noexcept { return hashes_; }
+
+  // Records a failure at `path`; returns true if validation should continue
+  bool report(const path_node &path, const std::string_view message)
+  {
+    if (errors_ == nullptr) { return false; }
+    errors_->push_back(error{ path.pointer(), std::string{ message } });
+    return true;
+  }
+
+  // Appends failures recorded by another context
+  void merge(std::vector<error> &errors)
+  {
+    if (errors_ == nullptr) { return; }
+    errors_->insert(errors_->end(), std::make_move_iterator(errors.begin()), std::make_move_iterator(errors.end()));
+  }
+
+  // A context for checks whose failures are not errors in themselves, such as
+  // the branches of anyOf, oneOf and not
+  [[nodiscard]] context speculative() const noexcept
+  {
+    context result{ *this };
+    result.errors_ = nullptr;
+    return result;
+  }
+
+  // The same settings, recording failures in `errors` if this context records any
+  [[nodiscard]] context reporting_to(std::vector<error> &errors) const noexcept
+  {
+    context result{ *this };
+    if (collecting()) { result.errors_ = &errors; }
+    return result;
+  }
+
+private:
+  std::vector<error> *errors_{ nullptr };
+  executor *executor_{ nullptr };
+  memo *memo_{ nullptr };
+  const subtree_hashes *hashes_{ nullptr };
+};
+
+// The subschema checks of the members or elements of one object or array. They run
+// immediately unless the context has an executor and the container is at least
+// its grain in size; then run() queues them and finish() runs them concurrently,
+// each with its own error list. The lists are appended to the context in the
+// order the checks were queued, so the errors do not depend on scheduling.
+class deferred_checks
+{
+public:
+  deferred_checks(context &ctx, const std::size_t size)
+    : ctx_{ ctx }, parallel_{ ctx.parallel() != nullptr && size >= ctx.parallel()->grain }
+  {}
+
+  // `check(ctx, path)` validates one member; returns false if it failed (always
+  // true while the check is only queued)
+  template<typename Check> bool run(const path_node &path, Check &&check)
+  {
+    if (!parallel_) { return check(ctx_, path); }
+    pending_.emplace_back(
+      [check = std::forward<Check>(check), path](context &task_ctx) { return check(task_ctx, path); });
+    return true;
+  }
+
+  // Runs the queued checks; returns false if any failed. The paths they were
+  // given must still be alive.
+  bool finish()
+  {
+    if (pending_.empty()) { return true; }
+
+    auto &parallel = *ctx_.parallel();
+    const bool collecting = ctx_.collecting();
+    std::vector<std::vector<error>> errors(pending_.size());
+    std::atomic<bool> failed{ false };
+
+    parallel.run(pending_.size(), [&](const std::size_t idx) {
+      // without an error list the first failure decides the result
+      if (!collecting && failed.load(std::memory_order_relaxed)) { return; }
+      auto task_ctx = ctx_.reporting_to(errors[idx]);
+      if (!pending_[idx](task_ctx)) { failed.store(true, std::memory_order_relaxed); }
+    });
+
+    for (auto &list : errors) { ctx_.merge(list); }
+    pending_.clear();
+    return !failed.load();
+  }
+
+private:
+  context &ctx_;
+  bool parallel_;
+  std::vector<std::function<bool(context &)>> pending_;
+};
+
+namespace detail {
+  template<typename JSON> struct is_compiled : std::false_type
+  {
+  };
+
+  template<typename CharType> struct is_compiled<basic_json<CharType>> : std::true_type
+  {
+  };
+}// namespace detail
+
+// The string held by `value`, which must be a string
+template<typename JSON> [[nodiscard]] constexpr std::string_view string_of(const JSON &value)
+{
+  return hash_detail::string_of(value);
+}
+
+// The number held by `value`, which must be a number
+template<typename JSON> [[nodiscard]] constexpr double number_of(const JSON &value)
+{
+  return value.template get<double>();
+}
+
+// Number of code points in a UTF-8 string, which is what minLength and maxLength count
+[[nodiscard]] constexpr std::size_t utf8_length(const std::string_view string) noexcept
+{
+  std::size_t length = 0;
+  for (const auto character : string) {
+    if ((static_cast<unsigned char>(character) & 0xC0U) != 0x80U) { ++length; }
+  }
+  return length;
+}
+
+// Integers compare exactly, everything else as doubles
+template<typename JSON> [[nodiscard]] constexpr bool number_equals(const JSON &value, const std::int64_t expected)
+{
+  if (value.is_number_unsigned()) {
+    return expected >= 0 && value.template get<std::uint64_t>() == static_cast<std::uint64_t>(expected);
+  }
+  if (value.is_number_integer()) { return value.template get<std::int64_t>() == expected; }
+  return value.is_number() && value.template get<double>() == static_cast<double>(expected);
+}
+
+template<typename JSON> [[nodiscard]] constexpr bool number_equals(const JSON &value, const double expected)
+{
+  return value.is_number() && value.template get<double>() == expected;
+}
+
+template<typename JSON> [[nodiscard]] constexpr bool string_equals(const JSON &value, const std::string_view expected)
+{
+  return value.is_string() && string_of(value) == expected;
+}
+
+[[nodiscard]] inline bool is_multiple_of(const double value, const double divisor)
+{
+  const auto quotient = value / divisor;
+  if (!std::isfinite(quotient)) { return false; }
+  return std::abs(quotient - std::round(quotient)) <= std::abs(quotient) * 1e-12 + 1e-12;
+}
+
+// The member `key` of `object`, or nullptr
+template<typename JSON> [[nodiscard]] constexpr const JSON *find_member(const JSON &object, const std::string_view key)
+{
+  for (auto itr = object.begin(); itr != object.end(); ++itr) {
+    if (std::string_view{ itr.key() } == key) { return &itr.value(); }
+  }
+  return nullptr;
+}
+
+// Structural equality as JSON Schema defines it, used by uniqueItems. json2cpp's
+// operator== compares that way already; nlohmann's converts unsigned numbers to
+// signed ones first, so its values are compared here.
+template<typename JSON> [[nodiscard]] constexpr bool json_equal(const JSON &lhs, const JSON &rhs)
+{
+  if constexpr (detail::is_compiled<JSON>::value) { return lhs == rhs; }
+
+  if (lhs.is_number() && rhs.is_number()) {
+    if (lhs.is_number_float() || rhs.is_number_float()) {
+      return lhs.template get<double>() == rhs.template get<double>();
+    }
+    if (lhs.is_number_unsigned() || rhs.is_number_unsigned()) {
+      return lhs.template get<std::uint64_t>() == rhs.template get<std::uint64_t>()
+             && (lhs.is_number_unsigned() || lhs.template get<std::int64_t>() >= 0)
+             && (rhs.is_number_unsigned() || rhs.template get<std::int64_t>() >= 0);
+    }
+    return lhs.template get<std::int64_t>() == rhs.template get<std::int64_t>();
+  }
+  if (lhs.is_null() || rhs.is_null()) { return lhs.is_null() && rhs.is_null(); }
+  if (lhs.is_boolean() || rhs.is_boolean()) {
+    return lhs.is_boolean() && rhs.is_boolean() && lhs.template get<bool>() == rhs.template get<bool>();
+  }
+  if (lhs.is_string() || rhs.is_string()) {
+    return lhs.is_string() && rhs.is_string() && string_of(lhs) == string_of(rhs);
+  }
+  if (lhs.is_array() && rhs.is_array()) {
+    if (lhs.size() != rhs.size()) { return false; }
+    for (auto litr = lhs.begin(), ritr = rhs.begin(); litr != lhs.end(); ++litr, ++ritr) {
+      if (!json_equal(*litr, *ritr)) { return false; }
+    }
+    return true;
+  }
+  if (lhs.is_object() && rhs.is_object()) {
+    if (lhs.size() != rhs.size()) { return false; }
+    for (auto itr = lhs.begin(); itr != lhs.end(); ++itr) {
+      const auto *other = find_member(rhs, itr.key());
+      if (other == nullptr || !json_equal(itr.value(), *other)) { return false; }
+    }
+    return true;
+  }
+  return false;
+}
+
+template<typename JSON> [[nodiscard]] constexpr bool has_unique_items(const JSON &array)
+{
+  for (auto outer = array.begin(); outer != array.end(); ++outer) {
+    auto inner = outer;
+    for (++inner; inner != array.end(); ++inner) {
+      if (json_equal(*outer, *inner)) { return false; }
+    }
+  }
+  return true;
+}
+
+namespace detail {
+  // a hash already masked to a table's size as an index into it; only narrows
+  // where std::size_t is narrower than std::uint64_t
+  template<typename Unsigned> [[nodiscard]] constexpr std::size_t to_index(const Unsigned masked) noexcept
+  {
+    if constexpr (std::is_same_v<Unsigned, std::size_t>) {
+      return masked;
+    } else {
+      return static_cast<std::size_t>(masked);
+    }
+  }
+}// namespace detail
+
+// Remembered results of validation functions for subtree hashes, shared by any
+// number of documents and threads. Each entry is a single atomic word in a
+// table whose size is fixed when it is constructed, so memory stays bounded:
+// a result simply replaces whatever older result hashed to the same slot.
+//
+// A hit is not confirmed by comparing subtrees: two subtrees whose hashes and
+// function agree share a result. The hashes are keyed with a seed drawn when the
+// memo is constructed, so a document cannot be built to collide with another;
+// what remains is the chance that two different subtrees meet on the 63 bits of
+// an entry's tag, which a program checking untrusted input has to accept or
+// validate without a memo.
+class memo
+{
+public:
+  enum class outcome { unknown, valid, invalid };
+
+  struct statistics
+  {
+    std::uint64_t lookups{ 0 };
+    std::uint64_t hits{ 0 };
+
+    [[nodiscard]] double hit_rate() const noexcept
+    {
+      return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+    }
+  };
+
+  // `capacity` is rounded up to a power of two; each entry takes 8 bytes
+  explicit memo(const std::size_t capacity = std::size_t{ 1 } << 16U)
+    : slots_(round_up(capacity)), seed_{ random_seed() }
+  {
+    for (auto &slot : slots_) { slot.store(0, std::memory_order_relaxed); }
+  }
+
+  // What `function` returned for the subtree with `hash`. A context collecting
+  // errors has to run failed checks again to report them, so with `valid_only`
+  // a remembered failure counts as unknown.
+  [[nodiscard]] outcome find(const std::size_t function, const std::uint64_t hash, const bool valid_only)
+  {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    const auto tag = key(function, hash);
+    const auto entry = slots_[slot(tag)].load(std::memory_order_relaxed);
+    if ((entry & ~std::uint64_t{ 1 }) != tag) { return outcome::unknown; }
+    const bool valid = (entry & 1U) != 0;
+    if (!valid && valid_only) { return outcome::unknown; }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return valid ? outcome::valid : outcome::invalid;
+  }
+
+  void store(const std::size_t function, const std::uint64_t hash, const bool valid)
+  {
+    const auto tag = key(function, hash);
+    slots_[slot(tag)].store(tag | (valid ? 1U : 0U), std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] statistics stats() const noexcept
+  {
+    return { lookups_.load(std::memory_order_relaxed), hits_.load(std::memory_order_relaxed) };
+  }
+
+  [[nodiscard]] std::size_t capacity() const noexcept { return slots_.size(); }
+
+  // the key of the subtree_hashes this memo's results are remembered for
+  [[nodiscard]] std::uint64_t seed() const noexcept { return seed_; }
+
+private:
+  // random_device may be deterministic on some platforms; the clock still
+  // makes the seed differ from run to run there
+  static std::uint64_t random_seed()
+  {
+    std::random_device device;
+    const auto drawn = (std::uint64_t{ device() } << 32U) ^ std::uint64_t{ device() };
+    const auto now = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    return hash_detail::mix(drawn ^ hash_detail::mix(now)) | 1U;
+  }
+
+  static std::size_t round_up(const std::size_t capacity)
+  {
+    std::size_t size = 1;
+    while (size < capacity) { size <<= 1U; }
+    return size;
+  }
+
+  // the entry for (function, hash) without its result bit; never 0, which marks an empty slot
+  [[nodiscard]] static std::uint64_t key(const std::size_t function, const std::uint64_t hash) noexcept
+  {
+    const auto tag =
+      hash_detail::mix(hash ^ hash_detail::mix(static_cast<std::uint64_t>(function) + 1U)) & ~std::uint64_t{ 1 };
+    return tag == 0 ? 2 : tag;
+  }
+
+  [[nodiscard]] std::size_t slot(const std::uint64_t tag) const noexcept
+  {
+    return detail::to_index((tag >> 1U) & (slots_.size() - 1U));
+  }
+
+  std::vector<std::atomic<std::uint64_t>> slots_;
+  std::uint64_t seed_;
+  std::atomic<std::uint64_t> lookups_{ 0 };
+  std::atomic<std::uint64_t> hits_{ 0 };
+};
+
+// Content hashes of the objects and arrays of one document, keyed by address.
+// Each container combines the hashes of its members, so building the index
+// hashes every value once. Equal subtrees hash alike wherever they appear, and
+// object members are combined without regard to their order, as json_equal
+// compares them. The hashes are keyed with the seed of the memo they are built
+// for, and are only meaningful to that memo. A compiled document never changes,
+// so its index can be built once and kept for as long as the program runs.
+class subtree_hashes
+{
+public:
+  subtree_hashes() = default;
+  template<typename JSON> subtree_hashes(const JSON &document, const memo &results) : seed_{ results.seed() }
+  {
+    add(document);
+  }
+
+  // the hash of the object or array at `value`, 0 if it is not in the index
+  [[nodiscard]] std::uint64_t find(const void *value) const noexcept
+  {
+    if (entries_.empty()) { return 0; }
+    for (auto idx = position(value);; idx = (idx + 1) & (entries_.size() - 1)) {
+      const auto &candidate = entries_[idx];
+      if (candidate.value == value) { return candidate.hash; }
+      if (candidate.value == nullptr) { return 0; }
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  // the seed of the memo the hashes were built for, 0 if none
+  [[nodiscard]] std::uint64_t seed() const noexcept { return seed_; }
+
+private:
+  // an open addressing table keyed by address: one allocation for the whole
+  // document instead of one per container
+  struct entry
+  {
+    const void *value{ nullptr };
+    std::uint64_t hash{ 0 };
+  };
+
+  [[nodiscard]] std::size_t position(const void *value) const noexcept
+  {
+    return detail::to_index(hash_detail::mix(reinterpret_cast<std::uintptr_t>(value)) & (entries_.size() - 1U));
+  }
+
+  void insert(const void *value, const std::uint64_t hash)
+  {
+    // kept at most half full so probe sequences stay short
+    if (2 * (size_ + 1) > entries_.size()) {
+      auto previous = std::move(entries_);
+      entries_.assign(std::max<std::size_t>(previous.size() * 2, 64), entry{});
+      for (const auto &moved : previous) {
+        if (moved.value != nullptr) { place(moved); }
+      }
+    }
+    place(entry{ value, hash });
+    ++size_;
+  }
+
+  void place(const entry &added) noexcept
+  {
+    auto idx = position(added.value);
+    while (entries_[idx].value != nullptr) { idx = (idx + 1) & (entries_.size() - 1); }
+    entries_[idx] = added;
+  }
+
+  template<typename JSON> void add(const JSON &document)
+  {
+    // doubles hash by representation: 1 and 1.0 validate differently against
+    // "integer", so their hashes differ too
+    auto index = [this](const JSON &subtree, std::uint64_t hash) {
+      // 0 means "not indexed"
+      insert(&subtree, hash == 0 ? 1 : hash);
+    };
+    static_cast<void>(hash_detail::hash_tree<hash_detail::doubles::by_representation>(document, index, seed_));
+  }
+
+  std::vector<entry> entries_;
+  std::size_t size_{ 0 };
+  std::uint64_t seed_{ 0 };
+};
+
+// Runs `check()`, the checks of validation function `function` on `value`,
+// unless the context's memo already knows their result for an equal subtree
+template<typename JSON, typename Check>
+[[nodiscard]] bool memoized(const context &ctx, const std::size_t function, const JSON &value, Check &&check)
+{
+  auto *results = ctx.memo_results();
+  if (results == nullptr || !value.is_structured()) { return check(); }
+  const auto *hashes = ctx.memo_hashes();
+  // hashes keyed for another memo would look up unrelated entries
+  if (hashes->seed() != results->seed()) { return check(); }
+  const auto hash = hashes->find(&value);
+  if (hash == 0) { return check(); }
+
+  switch (results->find(function, hash, ctx.collecting())) {
+  case memo::outcome::valid:
+    return true;
+  case memo::outcome::invalid:
+    return false;
+  case memo::outcome::unknown:
+    break;
+  }
+
+  const bool valid = check();
+  results->store(function, hash, valid);
+  return valid;
+}
+
+inline constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+// Position of `key` in the sorted `keys`, or npos. The generated validators use
+// this to dispatch object members to the property they belong to.
+template<std::size_t Size>
+[[nodiscard]] inline std::size_t find_key(const std::array<std::string_view, Size> &keys, const std::string_view key)
+{
+  const auto found = std::lower_bound(keys.begin(), keys.end(), key);
+  if (found == keys.end() || *found != key) { return npos; }
+  return static_cast<std::size_t>(std::distance(keys.begin(), found));
+}
+
+// Whether `key` is one of the member names seen in a streamed object
+[[nodiscard]] inline bool contains_key(const std::vector<std::string> &keys, const std::string_view key)
+{
+  return std::find(keys.begin(), keys.end(), key) != keys.end();
+}
+
+// Tables generated next to each validator so that stream_validator
+// (json2cpp_stream_validation.hpp) can check objects and arrays while they are
+// parsed instead of after they have been loaded.
+
+// An object subschema whose checks need only the member names and the members
+struct stream_object
+{
+  // Appends the functions validating member `key`; returns false if `key` is not allowed
+  bool (*members)(std::string_view key, std::vector<std::size_t> &targets);
+  // The checks that need every member name: required, member counts, dependencies
+  bool (*keys)(const std::vector<std::string> &keys, context &ctx, const path_node &path);
+};
+
+// An array subschema whose checks need only the elements and their count
+struct stream_array
+{
+  // the function validating each element, or npos
+  std::size_t items;
+  bool (*count)(std::size_t count, context &ctx, const path_node &path);
+};
+
+template<typename JSON> struct stream_node
+{
+  // validates a whole value
+  bool (*validate)(const JSON &value, context &ctx, const path_node &path);
+  // set if objects can be validated member by member
+  const stream_object *object;
+  // set if arrays can be validated element by element
+  const stream_array *array;
+};
+
+// One node per validation function; `root` validates the whole document
+template<typename JSON> struct stream_schema
+{
+  std::size_t root;
+  std::vector<stream_node<JSON>> nodes;
+};
+
+}// namespace json2cpp::validation
+
+#endif
@@ -0,0 +1,208 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "document_selection.hpp"
+#include <cstddef>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace {
+
+struct pattern
+{
+  std::string text;
+  std::vector<std::string> tokens;
+  bool matched{ false };
+};
+
+pattern parse_pattern(const std::string &text)
+{
+  if (!text.empty() && text.front() != '/') {
+    throw std::runtime_error(fmt::format("'{}' is not a JSON pointer", text));
+  }
+
+  pattern result{ text, {} };
+  for (std::size_t idx = 0; idx < text.size(); ++idx) {
+    if (text[idx] == '/') {
+      result.tokens.emplace_back();
+    } else if (text[idx] == '~') {
+      if (idx + 1 == text.size() || (text[idx + 1] != '0' && text[idx + 1] != '1')) {
+        throw std::runtime_error(fmt::format("'{}' has an invalid escape", text));
+      }
+      result.tokens.back() += text[++idx] == '0' ? '~' : '/';
+    } else {
+      result.tokens.back() += text[idx];
+    }
+  }
+  return result;
+}
+
+// '*' in `glob` matches any run of characters, everything else itself
+bool glob_match(const std::string_view glob, const std::string_view text)
+{
+  std::size_t glob_pos = 0;
+  std::size_t text_pos = 0;
+  // where the last '*' was, and where in `text` its match currently ends
+  std::size_t star = std::string_view::npos;
+  std::size_t star_end = 0;
+
+  while (text_pos < text.size()) {
+    if (glob_pos < glob.size() && glob[glob_pos] == '*') {
+      star = glob_pos++;
+      star_end = text_pos;
+    } else if (glob_pos < glob.size() && glob[glob_pos] == text[text_pos]) {
+      ++glob_pos;
+      ++text_pos;
+    } else if (star != std::string_view::npos) {
+      glob_pos = star + 1;
+      text_pos = ++star_end;
+    } else {
+      return false;
+    }
+  }
+  while (glob_pos < glob.size() && glob[glob_pos] == '*') { ++glob_pos; }
+  return glob_pos == glob.size();
+}
+
+class selector
+{
+public:
+  selector(const std::vector<std::string> &include, const std::vector<std::string> &exclude)
+  {
+    for (const auto &text : include) { include_.push_back(parse_pattern(text)); }
+    for (const auto &text : exclude) { exclude_.push_back(parse_pattern(text)); }
+  }
+
+  std::optional<nlohmann::json> select(const nlohmann::json &document)
+  {
+    std::vector<pattern *> includes;
+    std::vector<pattern *> excludes;
+    for (auto &include : include_) { includes.push_back(&include); }
+    for (auto &exclude : exclude_) { excludes.push_back(&exclude); }
+    return select(document, 0, include_.empty(), includes, excludes);
+  }
+
+  void report_unmatched() const
+  {
+    for (const auto &include : include_) {
+      if (!include.matched) { spdlog::warn("--include '{}' matches nothing in the document", include.text); }
+    }
+    for (const auto &exclude : exclude_) {
+      if (!exclude.matched) { spdlog::warn("--exclude '{}' matches nothing in the document", exclude.text); }
+    }
+  }
+
+private:
+  // `includes` and `excludes` are the patterns whose first `depth` tokens match the
+  // path to `value`; `included` is whether an include pattern matched an ancestor
+  std::optional<nlohmann::json> select(const nlohmann::json &value,
+    const std::size_t depth,
+    bool included,
+    const std::vector<pattern *> &includes,
+    const std::vector<pattern *> &excludes)
+  {
+    if (ends_here(excludes, depth)) { return std::nullopt; }
+    if (ends_here(includes, depth)) { included = true; }
+    if (!value.is_structured()) {
+      if (included) { return value; }
+      return std::nullopt;
+    }
+
+    const auto child = [&](const std::string &token, const nlohmann::json &child_value) {
+      const auto child_includes = included ? std::vector<pattern *>{} : continuing(includes, depth, token);
+      if (!included && child_includes.empty()) { return std::optional<nlohmann::json>{}; }
+      return select(child_value, depth + 1, included, child_includes, continuing(excludes, depth, token));
+    };
+
+    if (value.is_object()) {
+      auto result = nlohmann::json::object();
+      for (const auto &[key, member] : value.items()) {
+        if (auto selected = child(key, member); selected) { result[key] = std::move(*selected); }
+      }
+      if (!included && result.empty()) { return std::nullopt; }
+      return result;
+    }
+
+    std::vector<std::optional<nlohmann::json>> elements;
+    for (std::size_t idx = 0; idx < value.size(); ++idx) { elements.push_back(child(std::to_string(idx), value[idx])); }
+    while (!elements.empty() && !elements.back()) { elements.pop_back(); }
+    if (!included && elements.empty()) { return std::nullopt; }
+
+    auto result = nlohmann::json::array();
+    for (auto &element : elements) { result.push_back(element ? std::move(*element) : nlohmann::json{}); }
+    return result;
+  }
+
+  static bool ends_here(const std::vector<pattern *> &patterns, const std::size_t depth)
+  {
+    bool any = false;
+    for (auto *candidate : patterns) {
+      if (candidate->tokens.size() == depth) {
+        candidate->matched = true;
+        any = true;
+      }
+    }
+    return any;
+  }
+
+  static std::vector<pattern *>
+    continuing(const std::vector<pattern *> &patterns, const std::size_t depth, const std::string &token)
+  {
+    std::vector<pattern *> result;
+    for (auto *candidate : patterns) {
+      if (candidate->tokens.size() > depth && glob_match(candidate->tokens[depth], token)) {
+        result.push_back(candidate);
+      }
+    }
+    return result;
+  }
+
+  std::vector<pattern> include_;
+  std::vector<pattern> exclude_;
+};
+
+std::size_t count_values(const nlohmann::json &value)
+{
+  std::size_t count = 1;
+  if (value.is_structured()) {
+    for (const auto &child : value) { count += count_values(child); }
+  }
+  return count;
+}
+
+}// namespace
+
+nlohmann::json select_subtrees(const nlohmann::json &document,
+  const std::vector<std::string> &include,
+  const std::vector<std::string> &exclude)
+{
+  selector subset{ include, exclude };
+  auto selected = subset.select(document);
+  subset.report_unmatched();
+  if (!selected) { throw std::runtime_error("--include and --exclude leave nothing of the document"); }
+
+  spdlog::info("Selected {} of {} JSON values", count_values(*selected), count_values(document));
+  return std::move(*selected);
+}
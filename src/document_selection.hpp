@@ -0,0 +1,46 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSON2CPP_DOCUMENT_SELECTION_HPP
+#define JSON2CPP_DOCUMENT_SELECTION_HPP
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+// The part of `document` selected by `include` and `exclude`, lists of JSON pointers
+// in which a '*' in a reference token matches any run of characters, so "/a/*"
+// matches every member of "/a" and "/a/b*" every member whose key starts with "b".
+//
+// With no `include` patterns the whole document is selected, otherwise the subtrees
+// they match and the members and elements leading to them. Then the subtrees
+// `exclude` matches are removed. Objects keep the selected members under the same
+// keys; arrays keep their elements at the same indexes, holding null in place of
+// those that were not selected, up to the last one that was. Patterns that match
+// nothing are reported, and selecting nothing at all is an error.
+nlohmann::json select_subtrees(const nlohmann::json &document,
+  const std::vector<std::string> &include,
+  const std::vector<std::string> &exclude);
+
+#endif
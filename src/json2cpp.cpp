@@ -24,23 +24,301 @@ SOFTWARE.
 
 
 #include "json2cpp.hpp"
+#include "document_selection.hpp"
+#include "profile_layout.hpp"
+#include "schema_compiler.hpp"
+#include "schema_defaults.hpp"
+#include <cctype>
 #include <fstream>
+#include <json2cpp/json2cpp_compressed.hpp>
+#include <json2cpp/json2cpp_hash.hpp>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+// mirrors `json2cpp::basic_json::size()`
+std::size_t node_size(const nlohmann::json &value)
+{
+  if (value.is_null()) { return 0; }
+  if (value.is_structured()) { return value.size(); }
+  return 1;
+}
+
+// The members of the object `value` in the order they are emitted: as `layout`
+// orders them if it covers the object, otherwise sorted by key
+std::vector<nlohmann::json::const_iterator> ordered_members(const nlohmann::json &value,
+  const document_layout *layout)
+{
+  std::vector<nlohmann::json::const_iterator> members;
+  if (layout != nullptr) {
+    if (const auto order = layout->member_order.find(&value); order != layout->member_order.end()) {
+      for (const auto &key : order->second) { members.push_back(value.find(key)); }
+      return members;
+    }
+  }
+  for (auto itr = value.begin(); itr != value.end(); ++itr) { members.push_back(itr); }
+  return members;
+}
+
+// `character` as a C++ character literal
+void append_character_literal(std::string &out, const char character)
+{
+  const auto value = static_cast<unsigned char>(character);
+  if (value >= 0x20 && value < 0x7f && character != '\'' && character != '\\') {
+    out += '\'';
+    out += character;
+    out += '\'';
+  } else {
+    out += fmt::format("'\\x{:02x}'", value);
+  }
+}
+
+struct text_range
+{
+  std::size_t object_number;
+  std::size_t offset;
+  std::size_t length;
+};
+
+// Appends the minified text of `value`, as nlohmann::json::dump() writes it, to
+// `text` and records the range of every non-empty array and object under the
+// number `compile()` gives it, by numbering the nodes in the same order
+void minify(const nlohmann::json &value,
+  std::size_t &obj_count,
+  std::string &text,
+  std::vector<text_range> &ranges,
+  const document_layout *layout)
+{
+  const auto current_object_number = obj_count++;
+  if (!value.is_structured() || value.empty()) {
+    text += value.dump();
+    return;
+  }
+
+  const auto offset = text.size();
+  if (value.is_object()) {
+    text += '{';
+    for (const auto &member : ordered_members(value, layout)) {
+      if (text.size() != offset + 1) { text += ','; }
+      text += nlohmann::json(member.key()).dump();
+      text += ':';
+      minify(*member, obj_count, text, ranges, layout);
+    }
+    text += '}';
+  } else {
+    text += '[';
+    for (const auto &element : value) {
+      if (text.size() != offset + 1) { text += ','; }
+      minify(element, obj_count, text, ranges, layout);
+    }
+    text += ']';
+  }
+  ranges.push_back(text_range{ current_object_number, offset, text.size() - offset });
+}
+
+// The number `compile()` gives each node of `value`, keyed by address
+void number_nodes(const nlohmann::json &value,
+  std::size_t &obj_count,
+  std::unordered_map<const nlohmann::json *, std::size_t> &numbers,
+  const document_layout *layout)
+{
+  numbers.emplace(&value, obj_count++);
+  if (value.is_object()) {
+    for (const auto &member : ordered_members(value, layout)) { number_nodes(*member, obj_count, numbers, layout); }
+  } else if (value.is_array()) {
+    for (const auto &child : value) { number_nodes(child, obj_count, numbers, layout); }
+  }
+}
+
+std::string escape_pointer_token(const std::string &token)
+{
+  std::string escaped;
+  for (const auto character : token) {
+    if (character == '~') {
+      escaped += "~0";
+    } else if (character == '/') {
+      escaped += "~1";
+    } else {
+      escaped += character;
+    }
+  }
+  return escaped;
+}
+
+// A C++ identifier for the subtree at `pointer`, distinct from those in `used`:
+// its reference tokens joined by '_', with each run of anything but letters and
+// digits replaced by one '_'
+std::string section_name(const std::string &pointer, std::unordered_set<std::string> &used)
+{
+  static const std::unordered_set<std::string> keywords{ "alignas", "alignof", "and", "and_eq", "asm", "auto",
+    "bitand", "bitor", "bool", "break", "case", "catch", "char", "char8_t", "char16_t", "char32_t", "class", "compl",
+    "concept", "const", "consteval", "constexpr", "constinit", "const_cast", "continue", "co_await", "co_return",
+    "co_yield", "decltype", "default", "delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export",
+    "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+    "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+    "reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast",
+    "struct", "switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
+    "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq" };
+
+  // single underscores only, and none leading, since other names are reserved
+  std::string name;
+  for (const auto character : pointer) {
+    // the escapes "~0" and "~1" become "_0" and "_1"
+    if (std::isalnum(static_cast<unsigned char>(character)) != 0) {
+      name += character;
+    } else if (!name.empty() && name.back() != '_') {
+      name += '_';
+    }
+  }
+  if (!name.empty() && name.back() == '_') { name.pop_back(); }
+  if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front())) != 0) { name.insert(0, "section_"); }
+  if (keywords.count(name) != 0) { name += '_'; }
+
+  auto unique = name;
+  for (std::size_t suffix = 2; !used.insert(unique).second; ++suffix) { unique = fmt::format("{}_{}", name, suffix); }
+  return unique;
+}
+
+// Emits `json` for `--compress`: each top-level member with at least
+// `compress_min_size` bytes of minified text as that text compressed, the others
+// compiled as usual, and an accessor for each in `sections`. Returns false, emitting
+// nothing, if the root is not an object and too small to compress.
+bool compile_compressed(const std::string_view document_name,
+  const nlohmann::json &json,
+  const compile_options &options,
+  std::size_t &obj_count,
+  compile_results &results)
+{
+  const auto emit_data = [&](const std::string &name, const std::string &text) {
+    const auto compressed = json2cpp::compress(text);
+    results.impl.push_back(fmt::format(
+      "inline constexpr std::array<unsigned char, {}> section_{}_data{{{{", compressed.size(), name));
+    constexpr std::size_t bytes_per_line = 24;
+    for (std::size_t offset = 0; offset < compressed.size(); offset += bytes_per_line) {
+      std::string line = " ";
+      for (std::size_t idx = offset; idx < std::min(compressed.size(), offset + bytes_per_line); ++idx) {
+        line += fmt::format(" {},", static_cast<unsigned char>(compressed[idx]));
+      }
+      results.impl.push_back(std::move(line));
+    }
+    results.impl.emplace_back("}};");
+    results.impl.push_back(fmt::format("inline constexpr std::size_t section_{}_size = {};", name, text.size()));
+    spdlog::info("{} compressed from {} to {} bytes", name, text.size(), compressed.size());
+  };
+
+  const auto expand = [&](const std::string &name) {
+    return fmt::format(R"(  static const json2cpp::compressed_subtree subtree{{
+    compiled_json::{0}::impl::section_{1}_data, compiled_json::{0}::impl::section_{1}_size }};
+  return subtree.get();)",
+      document_name,
+      name);
+  };
+
+  if (!json.is_object()) {
+    const auto text = json.dump();
+    if (text.size() < options.compress_min_size) { return false; }
+    emit_data("document", text);
+    results.cpp.push_back(fmt::format("const json2cpp::json &get()\n{{\n{}\n}}", expand("document")));
+    return true;
+  }
+
+  std::unordered_set<std::string> names;
+  std::vector<std::string> members;
+  results.hpp.insert(std::prev(results.hpp.end(), 2), "  namespace sections {");
+  results.cpp.emplace_back("namespace sections {");
+  for (const auto &member : json.items()) {
+    const auto pointer = "/" + escape_pointer_token(member.key());
+    const auto name = section_name(pointer, names);
+    const auto text = member.value().dump();
+    const bool compressed = text.size() >= options.compress_min_size;
+
+    if (compressed) {
+      emit_data(name, text);
+      results.cpp.push_back(fmt::format("const json2cpp::json &{}()\n{{\n{}\n}}", name, expand(name)));
+    } else {
+      const auto data = compile(member.value(), obj_count, results.impl, options);
+      results.impl.push_back(fmt::format("inline constexpr auto section_{} = json{{{{{}}}{}}};",
+        name,
+        data,
+        options.low_compile_cost ? fmt::format(", {}", node_size(member.value())) : std::string{}));
+      results.cpp.push_back(fmt::format(
+        "const json2cpp::json &{0}() {{ return compiled_json::{1}::impl::section_{0}; }}", name, document_name));
+    }
+
+    results.hpp.insert(
+      std::prev(results.hpp.end(), 2), fmt::format("    // {}{}", pointer, compressed ? ", compressed" : ""));
+    results.hpp.insert(std::prev(results.hpp.end(), 2), fmt::format("    const json2cpp::json &{}();", name));
+    members.push_back(
+      fmt::format("    {{ std::string_view{{ R\"string({})string\" }}, &sections::{} }},", member.key(), name));
+  }
+  results.hpp.insert(std::prev(results.hpp.end(), 2), "  }");
+  results.cpp.emplace_back("}");
+
+  results.cpp.emplace_back("const json2cpp::json &get()\n{");
+  results.cpp.emplace_back("  static const json2cpp::assembled_object document{ {");
+  std::move(members.begin(), members.end(), std::back_inserter(results.cpp));
+  results.cpp.emplace_back("  } };");
+  results.cpp.emplace_back("  return document.root();\n}");
+  return true;
+}
+
+nlohmann::json load_document(const std::filesystem::path &filename)
+{
+  spdlog::info("Loading file: '{}'", filename.string());
+
+  std::ifstream input(filename);
+  nlohmann::json document;
+  input >> document;
+
+  spdlog::info("File loaded");
+
+  return document;
+}
+}// namespace
 
 std::string compile(const nlohmann::json &value, std::size_t &obj_count, std::vector<std::string> &lines)
+{
+  return compile(value, obj_count, lines, compile_options{});
+}
+
+std::string compile(const nlohmann::json &value,
+  std::size_t &obj_count,
+  std::vector<std::string> &lines,
+  const compile_options &options)
 {
   const auto current_object_number = obj_count++;
 
-  const auto json_string = [](const auto &str) { return fmt::format("R\"string({})string\"", str); };
+  const auto json_string = [&](const std::string &str) {
+    if (options.low_compile_cost) {
+      // a string_view literal carries its length, saving a constexpr strlen per string
+      return fmt::format("R\"string({})string\"sv", str);
+    }
+    return fmt::format("R\"string({})string\"", str);
+  };
+
+  // the initializer for a `json` node holding `value`, optionally with the size that
+  // `basic_json::size()` would otherwise compute during constant evaluation
+  const auto node = [&](const nlohmann::json &child) {
+    const auto data = compile(child, obj_count, lines, options);
+    if (!options.low_compile_cost) { return fmt::format("{{{}}}", data); }
+    return fmt::format("{{{}, {}}}", data, node_size(child));
+  };
+
+  // arrays the profiled program never reached are placed away from the others
+  const auto *placement =
+    options.layout != nullptr && options.layout->cold.count(&value) != 0 ? "JSON2CPP_COLD " : "";
 
   if (value.is_object()) {
     std::vector<std::string> pairs;
-    for (auto itr = value.begin(); itr != value.end(); ++itr) {
-      pairs.push_back(
-        fmt::format("value_pair_t{{{}, {{{}}}}},", json_string(itr.key()), compile(*itr, obj_count, lines)));
+    for (const auto &member : ordered_members(value, options.layout)) {
+      pairs.push_back(fmt::format("value_pair_t{{{}, {}}},", json_string(member.key()), node(*member)));
     }
 
-    lines.push_back(fmt::format(
-      "inline constexpr std::array<value_pair_t, {}> object_data_{} = {{", pairs.size(), current_object_number));
+    lines.push_back(fmt::format("{}inline constexpr std::array<value_pair_t, {}> object_data_{} = {{",
+      placement,
+      pairs.size(),
+      current_object_number));
 
     std::transform(pairs.begin(), pairs.end(), std::back_inserter(lines), [](const auto &pair) {
       return fmt::format("  {}", pair);
@@ -52,12 +330,14 @@ std::string compile(const nlohmann::json &value, std::size_t &obj_count, std::ve
   } else if (value.is_array()) {
     std::vector<std::string> entries;
     std::transform(value.begin(), value.end(), std::back_inserter(entries), [&](const auto &child) {
-      return fmt::format("{{{}}},", compile(child, obj_count, lines));
+      return fmt::format("{},", node(child));
     });
 
 
-    lines.push_back(fmt::format(
-      "inline constexpr std::array<json, {}> object_data_{} = {{{{", entries.size(), current_object_number));
+    lines.push_back(fmt::format("{}inline constexpr std::array<json, {}> object_data_{} = {{{{",
+      placement,
+      entries.size(),
+      current_object_number));
 
     std::transform(entries.begin(), entries.end(), std::back_inserter(lines), [](const auto &entry) {
       return fmt::format("  {}", entry);
@@ -69,14 +349,24 @@ std::string compile(const nlohmann::json &value, std::size_t &obj_count, std::ve
 
 
   } else if (value.is_number_float()) {
+    if (options.low_compile_cost) {
+      // hex-float literals are exact and trivial for the compiler to convert
+      return fmt::format("double{{{:a}}}", value.get<double>());
+    }
     return fmt::format("double{{{}}}", value.get<double>());
   } else if (value.is_number_unsigned()) {
     return fmt::format("std::uint64_t{{{}}}", value.get<std::uint64_t>());
   } else if (value.is_number() && !value.is_number_unsigned()) {
-    return fmt::format("std::int64_t{{{}}}", value.get<std::uint64_t>());
+    const auto number = value.get<std::int64_t>();
+    if (number == std::numeric_limits<std::int64_t>::min()) {
+      // the literal for the magnitude of the minimum value does not fit in an int64_t
+      return fmt::format("std::int64_t{{{} - 1}}", number + 1);
+    }
+    return fmt::format("std::int64_t{{{}}}", number);
   } else if (value.is_boolean()) {
     return fmt::format("bool{{{}}}", value.get<bool>());
   } else if (value.is_string()) {
+    if (options.low_compile_cost) { return json_string(value.get<std::string>()); }
     return fmt::format("string_view{{{}}}", json_string(value.get<std::string>()));
   } else if (value.is_null()) {
     return "std::nullptr_t{}";
@@ -85,8 +375,31 @@ std::string compile(const nlohmann::json &value, std::size_t &obj_count, std::ve
   return "unhandled";
 }
 
-compile_results compile(const std::string_view document_name, const nlohmann::json &json)
+compile_results compile(const std::string_view document_name,
+  const nlohmann::json &json,
+  const compile_options &options)
 {
+  if (!options.include_pointers.empty() || !options.exclude_pointers.empty()) {
+    const auto selected = select_subtrees(json, options.include_pointers, options.exclude_pointers);
+    auto remaining_options = options;
+    remaining_options.include_pointers.clear();
+    remaining_options.exclude_pointers.clear();
+    return compile(document_name, selected, remaining_options);
+  }
+
+  if (!options.profile.empty()) {
+    const auto layout = load_layout(options.profile, json);
+    auto profiled_options = options;
+    profiled_options.profile.clear();
+    profiled_options.layout = &layout;
+    return compile(document_name, json, profiled_options);
+  }
+
+  if (options.compress
+      && (options.emit_text || options.emit_hashes || options.top_level_sections
+          || !options.section_pointers.empty())) {
+    throw std::runtime_error("--compress cannot be combined with --emit-text, --emit-hashes or sections");
+  }
 
   std::size_t obj_count{ 0 };
 
@@ -96,9 +409,31 @@ compile_results compile(const std::string_view document_name, const nlohmann::js
   results.hpp.push_back(fmt::format("#define {}_COMPILED_JSON", document_name));
 
   results.hpp.emplace_back("#include <json2cpp/json2cpp.hpp>");
+  if (options.emit_text) {
+    results.hpp.emplace_back("#include <string>");
+    results.hpp.emplace_back("#include <string_view>");
+  }
 
+  if (options.emit_hashes) {
+    results.hpp.emplace_back("#include <cstdint>");
+    results.hpp.emplace_back("#include <json2cpp/json2cpp_hash.hpp>");
+  }
   results.hpp.push_back(fmt::format("namespace compiled_json::{} {{", document_name));
   results.hpp.push_back(fmt::format("  const json2cpp::json &get();", document_name));
+  if (options.emit_text) {
+    results.hpp.emplace_back("  // the whole document as minified JSON text");
+    results.hpp.emplace_back("  std::string_view text();");
+    results.hpp.emplace_back(
+      "  // the minified text of `node`: a view of the stored text for arrays and objects of this document,");
+    results.hpp.emplace_back("  // otherwise serialized into `buffer`");
+    results.hpp.emplace_back("  std::string_view dump(const json2cpp::json &node, std::string &buffer);");
+  }
+  if (options.emit_hashes) {
+    results.hpp.emplace_back("  // the hashes of this document's arrays and objects, for json2cpp::equal() and diff()");
+    results.hpp.emplace_back("  const json2cpp::hash_index &hashes();");
+    results.hpp.emplace_back("  // the structural hash of `node`, without hashing arrays and objects of this document");
+    results.hpp.emplace_back("  std::uint64_t hash(const json2cpp::json &node);");
+  }
   results.hpp.emplace_back("}");
 
   results.hpp.emplace_back("#endif");
@@ -110,6 +445,9 @@ compile_results compile(const std::string_view document_name, const nlohmann::js
   results.impl.push_back(fmt::format("#define {}_COMPILED_JSON_IMPL", document_name));
 
   results.impl.emplace_back("#include <json2cpp/json2cpp.hpp>");
+  if (options.emit_text) { results.impl.emplace_back("#include <json2cpp/json2cpp_serializer.hpp>"); }
+  if (options.emit_hashes) { results.impl.emplace_back("#include <json2cpp/json2cpp_hash.hpp>"); }
+  if (options.compress) { results.impl.emplace_back("#include <json2cpp/json2cpp_compressed.hpp>"); }
 
   results.impl.push_back(fmt::format(R"(
 namespace compiled_json::{}::impl {{
@@ -120,15 +458,144 @@ using string_view=std::basic_string_view<char>;
 using array_t=json2cpp::basic_array_t<char>;
 using object_t=json2cpp::basic_object_t<char>;
 using value_pair_t=json2cpp::basic_value_pair_t<char>;
+using namespace std::string_view_literals;
 
 )",
     document_name));
 
 
-  const auto last_obj_name = compile(json, obj_count, results.impl);
+  if (options.compress && compile_compressed(document_name, json, options, obj_count, results)) {
+    results.impl.emplace_back("\n}\n\n#endif\n");
+    spdlog::info("{} JSON objects processed.", obj_count);
+    return results;
+  }
+
+  results.cpp.push_back(
+    fmt::format("const json2cpp::json &get() {{ return compiled_json::{}::impl::document; }}", document_name));
+
+  const auto last_obj_name = compile(json, obj_count, results.impl, options);
+
+  if (options.emit_text) {
+    std::size_t text_count{ 0 };
+    std::string text;
+    std::vector<text_range> ranges;
+    minify(json, text_count, text, ranges, options.layout);
+
+    // a character literal per byte rather than one string literal, which MSVC limits
+    // to 64 KB (C2026)
+    results.impl.push_back(fmt::format("inline constexpr std::array<char, {}> text_data{{{{", text.size()));
+    constexpr std::size_t characters_per_line = 24;
+    for (std::size_t offset = 0; offset < text.size(); offset += characters_per_line) {
+      std::string line = " ";
+      for (std::size_t idx = offset; idx < std::min(text.size(), offset + characters_per_line); ++idx) {
+        line += ' ';
+        append_character_literal(line, text[idx]);
+        line += ',';
+      }
+      results.impl.push_back(std::move(line));
+    }
+    results.impl.emplace_back("}};");
+    results.impl.emplace_back("inline constexpr std::string_view text{ text_data.data(), text_data.size() };");
+
+    results.impl.push_back(
+      fmt::format("inline constexpr std::array<json2cpp::text_range, {}> text_ranges{{{{", ranges.size()));
+    for (const auto &range : ranges) {
+      results.impl.push_back(fmt::format(
+        "  json2cpp::text_range{{object_data_{0}.data(), object_data_{0}.size(), {1}, {2}}},",
+        range.object_number,
+        range.offset,
+        range.length));
+    }
+    results.impl.emplace_back("}};");
+
+    results.cpp.push_back(
+      fmt::format("std::string_view text() {{ return compiled_json::{}::impl::text; }}", document_name));
+    results.cpp.push_back(fmt::format(R"(std::string_view dump(const json2cpp::json &node, std::string &buffer)
+{{
+  static const json2cpp::text_index index{{ compiled_json::{0}::impl::text, compiled_json::{0}::impl::text_ranges }};
+  if (const auto stored = index.find(node); !stored.empty()) {{ return stored; }}
+  buffer.clear();
+  json2cpp::serialize(node, buffer);
+  return buffer;
+}})",
+      document_name));
+  }
+
+  if (options.emit_hashes) {
+    std::size_t hash_count{ 0 };
+    std::unordered_map<const nlohmann::json *, std::size_t> numbers;
+    number_nodes(json, hash_count, numbers, options.layout);
+
+    std::vector<std::string> entries;
+    static_cast<void>(json2cpp::structural_hash(json, [&](const nlohmann::json &subtree, const std::uint64_t hash) {
+      if (subtree.empty()) { return; }
+      entries.push_back(fmt::format(
+        "  json2cpp::subtree_hash{{object_data_{0}.data(), object_data_{0}.size(), 0x{1:016x}ULL}},",
+        numbers.at(&subtree),
+        hash));
+    }));
+
+    results.impl.push_back(
+      fmt::format("inline constexpr std::array<json2cpp::subtree_hash, {}> subtree_hashes{{{{", entries.size()));
+    std::move(entries.begin(), entries.end(), std::back_inserter(results.impl));
+    results.impl.emplace_back("}};");
+
+    results.cpp.push_back(fmt::format(R"(const json2cpp::hash_index &hashes()
+{{
+  static const json2cpp::hash_index index{{ compiled_json::{}::impl::subtree_hashes }};
+  return index;
+}})",
+      document_name));
+    results.cpp.emplace_back("std::uint64_t hash(const json2cpp::json &node) { return hashes().hash(node); }");
+  }
+
+  std::vector<std::string> section_pointers;
+  if (options.top_level_sections && json.is_object()) {
+    for (const auto &member : json.items()) { section_pointers.push_back("/" + escape_pointer_token(member.key())); }
+  }
+  section_pointers.insert(section_pointers.end(), options.section_pointers.begin(), options.section_pointers.end());
+
+  if (!section_pointers.empty()) {
+    std::size_t section_count{ 0 };
+    std::unordered_map<const nlohmann::json *, std::size_t> numbers;
+    number_nodes(json, section_count, numbers, options.layout);
+
+    std::unordered_set<std::string> names;
+    results.hpp.insert(std::prev(results.hpp.end(), 2), "  namespace sections {");
+    results.cpp.emplace_back("namespace sections {");
+    for (const auto &pointer : section_pointers) {
+      if (!json.contains(nlohmann::json::json_pointer(pointer))) {
+        throw std::runtime_error(fmt::format("Section '{}' is not in the document", pointer));
+      }
+      const auto &subtree = json.at(nlohmann::json::json_pointer(pointer));
+      const auto name = section_name(pointer, names);
+
+      // the subtree's own arrays, so nothing above it is referenced
+      std::string data;
+      if (subtree.is_structured()) {
+        data = fmt::format(
+          "{}{{object_data_{}}}", subtree.is_object() ? "object_t" : "array_t", numbers.at(&subtree));
+      } else {
+        std::size_t scalar_count{ 0 };
+        std::vector<std::string> scalar_lines;
+        data = compile(subtree, scalar_count, scalar_lines, options);
+      }
+      results.impl.push_back(fmt::format("inline constexpr auto section_{} = json{{{{{}}}{}}};",
+        name,
+        data,
+        options.low_compile_cost ? fmt::format(", {}", node_size(subtree)) : std::string{}));
+
+      results.hpp.insert(std::prev(results.hpp.end(), 2), fmt::format("    // {}", pointer));
+      results.hpp.insert(std::prev(results.hpp.end(), 2), fmt::format("    const json2cpp::json &{}();", name));
+      results.cpp.push_back(fmt::format(
+        "const json2cpp::json &{0}() {{ return compiled_json::{1}::impl::section_{0}; }}", name, document_name));
+    }
+    results.hpp.insert(std::prev(results.hpp.end(), 2), "  }");
+    results.cpp.emplace_back("}");
+  }
 
   results.impl.push_back(fmt::format(R"(
-inline constexpr auto document = json{{{{{}}}}};
+inline constexpr auto document = json{{{{{}}}{}}};
 
 
 }}
@@ -136,7 +603,8 @@ inline constexpr auto document = json{{{{{}}}}};
 #endif
 
 )",
-    last_obj_name));
+    last_obj_name,
+    options.low_compile_cost ? fmt::format(", {}", node_size(json)) : std::string{}));
 
 
   spdlog::info("{} JSON objects processed.", obj_count);
@@ -145,17 +613,11 @@ inline constexpr auto document = json{{{{{}}}}};
 }
 
 
-compile_results compile(const std::string_view document_name, const std::filesystem::path &filename)
+compile_results compile(const std::string_view document_name,
+  const std::filesystem::path &filename,
+  const compile_options &options)
 {
-  spdlog::info("Loading file: '{}'", filename.string());
-
-  std::ifstream input(filename);
-  nlohmann::json document;
-  input >> document;
-
-  spdlog::info("File loaded");
-
-  return compile(document_name, document);
+  return compile(document_name, load_document(filename), options);
 }
 
 void write_compilation([[maybe_unused]] std::string_view document_name,
@@ -178,23 +640,36 @@ void write_compilation([[maybe_unused]] std::string_view document_name,
 
   std::ofstream cpp(cpp_name);
   cpp << fmt::format("#include \"{}\"\n", impl_name.filename().string());
-  cpp << fmt::format(
-    "namespace compiled_json::{} {{\nconst json2cpp::json &get() {{ return compiled_json::{}::impl::document; }}\n}}\n",
-    document_name,
-    document_name);
+  cpp << fmt::format("namespace compiled_json::{} {{\n", document_name);
+  for (const auto &line : results.cpp) { cpp << line << '\n'; }
+  cpp << "}\n";
 }
 
 void compile_to(const std::string_view document_name,
   const nlohmann::json &json,
-  const std::filesystem::path &base_output)
+  const std::filesystem::path &base_output,
+  const compile_options &options)
 {
-  write_compilation(document_name, compile(document_name, json), base_output);
+  if (!options.schema_defaults.empty()) {
+    auto document = json;
+    const auto filled = apply_schema_defaults(load_document(options.schema_defaults), document);
+    spdlog::info("{} properties filled in from schema defaults", filled);
+
+    auto remaining_options = options;
+    remaining_options.schema_defaults.clear();
+    compile_to(document_name, document, base_output, remaining_options);
+    return;
+  }
+
+  write_compilation(document_name, compile(document_name, json, options), base_output);
+  if (options.validator) { write_validator(compile_validator(document_name, json), base_output); }
 }
 
 
 void compile_to(const std::string_view document_name,
   const std::filesystem::path &filename,
-  const std::filesystem::path &base_output)
+  const std::filesystem::path &base_output,
+  const compile_options &options)
 {
-  write_compilation(document_name, compile(document_name, filename), base_output);
+  compile_to(document_name, load_document(filename), base_output, options);
 }
@@ -31,19 +31,87 @@ SOFTWARE.
 #include <string>
 #include <vector>
 
+struct document_layout;
+
 struct compile_results
 {
   std::vector<std::string> hpp;
   std::vector<std::string> impl;
+  // definitions appended to the .cpp file after `get()`
+  std::vector<std::string> cpp;
+};
+
+struct compile_options
+{
+  // Emit each node with its size precomputed and floating point values as exact
+  // hex-float literals. This keeps the compiler from running `basic_json::size()`
+  // and a decimal-to-binary conversion for every node during constant evaluation,
+  // which is where most of the build time goes for very large documents.
+  bool low_compile_cost{ false };
+
+  // Treat the document as a JSON Schema and also write `<output_base_name>_validator.hpp`,
+  // see schema_compiler.hpp
+  bool validator{ false };
+
+  // Also emit the document's minified text and the byte range of each array and
+  // object in it, so `compiled_json::<name>::dump()` returns subtrees as views
+  bool emit_text{ false };
+
+  // Also emit the structural hash of each array and object, see json2cpp_hash.hpp,
+  // so comparing and diffing compiled subtrees can skip the equal ones
+  bool emit_hashes{ false };
+
+  // Also emit an accessor in `compiled_json::<name>::sections` for each top-level
+  // member, and for each of `section_pointers` (JSON pointers). Each accessor refers
+  // only to the data of its own subtree, so a program built with -ffunction-sections
+  // -fdata-sections and linked with --gc-sections that never calls `get()` keeps only
+  // the subtrees it uses.
+  bool top_level_sections{ false };
+  std::vector<std::string> section_pointers;
+
+  // Store each top-level member whose minified text has at least `compress_min_size`
+  // bytes compressed, to be expanded on first use, see json2cpp_compressed.hpp.
+  // Every member gets an accessor in `compiled_json::<name>::sections`; `get()`
+  // expands all of them, and the document is not available at compile time.
+  bool compress{ false };
+  std::size_t compress_min_size{ 4096 };
+
+  // A JSON Schema whose `default`s are written into the document before it is
+  // compiled, see schema_defaults.hpp. Empty for none.
+  std::filesystem::path schema_defaults;
+
+  // Compile only the subtrees these JSON pointers match, and the members and
+  // elements leading to them, less those `exclude_pointers` match; a '*' in a
+  // pointer matches any run of characters in one reference token. See
+  // document_selection.hpp. Both empty for the whole document.
+  std::vector<std::string> include_pointers;
+  std::vector<std::string> exclude_pointers;
+
+  // An access profile written by `json2cpp::write_profile`, see json2cpp_profile.hpp.
+  // Object members are emitted most looked-up first, and the arrays and objects the
+  // profiled program never reached are marked JSON2CPP_COLD. Empty for none.
+  std::filesystem::path profile;
+
+  // the layout loaded from `profile` by `compile()`, for the document being compiled
+  const document_layout *layout{ nullptr };
 };
 
 
 std::string compile(const nlohmann::json &value, std::size_t &obj_count, std::vector<std::string> &lines);
 
+std::string compile(const nlohmann::json &value,
+  std::size_t &obj_count,
+  std::vector<std::string> &lines,
+  const compile_options &options);
 
-compile_results compile(const std::string_view document_name, const nlohmann::json &json);
 
-compile_results compile(const std::string_view document_name, const std::filesystem::path &filename);
+compile_results compile(const std::string_view document_name,
+  const nlohmann::json &json,
+  const compile_options &options = {});
+
+compile_results compile(const std::string_view document_name,
+  const std::filesystem::path &filename,
+  const compile_options &options = {});
 
 
 void write_compilation(std::string_view document_name,
@@ -53,11 +121,13 @@ void write_compilation(std::string_view document_name,
 
 void compile_to(const std::string_view document_name,
   const nlohmann::json &json,
-  const std::filesystem::path &base_output);
+  const std::filesystem::path &base_output,
+  const compile_options &options = {});
 
 void compile_to(const std::string_view document_name,
   const std::filesystem::path &filename,
-  const std::filesystem::path &base_output);
+  const std::filesystem::path &base_output,
+  const compile_options &options = {});
 
 
 #endif
@@ -41,14 +41,55 @@ int main(int argc, const char **argv)
     std::filesystem::path input_file_name;
     std::filesystem::path output_base_name;
 
+    compile_options options;
+
     bool show_version = false;
     app.add_flag("--version", show_version, "Show version information");
+    app.add_flag("--low-compile-cost",
+      options.low_compile_cost,
+      "Emit precomputed node sizes and hex-float literals to reduce compile time of very large documents");
+    app.add_flag("--validator",
+      options.validator,
+      "Treat the document as a JSON Schema and also emit <output_base_name>_validator.hpp with specialized validation "
+      "functions");
+    app.add_flag("--emit-text",
+      options.emit_text,
+      "Also emit the minified JSON text, so dump() returns any array or object as a string_view without serializing");
+    app.add_flag("--emit-hashes",
+      options.emit_hashes,
+      "Also emit the structural hash of every array and object, for hash() and fast equal() and diff()");
+    app.add_flag("--sections",
+      options.top_level_sections,
+      "Also emit an accessor for each top-level member, so the linker can drop the members a program never uses");
+    app.add_option("--section",
+      options.section_pointers,
+      "Also emit an accessor for the subtree at this JSON pointer (may be repeated)");
+    app.add_flag("--compress",
+      options.compress,
+      "Store large top-level members compressed and expand each one the first time it is used, for smaller binaries");
+    app.add_option("--compress-min-size",
+      options.compress_min_size,
+      "Bytes of minified JSON from which --compress compresses a top-level member (default 4096)");
+    app.add_option("--schema-defaults",
+      options.schema_defaults,
+      "Fill in every property the given JSON Schema has a default for and the document lacks before compiling it");
+    app.add_option("--include",
+      options.include_pointers,
+      "Compile only the subtrees at these JSON pointers, where '*' matches any run of characters in a reference "
+      "token, and the members leading to them (may be repeated)");
+    app.add_option("--exclude",
+      options.exclude_pointers,
+      "Leave out the subtrees at these JSON pointers, with '*' as for --include (may be repeated)");
+    app.add_option("--profile",
+      options.profile,
+      "Lay the document out for the access profile a JSON2CPP_PROFILE build wrote: most looked-up keys first, "
+      "unused arrays and objects apart");
     app.add_option("<document_name>", document_name);
     app.add_option("<input_file_name>", input_file_name);
     app.add_option("<output_base_name>", output_base_name);
     CLI11_PARSE(app, argc, argv);
 
-    compile_to(document_name, input_file_name, output_base_name);
+    compile_to(document_name, input_file_name, output_base_name, options);
   } catch (const std::exception &e) {
     spdlog::error("Unhandled exception in main: {}", e.what());
   }
@@ -0,0 +1,123 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "profile_layout.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace {
+
+// key comparisons for the profiled lookups when the members are in `order`; a key
+// the object lacks compares every member
+std::uint64_t comparisons(const nlohmann::json &object,
+  const std::unordered_map<std::string, std::uint64_t> &lookups,
+  const std::vector<std::string> &order)
+{
+  std::uint64_t total = 0;
+  for (const auto &[key, count] : lookups) {
+    const auto position = std::find(order.begin(), order.end(), key);
+    const auto compared =
+      position == order.end() ? object.size() : static_cast<std::size_t>(position - order.begin()) + 1;
+    total += count * compared;
+  }
+  return total;
+}
+
+void mark_cold(const nlohmann::json &value,
+  const std::unordered_set<const nlohmann::json *> &reached,
+  std::unordered_set<const nlohmann::json *> &cold)
+{
+  if (!value.is_structured() || value.empty()) { return; }
+  if (reached.count(&value) == 0) { cold.insert(&value); }
+  for (const auto &child : value) { mark_cold(child, reached, cold); }
+}
+
+}// namespace
+
+document_layout load_layout(const std::filesystem::path &profile, const nlohmann::json &document)
+{
+  spdlog::info("Loading profile: '{}'", profile.string());
+
+  std::ifstream input(profile);
+  nlohmann::json counts;
+  input >> counts;
+
+  if (!counts.is_object() || counts.value("json2cpp_profile", 0) != 1 || !counts.contains("nodes")) {
+    throw std::runtime_error(fmt::format("'{}' is not a json2cpp profile", profile.string()));
+  }
+
+  document_layout layout;
+  std::unordered_set<const nlohmann::json *> reached;
+  std::uint64_t document_order_comparisons = 0;
+  std::uint64_t profile_order_comparisons = 0;
+
+  for (const auto &node : counts.at("nodes")) {
+    const nlohmann::json::json_pointer pointer{ node.at("pointer").get<std::string>() };
+    if (!document.contains(pointer)) {
+      spdlog::warn("Profiled node '{}' is not in the document", pointer.to_string());
+      continue;
+    }
+    const auto &value = document.at(pointer);
+    reached.insert(&value);
+
+    if (!value.is_object() || !node.contains("keys")) { continue; }
+
+    std::unordered_map<std::string, std::uint64_t> lookups;
+    for (const auto &[key, key_counts] : node.at("keys").items()) {
+      lookups.emplace(key, key_counts.at("lookups").get<std::uint64_t>());
+    }
+
+    std::vector<std::string> order;
+    for (const auto &member : value.items()) { order.push_back(member.key()); }
+    document_order_comparisons += comparisons(value, lookups, order);
+
+    const auto lookups_of = [&](const std::string &key) {
+      const auto found = lookups.find(key);
+      return found == lookups.end() ? std::uint64_t{ 0 } : found->second;
+    };
+    std::stable_sort(order.begin(), order.end(), [&](const std::string &lhs, const std::string &rhs) {
+      return lookups_of(lhs) > lookups_of(rhs);
+    });
+    profile_order_comparisons += comparisons(value, lookups, order);
+
+    layout.member_order.emplace(&value, std::move(order));
+  }
+
+  if (reached.empty()) {
+    spdlog::warn("The profile names no node of the document, so it is laid out as usual");
+    return layout;
+  }
+
+  mark_cold(document, reached, layout.cold);
+  spdlog::info("{} profiled objects reordered, key comparisons {} -> {}; {} arrays and objects are cold",
+    layout.member_order.size(),
+    document_order_comparisons,
+    profile_order_comparisons,
+    layout.cold.size());
+
+  return layout;
+}
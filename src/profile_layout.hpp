@@ -0,0 +1,52 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSON2CPP_PROFILE_LAYOUT_HPP
+#define JSON2CPP_PROFILE_LAYOUT_HPP
+
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// How `compile()` lays out a document, from an access profile written by
+// `json2cpp::write_profile`, see json2cpp_profile.hpp
+struct document_layout
+{
+  // the keys of each object that was looked up in, most looked up first and
+  // otherwise in document order
+  std::unordered_map<const nlohmann::json *, std::vector<std::string>> member_order;
+
+  // the non-empty arrays and objects the profiled program never reached
+  std::unordered_set<const nlohmann::json *> cold;
+};
+
+// The layout of `document` that `profile` calls for. Nodes the profile names but
+// the document lacks are ignored, since the document may have changed since it was
+// profiled; if it names none of the document's nodes, nothing is marked cold.
+document_layout load_layout(const std::filesystem::path &profile, const nlohmann::json &document);
+
+#endif
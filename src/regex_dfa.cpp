@@ -0,0 +1,861 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "regex_dfa.hpp"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+// thrown while compiling a pattern the DFA cannot represent
+struct unsupported_pattern : std::runtime_error
+{
+  using std::runtime_error::runtime_error;
+};
+
+using code_point = std::uint32_t;
+constexpr code_point max_code_point = 0x10FFFF;
+
+struct code_point_range
+{
+  code_point first;
+  code_point last;
+};
+
+// sorted, non-overlapping ranges
+using code_point_set = std::vector<code_point_range>;
+
+code_point_set normalize(code_point_set set)
+{
+  std::sort(set.begin(), set.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+  code_point_set result;
+  for (const auto &range : set) {
+    if (!result.empty() && range.first <= result.back().last + 1) {
+      result.back().last = std::max(result.back().last, range.last);
+    } else {
+      result.push_back(range);
+    }
+  }
+  return result;
+}
+
+// every code point not in `set`; surrogates cannot appear in UTF-8 and are left out
+code_point_set complement(const code_point_set &set)
+{
+  code_point_set result;
+  code_point next = 0;
+  for (const auto &range : normalize(set)) {
+    if (range.first > next) { result.push_back({ next, range.first - 1 }); }
+    next = range.last + 1;
+  }
+  if (next <= max_code_point) { result.push_back({ next, max_code_point }); }
+
+  code_point_set without_surrogates;
+  for (const auto &range : result) {
+    if (range.last < 0xD800 || range.first > 0xDFFF) {
+      without_surrogates.push_back(range);
+      continue;
+    }
+    if (range.first < 0xD800) { without_surrogates.push_back({ range.first, 0xD7FF }); }
+    if (range.last > 0xDFFF) { without_surrogates.push_back({ 0xE000, range.last }); }
+  }
+  return without_surrogates;
+}
+
+const code_point_set &digits()
+{
+  static const code_point_set set{ { '0', '9' } };
+  return set;
+}
+
+const code_point_set &word_characters()
+{
+  static const code_point_set set{ { '0', '9' }, { 'A', 'Z' }, { '_', '_' }, { 'a', 'z' } };
+  return set;
+}
+
+// ECMAScript WhiteSpace and LineTerminator
+const code_point_set &white_space()
+{
+  static const code_point_set set{ { 0x09, 0x0D },
+    { 0x20, 0x20 },
+    { 0xA0, 0xA0 },
+    { 0x1680, 0x1680 },
+    { 0x2000, 0x200A },
+    { 0x2028, 0x2029 },
+    { 0x202F, 0x202F },
+    { 0x205F, 0x205F },
+    { 0x3000, 0x3000 },
+    { 0xFEFF, 0xFEFF } };
+  return set;
+}
+
+struct node
+{
+  enum class kind { empty, set, concat, alternate, repeat, line_begin, line_end };
+  static constexpr std::size_t unbounded = std::numeric_limits<std::size_t>::max();
+
+  kind type{ kind::empty };
+  code_point_set set{};
+  std::vector<node> children{};
+  std::size_t min{ 0 };
+  std::size_t max{ 0 };
+};
+
+// Recursive descent parser for the ECMAScript pattern syntax, without the
+// features that need backtracking
+class pattern_parser
+{
+public:
+  explicit pattern_parser(const std::string_view pattern) : pattern_{ pattern } {}
+
+  node parse()
+  {
+    auto result = alternation();
+    if (!at_end()) { throw unsupported_pattern("unbalanced ')'"); }
+    return result;
+  }
+
+private:
+  static constexpr std::size_t max_repetition = 1000;
+
+  [[nodiscard]] bool at_end() const noexcept { return position_ >= pattern_.size(); }
+  [[nodiscard]] char peek(const std::size_t offset = 0) const noexcept
+  {
+    return position_ + offset < pattern_.size() ? pattern_[position_ + offset] : '\0';
+  }
+
+  bool consume(const char character)
+  {
+    if (!at_end() && peek() == character) {
+      ++position_;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(const char character)
+  {
+    if (!consume(character)) { throw unsupported_pattern(fmt_expected(character)); }
+  }
+
+  static std::string fmt_expected(const char character) { return std::string{ "expected '" } + character + "'"; }
+
+  // decodes one UTF-8 sequence from the pattern
+  code_point next_code_point()
+  {
+    const auto lead = static_cast<unsigned char>(pattern_[position_++]);
+    if (lead < 0x80) { return lead; }
+
+    std::size_t continuation = 0;
+    code_point value = 0;
+    if ((lead & 0xE0U) == 0xC0U) {
+      continuation = 1;
+      value = lead & 0x1FU;
+    } else if ((lead & 0xF0U) == 0xE0U) {
+      continuation = 2;
+      value = lead & 0x0FU;
+    } else if ((lead & 0xF8U) == 0xF0U) {
+      continuation = 3;
+      value = lead & 0x07U;
+    } else {
+      throw unsupported_pattern("invalid UTF-8 in pattern");
+    }
+
+    for (std::size_t idx = 0; idx < continuation; ++idx) {
+      if (at_end() || (static_cast<unsigned char>(peek()) & 0xC0U) != 0x80U) {
+        throw unsupported_pattern("invalid UTF-8 in pattern");
+      }
+      value = (value << 6U) | (static_cast<unsigned char>(pattern_[position_++]) & 0x3FU);
+    }
+    return value;
+  }
+
+  node alternation()
+  {
+    auto first = sequence();
+    if (at_end() || peek() != '|') { return first; }
+
+    node result{ node::kind::alternate };
+    result.children.push_back(std::move(first));
+    while (consume('|')) { result.children.push_back(sequence()); }
+    return result;
+  }
+
+  node sequence()
+  {
+    node result{ node::kind::concat };
+    while (!at_end() && peek() != '|' && peek() != ')') { result.children.push_back(term()); }
+    return result;
+  }
+
+  node term()
+  {
+    auto result = atom();
+
+    std::size_t min = 0;
+    std::size_t max = 0;
+    if (consume('*')) {
+      max = node::unbounded;
+    } else if (consume('+')) {
+      min = 1;
+      max = node::unbounded;
+    } else if (consume('?')) {
+      max = 1;
+    } else if (!braced_quantifier(min, max)) {
+      return result;
+    }
+    // lazy quantifiers match the same strings, which is all a search needs
+    consume('?');
+
+    if (result.type == node::kind::line_begin || result.type == node::kind::line_end) {
+      throw unsupported_pattern("quantified assertion");
+    }
+    if (min > max) { throw unsupported_pattern("invalid repetition range"); }
+    if (min > max_repetition || (max != node::unbounded && max > max_repetition)) {
+      throw unsupported_pattern("repetition count too large");
+    }
+
+    node repeat{ node::kind::repeat };
+    repeat.children.push_back(std::move(result));
+    repeat.min = min;
+    repeat.max = max;
+    return repeat;
+  }
+
+  // {n}, {n,} or {n,m}; anything else leaves the '{' to be read as a literal
+  bool braced_quantifier(std::size_t &min, std::size_t &max)
+  {
+    if (peek() != '{') { return false; }
+
+    std::size_t offset = 1;
+    const auto number = [&](std::size_t &value) {
+      const auto start = offset;
+      value = 0;
+      while (peek(offset) >= '0' && peek(offset) <= '9') {
+        value = std::min<std::size_t>(value * 10 + static_cast<std::size_t>(peek(offset) - '0'), max_repetition + 1);
+        ++offset;
+      }
+      return offset != start;
+    };
+
+    if (!number(min)) { return false; }
+    max = min;
+    if (peek(offset) == ',') {
+      ++offset;
+      if (!number(max)) { max = node::unbounded; }
+    }
+    if (peek(offset) != '}') { return false; }
+    position_ += offset + 1;
+    return true;
+  }
+
+  node atom()
+  {
+    const auto character = peek();
+    switch (character) {
+    case '(': {
+      ++position_;
+      if (consume('?')) {
+        if (!consume(':')) { throw unsupported_pattern("lookaround and named groups are not supported"); }
+      }
+      auto inner = alternation();
+      expect(')');
+      return inner;
+    }
+    case '[':
+      ++position_;
+      return set_node(character_class());
+    case '.':
+      ++position_;
+      return set_node(complement({ { '\n', '\n' }, { '\r', '\r' }, { 0x2028, 0x2029 } }));
+    case '^':
+      ++position_;
+      return node{ node::kind::line_begin };
+    case '$':
+      ++position_;
+      return node{ node::kind::line_end };
+    case '\\':
+      ++position_;
+      return set_node(escape(false));
+    case '*':
+    case '+':
+    case '?':
+      throw unsupported_pattern("nothing to repeat");
+    default:
+      return set_node({ { next_code_point(), 0 } }, true);
+    }
+  }
+
+  static node set_node(code_point_set set, const bool single = false)
+  {
+    if (single) { set.front().last = set.front().first; }
+    node result{ node::kind::set };
+    result.set = normalize(std::move(set));
+    return result;
+  }
+
+  std::uint32_t hex_digits(const std::size_t count)
+  {
+    std::uint32_t value = 0;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      const auto digit = peek();
+      value <<= 4U;
+      if (digit >= '0' && digit <= '9') {
+        value |= static_cast<std::uint32_t>(digit - '0');
+      } else if (digit >= 'a' && digit <= 'f') {
+        value |= static_cast<std::uint32_t>(digit - 'a' + 10);
+      } else if (digit >= 'A' && digit <= 'F') {
+        value |= static_cast<std::uint32_t>(digit - 'A' + 10);
+      } else {
+        throw unsupported_pattern("invalid hex escape");
+      }
+      ++position_;
+    }
+    return value;
+  }
+
+  // the code points matched by the escape following a backslash
+  code_point_set escape(const bool in_class)
+  {
+    if (at_end()) { throw unsupported_pattern("pattern ends with '\\'"); }
+    const auto character = peek();
+    const auto single = [](const code_point value) { return code_point_set{ { value, value } }; };
+
+    if (character >= '1' && character <= '9') { throw unsupported_pattern("backreferences are not supported"); }
+
+    ++position_;
+    switch (character) {
+    case 'd':
+      return digits();
+    case 'D':
+      return complement(digits());
+    case 'w':
+      return word_characters();
+    case 'W':
+      return complement(word_characters());
+    case 's':
+      return white_space();
+    case 'S':
+      return complement(white_space());
+    case 't':
+      return single('\t');
+    case 'n':
+      return single('\n');
+    case 'r':
+      return single('\r');
+    case 'v':
+      return single('\v');
+    case 'f':
+      return single('\f');
+    case '0':
+      if (peek() >= '0' && peek() <= '9') { throw unsupported_pattern("octal escapes are not supported"); }
+      return single(0);
+    case 'b':
+      if (in_class) { return single('\b'); }
+      throw unsupported_pattern("word boundaries are not supported");
+    case 'B':
+      throw unsupported_pattern("word boundaries are not supported");
+    case 'k':
+    case 'p':
+    case 'P':
+      throw unsupported_pattern("named backreferences and property escapes are not supported");
+    case 'x':
+      return single(hex_digits(2));
+    case 'u': {
+      if (peek() == '{') { throw unsupported_pattern("\\u{...} escapes are not supported"); }
+      auto value = hex_digits(4);
+      // a surrogate pair spelled as two escapes is one code point
+      if (value >= 0xD800 && value <= 0xDBFF && peek() == '\\' && peek(1) == 'u') {
+        const auto saved = position_;
+        position_ += 2;
+        const auto low = hex_digits(4);
+        if (low >= 0xDC00 && low <= 0xDFFF) {
+          value = 0x10000 + ((value - 0xD800) << 10U) + (low - 0xDC00);
+        } else {
+          position_ = saved;
+        }
+      }
+      return single(value);
+    }
+    case 'c': {
+      const auto letter = peek();
+      if ((letter >= 'a' && letter <= 'z') || (letter >= 'A' && letter <= 'Z')) {
+        ++position_;
+        return single(static_cast<code_point>(letter) % 32);
+      }
+      return single('\\');
+    }
+    default:
+      // identity escape
+      --position_;
+      return single(next_code_point());
+    }
+  }
+
+  code_point_set character_class()
+  {
+    const bool negated = consume('^');
+    code_point_set set;
+
+    // returns true and the code point if the element is a single character
+    const auto element = [&](code_point_set &members) {
+      if (consume('\\')) {
+        members = escape(true);
+      } else {
+        const auto value = next_code_point();
+        members = { { value, value } };
+      }
+      return members.size() == 1 && members.front().first == members.front().last;
+    };
+
+    while (true) {
+      if (at_end()) { throw unsupported_pattern("unterminated character class"); }
+      if (consume(']')) { break; }
+
+      code_point_set first;
+      const bool first_single = element(first);
+      if (peek() == '-' && peek(1) != ']' && position_ + 1 < pattern_.size()) {
+        ++position_;
+        code_point_set last;
+        const bool last_single = element(last);
+        if (!first_single || !last_single) { throw unsupported_pattern("class escape used as a range bound"); }
+        if (first.front().first > last.front().first) { throw unsupported_pattern("range out of order"); }
+        set.push_back({ first.front().first, last.front().first });
+      } else {
+        set.insert(set.end(), first.begin(), first.end());
+      }
+    }
+
+    set = normalize(std::move(set));
+    return negated ? complement(set) : set;
+  }
+
+  std::string_view pattern_;
+  std::size_t position_{ 0 };
+};
+
+struct byte_range
+{
+  std::uint8_t first;
+  std::uint8_t last;
+};
+
+// Splits [first, last] into sequences of byte ranges that together match exactly
+// the UTF-8 encodings of those code points
+void utf8_sequences(code_point first, const code_point last, std::vector<std::vector<byte_range>> &sequences)
+{
+  constexpr std::array<code_point, 3> length_limits{ 0x7F, 0x7FF, 0xFFFF };
+  for (const auto limit : length_limits) {
+    if (first <= limit && last > limit) {
+      utf8_sequences(first, limit, sequences);
+      utf8_sequences(limit + 1, last, sequences);
+      return;
+    }
+  }
+
+  if (last <= 0x7F) {
+    sequences.push_back({ { static_cast<std::uint8_t>(first), static_cast<std::uint8_t>(last) } });
+    return;
+  }
+
+  for (std::uint32_t continuation = 1; continuation < 4; ++continuation) {
+    const code_point mask = (code_point{ 1 } << (6 * continuation)) - 1;
+    if ((first & ~mask) != (last & ~mask)) {
+      if ((first & mask) != 0) {
+        utf8_sequences(first, first | mask, sequences);
+        utf8_sequences((first | mask) + 1, last, sequences);
+        return;
+      }
+      if ((last & mask) != mask) {
+        utf8_sequences(first, (last & ~mask) - 1, sequences);
+        utf8_sequences(last & ~mask, last, sequences);
+        return;
+      }
+    }
+  }
+
+  const auto encode = [](const code_point value) {
+    std::vector<std::uint8_t> bytes;
+    if (value <= 0x7FF) {
+      bytes = { static_cast<std::uint8_t>(0xC0 | (value >> 6U)), static_cast<std::uint8_t>(0x80 | (value & 0x3FU)) };
+    } else if (value <= 0xFFFF) {
+      bytes = { static_cast<std::uint8_t>(0xE0 | (value >> 12U)),
+        static_cast<std::uint8_t>(0x80 | ((value >> 6U) & 0x3FU)),
+        static_cast<std::uint8_t>(0x80 | (value & 0x3FU)) };
+    } else {
+      bytes = { static_cast<std::uint8_t>(0xF0 | (value >> 18U)),
+        static_cast<std::uint8_t>(0x80 | ((value >> 12U) & 0x3FU)),
+        static_cast<std::uint8_t>(0x80 | ((value >> 6U) & 0x3FU)),
+        static_cast<std::uint8_t>(0x80 | (value & 0x3FU)) };
+    }
+    return bytes;
+  };
+
+  const auto first_bytes = encode(first);
+  const auto last_bytes = encode(last);
+  std::vector<byte_range> sequence;
+  for (std::size_t idx = 0; idx < first_bytes.size(); ++idx) {
+    sequence.push_back({ first_bytes[idx], last_bytes[idx] });
+  }
+  sequences.push_back(std::move(sequence));
+}
+
+struct nfa_state
+{
+  std::vector<std::tuple<std::uint8_t, std::uint8_t, std::size_t>> bytes;
+  std::vector<std::size_t> epsilon;
+  // only followed before the first byte of the input
+  std::vector<std::size_t> at_begin;
+  // only followed after the last byte of the input
+  std::vector<std::size_t> at_end;
+};
+
+class nfa_builder
+{
+public:
+  struct fragment
+  {
+    std::size_t start;
+    std::size_t end;
+  };
+
+  fragment build(const node &tree)
+  {
+    switch (tree.type) {
+    case node::kind::empty: {
+      const auto state = add();
+      return { state, state };
+    }
+    case node::kind::set: {
+      const auto start = add();
+      const auto end = add();
+      std::vector<std::vector<byte_range>> sequences;
+      for (const auto &range : tree.set) { utf8_sequences(range.first, range.last, sequences); }
+      for (const auto &sequence : sequences) {
+        auto current = start;
+        for (std::size_t idx = 0; idx < sequence.size(); ++idx) {
+          const auto target = idx + 1 == sequence.size() ? end : add();
+          states[current].bytes.emplace_back(sequence[idx].first, sequence[idx].last, target);
+          current = target;
+        }
+      }
+      return { start, end };
+    }
+    case node::kind::concat: {
+      const auto start = add();
+      auto current = start;
+      for (const auto &child : tree.children) {
+        const auto part = build(child);
+        states[current].epsilon.push_back(part.start);
+        current = part.end;
+      }
+      return { start, current };
+    }
+    case node::kind::alternate: {
+      const auto start = add();
+      const auto end = add();
+      for (const auto &child : tree.children) {
+        const auto part = build(child);
+        states[start].epsilon.push_back(part.start);
+        states[part.end].epsilon.push_back(end);
+      }
+      return { start, end };
+    }
+    case node::kind::repeat: {
+      const auto start = add();
+      auto current = start;
+      for (std::size_t idx = 0; idx < tree.min; ++idx) {
+        const auto part = build(tree.children.front());
+        states[current].epsilon.push_back(part.start);
+        current = part.end;
+      }
+      if (tree.max == node::unbounded) {
+        const auto loop = add();
+        const auto part = build(tree.children.front());
+        states[current].epsilon.push_back(loop);
+        states[loop].epsilon.push_back(part.start);
+        states[part.end].epsilon.push_back(loop);
+        return { start, loop };
+      }
+      const auto end = add();
+      for (std::size_t idx = tree.min; idx < tree.max; ++idx) {
+        const auto part = build(tree.children.front());
+        states[current].epsilon.push_back(end);
+        states[current].epsilon.push_back(part.start);
+        current = part.end;
+      }
+      states[current].epsilon.push_back(end);
+      return { start, end };
+    }
+    case node::kind::line_begin: {
+      const auto start = add();
+      const auto end = add();
+      states[start].at_begin.push_back(end);
+      return { start, end };
+    }
+    case node::kind::line_end: {
+      const auto start = add();
+      const auto end = add();
+      states[start].at_end.push_back(end);
+      return { start, end };
+    }
+    }
+    throw unsupported_pattern("unknown node");
+  }
+
+  std::vector<nfa_state> states;
+
+private:
+  static constexpr std::size_t max_nfa_states = 200000;
+
+  std::size_t add()
+  {
+    if (states.size() >= max_nfa_states) { throw unsupported_pattern("pattern too large"); }
+    states.emplace_back();
+    return states.size() - 1;
+  }
+};
+
+using state_set = std::vector<std::size_t>;
+
+class dfa_builder
+{
+public:
+  dfa_builder(const nfa_builder &nfa, const nfa_builder::fragment whole, const std::size_t max_states)
+    : nfa_{ nfa.states }, start_{ whole.start }, final_{ whole.end }, max_states_{ max_states }
+  {}
+
+  regex_dfa_tables build()
+  {
+    compute_byte_classes();
+
+    // state 0: dead, state 1: start
+    add_state({}, false);
+    add_state(useful(closure({ start_ }, true, false)), true);
+
+    for (std::size_t state = 0; state < sets_.size(); ++state) {
+      for (std::size_t byte_class = 0; byte_class < class_count_; ++byte_class) {
+        transitions_.push_back(next(state, representatives_[byte_class]));
+      }
+    }
+
+    return minimize();
+  }
+
+private:
+  static constexpr std::uint8_t accept_none = 0;
+  static constexpr std::uint8_t accept_now = 1;
+  static constexpr std::uint8_t accept_at_end = 2;
+
+  void compute_byte_classes()
+  {
+    std::array<bool, 257> boundary{};
+    boundary[0] = true;
+    for (const auto &state : nfa_) {
+      for (const auto &[first, last, target] : state.bytes) {
+        boundary[first] = true;
+        boundary[static_cast<std::size_t>(last) + 1] = true;
+      }
+    }
+    std::size_t current = 0;
+    for (std::size_t byte = 0; byte < 256; ++byte) {
+      if (byte != 0 && boundary[byte]) { ++current; }
+      if (boundary[byte]) { representatives_.push_back(static_cast<std::uint8_t>(byte)); }
+      tables_.byte_class[byte] = static_cast<std::uint8_t>(current);
+    }
+    class_count_ = current + 1;
+  }
+
+  [[nodiscard]] state_set closure(state_set states, const bool at_begin, const bool at_end) const
+  {
+    std::vector<bool> seen(nfa_.size());
+    std::vector<std::size_t> stack{ states.begin(), states.end() };
+    states.clear();
+    while (!stack.empty()) {
+      const auto state = stack.back();
+      stack.pop_back();
+      if (seen[state]) { continue; }
+      seen[state] = true;
+      states.push_back(state);
+      const auto follow = [&](const std::vector<std::size_t> &targets) {
+        for (const auto target : targets) {
+          if (!seen[target]) { stack.push_back(target); }
+        }
+      };
+      follow(nfa_[state].epsilon);
+      if (at_begin) { follow(nfa_[state].at_begin); }
+      if (at_end) { follow(nfa_[state].at_end); }
+    }
+    std::sort(states.begin(), states.end());
+    return states;
+  }
+
+  // drops states that can neither consume input nor accept, so that patterns anchored
+  // with '^' reach the dead state once the anchor can no longer match
+  [[nodiscard]] state_set useful(state_set states) const
+  {
+    states.erase(std::remove_if(states.begin(),
+                   states.end(),
+                   [&](const auto state) {
+                     return state != final_ && nfa_[state].bytes.empty() && nfa_[state].at_end.empty();
+                   }),
+      states.end());
+    return states;
+  }
+
+  std::uint8_t accept_value(const state_set &states, const bool at_begin) const
+  {
+    if (std::binary_search(states.begin(), states.end(), final_)) { return accept_now; }
+    const auto at_end = closure(states, at_begin, true);
+    if (std::binary_search(at_end.begin(), at_end.end(), final_)) { return accept_at_end; }
+    return accept_none;
+  }
+
+  std::uint16_t add_state(state_set states, const bool initial)
+  {
+    if (!initial) {
+      if (const auto found = ids_.find(states); found != ids_.end()) { return found->second; }
+    }
+    if (sets_.size() >= max_states_) { throw unsupported_pattern("DFA too large"); }
+
+    const auto id = static_cast<std::uint16_t>(sets_.size());
+    accept_.push_back(accept_value(states, initial));
+    if (!initial) { ids_.emplace(states, id); }
+    sets_.push_back(std::move(states));
+    return id;
+  }
+
+  std::uint16_t next(const std::size_t state, const std::uint8_t byte)
+  {
+    // a match has been found, the search stops here
+    if (accept_[state] == accept_now) { return static_cast<std::uint16_t>(state); }
+
+    // searching restarts the pattern at every position
+    state_set moved{ start_ };
+    for (const auto nfa_state : sets_[state]) {
+      for (const auto &[first, last, target] : nfa_[nfa_state].bytes) {
+        if (byte >= first && byte <= last) { moved.push_back(target); }
+      }
+    }
+    return add_state(useful(closure(std::move(moved), false, false)), false);
+  }
+
+  // Moore's partition refinement, keeping the dead state as 0 and the start as 1
+  regex_dfa_tables minimize()
+  {
+    const auto count = sets_.size();
+    std::vector<std::size_t> block(count);
+    for (std::size_t state = 0; state < count; ++state) { block[state] = accept_[state]; }
+
+    std::size_t block_count = 0;
+    while (true) {
+      std::map<std::vector<std::size_t>, std::size_t> signatures;
+      std::vector<std::size_t> refined(count);
+      for (std::size_t state = 0; state < count; ++state) {
+        std::vector<std::size_t> signature{ block[state] };
+        for (std::size_t byte_class = 0; byte_class < class_count_; ++byte_class) {
+          signature.push_back(block[transitions_[state * class_count_ + byte_class]]);
+        }
+        refined[state] = signatures.try_emplace(std::move(signature), signatures.size()).first->second;
+      }
+      const bool stable = signatures.size() == block_count;
+      block_count = signatures.size();
+      block = std::move(refined);
+      if (stable) { break; }
+    }
+
+    // the dead block becomes 0, the start block 1 (a separate copy if the pattern can never match)
+    std::vector<std::size_t> renumbered(block_count, count);
+    std::vector<std::size_t> representative;
+    const auto assign = [&](const std::size_t state) {
+      representative.push_back(state);
+      return representative.size() - 1;
+    };
+    renumbered[block[0]] = assign(0);
+    const auto start = assign(1);
+    if (block[1] != block[0]) { renumbered[block[1]] = start; }
+    for (std::size_t state = 2; state < count; ++state) {
+      if (renumbered[block[state]] == count) { renumbered[block[state]] = assign(state); }
+    }
+
+    // byte classes that only differed in states merged away are merged too
+    std::map<std::vector<std::uint16_t>, std::size_t> columns;
+    std::vector<std::size_t> merged_class(class_count_);
+    for (std::size_t byte_class = 0; byte_class < class_count_; ++byte_class) {
+      std::vector<std::uint16_t> column;
+      for (const auto state : representative) {
+        column.push_back(
+          static_cast<std::uint16_t>(renumbered[block[transitions_[state * class_count_ + byte_class]]]));
+      }
+      merged_class[byte_class] = columns.try_emplace(std::move(column), columns.size()).first->second;
+    }
+
+    tables_.class_count = columns.size();
+    tables_.state_count = representative.size();
+    tables_.transitions.resize(tables_.state_count * tables_.class_count);
+    for (const auto &[column, byte_class] : columns) {
+      for (std::size_t state = 0; state < column.size(); ++state) {
+        tables_.transitions[state * tables_.class_count + byte_class] = column[state];
+      }
+    }
+    for (const auto state : representative) { tables_.accept.push_back(accept_[state]); }
+    for (auto &byte_class : tables_.byte_class) { byte_class = static_cast<std::uint8_t>(merged_class[byte_class]); }
+    return tables_;
+  }
+
+  const std::vector<nfa_state> &nfa_;
+  std::size_t start_;
+  std::size_t final_;
+  std::size_t max_states_;
+
+  regex_dfa_tables tables_;
+  std::size_t class_count_{ 0 };
+  std::vector<std::uint8_t> representatives_;
+
+  std::vector<state_set> sets_;
+  std::map<state_set, std::uint16_t> ids_;
+  std::vector<std::uint8_t> accept_;
+  std::vector<std::uint16_t> transitions_;
+};
+
+}// namespace
+
+std::optional<regex_dfa_tables>
+  compile_regex_dfa(const std::string_view pattern, std::string *why_not, const std::size_t max_states)
+{
+  try {
+    const auto tree = pattern_parser{ pattern }.parse();
+    nfa_builder nfa;
+    const auto whole = nfa.build(tree);
+    return dfa_builder{ nfa, whole, std::min<std::size_t>(max_states, std::numeric_limits<std::uint16_t>::max()) }
+      .build();
+  } catch (const unsupported_pattern &e) {
+    if (why_not != nullptr) { *why_not = e.what(); }
+    return std::nullopt;
+  }
+}
@@ -0,0 +1,58 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSON2CPP_REGEX_DFA_HPP
+#define JSON2CPP_REGEX_DFA_HPP
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tables for `json2cpp::regex_dfa`, see include/json2cpp/json2cpp_regex.hpp.
+// State 0 is the dead state and state 1 the start state.
+struct regex_dfa_tables
+{
+  std::array<std::uint8_t, 256> byte_class{};
+  std::size_t class_count{ 0 };
+  std::size_t state_count{ 0 };
+  // next state, indexed by state * class_count + class
+  std::vector<std::uint16_t> transitions;
+  // one of the json2cpp::regex_dfa accept values per state
+  std::vector<std::uint8_t> accept;
+};
+
+// Compiles an ECMAScript pattern, as used by JSON Schema's `pattern` and
+// `patternProperties`, into a DFA implementing `std::regex_search` semantics
+// over UTF-8 input. `.`, classes and escapes match whole code points.
+//
+// Returns nullopt, with the reason in `why_not` if given, for patterns that need
+// backtracking features (backreferences, lookaround, word boundaries) or whose
+// DFA would exceed `max_states`; callers fall back to std::regex for those.
+std::optional<regex_dfa_tables>
+  compile_regex_dfa(std::string_view pattern, std::string *why_not = nullptr, std::size_t max_states = 4096);
+
+#endif
@@ -0,0 +1,1092 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "schema_compiler.hpp"
+#include "regex_dfa.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <map>
+#include <set>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+
+namespace {
+
+// A C++ string literal for `value`. Octal escapes are used for control
+// characters because, unlike hex escapes, they cannot swallow the next character.
+std::string cpp_string_literal(const std::string_view value)
+{
+  std::string result{ '"' };
+  for (const auto character : value) {
+    switch (character) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    case '?':
+      // avoid accidental trigraphs in pre-C++17 compilers reading the output
+      result += "\\?";
+      break;
+    default:
+      if (static_cast<unsigned char>(character) < 0x20) {
+        result += fmt::format("\\{:03o}", static_cast<unsigned char>(character));
+      } else {
+        result += character;
+      }
+    }
+  }
+  result += '"';
+  return result;
+}
+
+// an exact C++ literal for a JSON number
+std::string number_literal(const nlohmann::json &value)
+{
+  if (value.is_number_integer() && !value.is_number_unsigned()) {
+    return fmt::format("std::int64_t{{{}}}", value.get<std::int64_t>());
+  }
+  return fmt::format("double{{{:a}}}", value.get<double>());
+}
+
+std::string escape_pointer_token(const std::string_view token)
+{
+  std::string result;
+  for (const auto character : token) {
+    if (character == '~') {
+      result += "~0";
+    } else if (character == '/') {
+      result += "~1";
+    } else {
+      result += character;
+    }
+  }
+  return result;
+}
+
+}// namespace
+
+std::string ref_pointer(const std::string &ref)
+{
+  if (ref.empty() || ref.front() != '#') {
+    throw std::runtime_error(fmt::format("Only local $ref values are supported, found '{}'", ref));
+  }
+
+  std::string pointer;
+  for (std::size_t idx = 1; idx < ref.size(); ++idx) {
+    if (ref[idx] == '%' && idx + 2 < ref.size()) {
+      pointer += static_cast<char>(std::stoi(ref.substr(idx + 1, 2), nullptr, 16));
+      idx += 2;
+    } else {
+      pointer += ref[idx];
+    }
+  }
+  return pointer;
+}
+
+namespace {
+
+// keywords that validate the members of objects or elements of arrays, or the
+// whole value again, which makes it worth remembering the result per subtree
+constexpr std::array<const char *, 12> memoized_keywords{ "properties",
+  "patternProperties",
+  "additionalProperties",
+  "dependencies",
+  "items",
+  "additionalItems",
+  "contains",
+  "allOf",
+  "anyOf",
+  "oneOf",
+  "not",
+  "if" };
+
+constexpr std::string_view function_parameters =
+  "[[maybe_unused]] const JSON &value, [[maybe_unused]] ::json2cpp::validation::context &ctx, [[maybe_unused]] const "
+  "::json2cpp::validation::path_node &path";
+
+class validator_compiler
+{
+public:
+  explicit validator_compiler(const nlohmann::json &root) : root_{ root } {}
+
+  // Index of the function validating the subschema at `pointer`; functions are
+  // shared between identical subschemas and `$ref` chains are followed to their
+  // target, so a `$ref` costs one direct call
+  std::size_t function_for(std::string pointer)
+  {
+    std::set<std::string> seen;
+    const nlohmann::json *node = &resolve(pointer);
+    while (node->is_object() && node->contains("$ref")) {
+      if (!seen.insert(pointer).second) { throw std::runtime_error(fmt::format("Circular $ref at '{}'", pointer)); }
+      pointer = ref_pointer(node->at("$ref").get<std::string>());
+      node = &resolve(pointer);
+    }
+
+    auto [itr, inserted] = functions_.try_emplace(node->dump(), pending_.size());
+    if (inserted) { pending_.push_back(pointer); }
+    return itr->second;
+  }
+
+  std::vector<std::string> compile(const std::string_view document_name)
+  {
+    const auto root_function = function_for("");
+
+    std::vector<std::string> definitions;
+    for (std::size_t idx = 0; idx < pending_.size(); ++idx) {
+      // emit() may append to pending_, so it gets a copy of the location
+      const auto body = emit(idx, std::string{ pending_[idx] });
+      definitions.insert(definitions.end(), body.begin(), body.end());
+      emit_stream(idx, std::string{ pending_[idx] });
+    }
+
+    std::vector<std::string> lines;
+    lines.push_back(fmt::format("#ifndef {}_COMPILED_VALIDATOR", document_name));
+    lines.push_back(fmt::format("#define {}_COMPILED_VALIDATOR", document_name));
+    lines.emplace_back("");
+    lines.emplace_back("// Generated by json2cpp --validator, do not edit");
+    lines.emplace_back("");
+    lines.emplace_back("#include <json2cpp/json2cpp_validation.hpp>");
+    if (dfa_count_ > 0) { lines.emplace_back("#include <json2cpp/json2cpp_regex.hpp>"); }
+    if (regex_count_ > 0) { lines.emplace_back("#include <regex>"); }
+    lines.emplace_back("");
+    lines.push_back(fmt::format("namespace compiled_json::{}::validator {{", document_name));
+    lines.emplace_back("namespace detail {");
+    for (std::size_t idx = 0; idx < pending_.size(); ++idx) {
+      lines.push_back(fmt::format("template<typename JSON> bool validate_{}({});", idx, function_parameters));
+    }
+    lines.insert(lines.end(), support_.begin(), support_.end());
+    lines.insert(lines.end(), definitions.begin(), definitions.end());
+    lines.insert(lines.end(), stream_.begin(), stream_.end());
+    lines.emplace_back("}// namespace detail");
+
+    lines.push_back(fmt::format(R"(
+// Validates `document` against the schema, reporting failures through `ctx`
+template<typename JSON> [[nodiscard]] bool validate(const JSON &document, ::json2cpp::validation::context &ctx)
+{{
+  const ::json2cpp::validation::path_node root{{}};
+  return detail::validate_{}(document, ctx, root);
+}}
+
+// Returns true if `document` is valid, stopping at the first failure
+template<typename JSON> [[nodiscard]] bool validate(const JSON &document)
+{{
+  ::json2cpp::validation::context ctx;
+  return validate(document, ctx);
+}}
+
+// Every failure found in `document`, empty if it is valid
+template<typename JSON> [[nodiscard]] std::vector<::json2cpp::validation::error> errors(const JSON &document)
+{{
+  std::vector<::json2cpp::validation::error> result;
+  ::json2cpp::validation::context ctx{{ result }};
+  static_cast<void>(validate(document, ctx));
+  return result;
+}}
+
+// Tables for ::json2cpp::validation::stream_validator, which validates a document
+// while it is parsed
+template<typename JSON> const ::json2cpp::validation::stream_schema<JSON> &stream_schema()
+{{
+  static const ::json2cpp::validation::stream_schema<JSON> schema{{ {},
+    {{
+      {}
+    }} }};
+  return schema;
+}}
+}}// namespace compiled_json::{}::validator
+
+#endif)",
+      root_function,
+      root_function,
+      fmt::join(stream_nodes_, ",\n      "),
+      document_name));
+
+    spdlog::info("{} validation functions generated.", pending_.size());
+
+    return lines;
+  }
+
+private:
+  const nlohmann::json &resolve(const std::string &pointer) const
+  {
+    try {
+      return root_.at(nlohmann::json::json_pointer(pointer));
+    } catch (const nlohmann::json::exception &) {
+      throw std::runtime_error(fmt::format("Unable to resolve schema location '#{}'", pointer));
+    }
+  }
+
+  // an expression that is true if `pattern` matches somewhere in `text` (a std::string_view).
+  // Patterns are compiled to a DFA table here; the few that need backtracking
+  // fall back to a std::regex constructed on first use.
+  std::string pattern_search(const std::string &pattern, const std::string &text)
+  {
+    auto [itr, inserted] = patterns_.try_emplace(pattern, pattern_entry{ pattern_count_, false });
+    const auto &[index, dfa] = itr->second;
+    if (inserted) {
+      ++pattern_count_;
+      std::string why_not;
+      if (const auto tables = compile_regex_dfa(pattern, &why_not); tables) {
+        itr->second.dfa = true;
+        ++dfa_count_;
+        emit_dfa(index, pattern, *tables);
+      } else {
+        ++regex_count_;
+        spdlog::warn("pattern {} falls back to std::regex: {}", cpp_string_literal(pattern), why_not);
+        support_.push_back(fmt::format("inline const std::regex &pattern_{}()", index));
+        support_.emplace_back("{");
+        support_.push_back(fmt::format(
+          "  static const std::regex regex{{ {}, std::regex::ECMAScript }};", cpp_string_literal(pattern)));
+        support_.emplace_back("  return regex;");
+        support_.emplace_back("}");
+      }
+    }
+
+    if (dfa) { return fmt::format("pattern_{}.search({})", index, text); }
+    return fmt::format("std::regex_search({0}.data(), {0}.data() + {0}.size(), pattern_{1}())", text, index);
+  }
+
+  void emit_dfa(const std::size_t index, const std::string &pattern, const regex_dfa_tables &tables)
+  {
+    support_.push_back(fmt::format("// {}", cpp_string_literal(pattern)));
+    support_.push_back(fmt::format("inline constexpr ::json2cpp::regex_dfa<{}, {}> pattern_{}{{",
+      tables.state_count,
+      tables.class_count,
+      index));
+    support_.emplace_back("  { {");
+    for (std::size_t byte = 0; byte < tables.byte_class.size(); byte += 32) {
+      const auto row = tables.byte_class.begin() + static_cast<std::ptrdiff_t>(byte);
+      support_.push_back(fmt::format("    {},", fmt::join(row, row + 32, ", ")));
+    }
+    support_.emplace_back("  } },");
+    support_.emplace_back("  { {");
+    for (std::size_t state = 0; state < tables.state_count; ++state) {
+      const auto row = tables.transitions.begin() + static_cast<std::ptrdiff_t>(state * tables.class_count);
+      support_.push_back(
+        fmt::format("    {},", fmt::join(row, row + static_cast<std::ptrdiff_t>(tables.class_count), ", ")));
+    }
+    support_.emplace_back("  } },");
+    support_.push_back(fmt::format("  {{ {{ {} }} }}", fmt::join(tables.accept, ", ")));
+    support_.emplace_back("};");
+  }
+
+  // an expression that is true if `expression` (a JSON value) equals `constant`
+  std::string equals(const std::string &expression, const nlohmann::json &constant)
+  {
+    if (constant.is_null()) { return fmt::format("{}.is_null()", expression); }
+    if (constant.is_boolean()) {
+      return fmt::format("({0}.is_boolean() && {0}.template get<bool>() == {1})", expression, constant.get<bool>());
+    }
+    if (constant.is_number()) {
+      return fmt::format("::json2cpp::validation::number_equals({}, {})", expression, number_literal(constant));
+    }
+    if (constant.is_string()) {
+      return fmt::format(
+        "::json2cpp::validation::string_equals({}, {})", expression, cpp_string_literal(constant.get<std::string>()));
+    }
+
+    // structured constants get a helper function, emitted before the function using it
+    std::vector<std::string> body;
+    if (constant.is_array()) {
+      body.push_back(
+        fmt::format("  if (!value.is_array() || value.size() != {}) {{ return false; }}", constant.size()));
+      if (!constant.empty()) { body.emplace_back("  auto itr = value.begin();"); }
+      for (const auto &element : constant) {
+        body.push_back(fmt::format("  if (!({})) {{ return false; }}", equals("(*itr)", element)));
+        body.emplace_back("  ++itr;");
+      }
+    } else {
+      body.push_back(
+        fmt::format("  if (!value.is_object() || value.size() != {}) {{ return false; }}", constant.size()));
+      for (const auto &[key, member] : constant.items()) {
+        body.emplace_back("  {");
+        body.push_back(fmt::format(
+          "    const auto *member = ::json2cpp::validation::find_member(value, {});", cpp_string_literal(key)));
+        body.push_back(
+          fmt::format("    if (member == nullptr || !({})) {{ return false; }}", equals("(*member)", member)));
+        body.emplace_back("  }");
+      }
+    }
+
+    const auto index = constant_count_++;
+    support_.push_back(fmt::format("template<typename JSON> bool constant_{}(const JSON &value)", index));
+    support_.emplace_back("{");
+    support_.insert(support_.end(), body.begin(), body.end());
+    support_.emplace_back("  return true;");
+    support_.emplace_back("}");
+    return fmt::format("constant_{}({})", index, expression);
+  }
+
+  std::vector<std::string> emit(const std::size_t index, const std::string pointer)
+  {
+    const auto &schema = resolve(pointer);
+
+    std::vector<std::string> lines;
+    lines.push_back(fmt::format("// #{}", pointer));
+    lines.push_back(fmt::format("template<typename JSON> bool validate_{}({})", index, function_parameters));
+    lines.emplace_back("{");
+
+    if (schema.is_boolean()) {
+      if (schema.get<bool>()) {
+        lines.emplace_back("  return true;");
+      } else {
+        lines.emplace_back("  static_cast<void>(ctx.report(path, \"no value is allowed here\"));");
+        lines.emplace_back("  return false;");
+      }
+      lines.emplace_back("}");
+      return lines;
+    }
+
+    if (!schema.is_object()) { throw std::runtime_error(fmt::format("Schema at '#{}' is not an object", pointer)); }
+
+    for (const auto *unsupported : { "propertyNames", "$dynamicRef", "$recursiveRef", "unevaluatedProperties" }) {
+      if (schema.contains(unsupported)) {
+        throw std::runtime_error(fmt::format("Keyword '{}' at '#{}' is not supported", unsupported, pointer));
+      }
+    }
+
+    // subschemas that look inside objects and arrays remember their result for
+    // each distinct subtree when the context has a memo
+    const auto body_start = lines.size();
+    const bool memoize = std::any_of(memoized_keywords.begin(), memoized_keywords.end(), [&](const auto keyword) {
+      return schema.contains(keyword);
+    });
+    if (memoize) {
+      lines.push_back(
+        fmt::format("  return ::json2cpp::validation::memoized(ctx, {}, value, [&]() -> bool {{", index));
+    }
+
+    lines.emplace_back("  bool valid = true;");
+
+    const auto child = [&](const std::string_view keyword) {
+      return fmt::format("{}/{}", pointer, escape_pointer_token(keyword));
+    };
+    const auto check = [&](const std::string_view indent,
+                         const std::string &condition,
+                         const std::string &message,
+                         const std::string_view location = "path") {
+      lines.push_back(fmt::format("{}if (!({})) {{", indent, condition));
+      lines.push_back(fmt::format("{}  valid = false;", indent));
+      lines.push_back(fmt::format(
+        "{}  if (!ctx.report({}, {})) {{ return false; }}", indent, location, cpp_string_literal(message)));
+      lines.push_back(fmt::format("{}}}", indent));
+    };
+    const auto call = [&](const std::string_view indent,
+                        const std::string &subschema,
+                        const std::string_view target,
+                        const std::string_view location) {
+      lines.push_back(fmt::format(
+        "{}if (!validate_{}({}, ctx, {})) {{", indent, function_for(subschema), target, location));
+      lines.push_back(fmt::format("{}  valid = false;", indent));
+      lines.push_back(fmt::format("{}  if (!ctx.collecting()) {{ return false; }}", indent));
+      lines.push_back(fmt::format("{}}}", indent));
+    };
+    // a call for one member or element, which `checks` may run in parallel with the others
+    const auto member_call = [&](const std::string_view indent,
+                               const std::string &subschema,
+                               const std::string_view target,
+                               const std::string_view location) {
+      lines.push_back(fmt::format("{}if (!checks.run({}, [&checked = {}](auto &task_ctx, const auto &task_path) {{ "
+                                  "return validate_{}(checked, task_ctx, task_path); }})) {{",
+        indent,
+        location,
+        target,
+        function_for(subschema)));
+      lines.push_back(fmt::format("{}  valid = false;", indent));
+      lines.push_back(fmt::format("{}  if (!ctx.collecting()) {{ return false; }}", indent));
+      lines.push_back(fmt::format("{}}}", indent));
+    };
+    // waits for the member calls of one object or array
+    const auto finish_members = [&](const std::string_view indent) {
+      lines.push_back(fmt::format("{}if (!checks.finish()) {{", indent));
+      lines.push_back(fmt::format("{}  valid = false;", indent));
+      lines.push_back(fmt::format("{}  if (!ctx.collecting()) {{ return false; }}", indent));
+      lines.push_back(fmt::format("{}}}", indent));
+    };
+
+    emit_type(schema, check);
+    emit_enum(schema, check);
+    emit_number(schema, lines, check);
+    emit_string(schema, lines, check);
+    emit_array(schema, pointer, lines, check, member_call, finish_members);
+    emit_object(schema, pointer, lines, check, call, member_call, finish_members);
+
+    // combinators
+    if (schema.contains("allOf")) {
+      for (std::size_t idx = 0; idx < schema["allOf"].size(); ++idx) {
+        call("  ", fmt::format("{}/{}", child("allOf"), idx), "value", "path");
+      }
+    }
+
+    const auto branches = [&](const std::string_view keyword) {
+      std::vector<std::string> calls;
+      for (std::size_t idx = 0; idx < schema[keyword].size(); ++idx) {
+        calls.push_back(fmt::format(
+          "validate_{}(value, branch, path)", function_for(fmt::format("{}/{}", child(keyword), idx))));
+      }
+      if (calls.empty()) { calls.emplace_back("false"); }
+      return calls;
+    };
+
+    if (schema.contains("anyOf")) {
+      lines.emplace_back("  {");
+      lines.emplace_back("    auto branch = ctx.speculative();");
+      check("    ",
+        fmt::format("{}", fmt::join(branches("anyOf"), " || ")),
+        "value does not match any schema in anyOf");
+      lines.emplace_back("  }");
+    }
+
+    if (schema.contains("oneOf")) {
+      lines.emplace_back("  {");
+      lines.emplace_back("    auto branch = ctx.speculative();");
+      lines.emplace_back("    std::size_t matches = 0;");
+      for (const auto &branch_call : branches("oneOf")) {
+        lines.push_back(fmt::format("    if (matches < 2 && {}) {{ ++matches; }}", branch_call));
+      }
+      check("    ", "matches == 1", "value must match exactly one schema in oneOf");
+      lines.emplace_back("  }");
+    }
+
+    if (schema.contains("not")) {
+      lines.emplace_back("  {");
+      lines.emplace_back("    auto branch = ctx.speculative();");
+      check("    ",
+        fmt::format("!validate_{}(value, branch, path)", function_for(child("not"))),
+        "value must not match the schema in not");
+      lines.emplace_back("  }");
+    }
+
+    if (schema.contains("if") && (schema.contains("then") || schema.contains("else"))) {
+      lines.emplace_back("  {");
+      lines.emplace_back("    auto branch = ctx.speculative();");
+      lines.push_back(
+        fmt::format("    if (validate_{}(value, branch, path)) {{", function_for(child("if"))));
+      if (schema.contains("then")) { call("      ", child("then"), "value", "path"); }
+      lines.emplace_back("    } else {");
+      if (schema.contains("else")) { call("      ", child("else"), "value", "path"); }
+      lines.emplace_back("    }");
+      lines.emplace_back("  }");
+    }
+
+    lines.emplace_back("  return valid;");
+    if (memoize) {
+      // the checks become the body of the lambda opened above
+      std::for_each(lines.begin() + static_cast<std::ptrdiff_t>(body_start) + 1, lines.end(), [](auto &line) {
+        line.insert(0, "  ");
+      });
+      lines.emplace_back("  });");
+    }
+    lines.emplace_back("}");
+    return lines;
+  }
+
+  // Stream tables for the function at `index`. Objects and arrays can be checked
+  // member by member while they are parsed when the subschema has no keyword that
+  // needs the whole value: no enum, const or combinator, no uniqueItems, contains
+  // or tuple items, and only name list dependencies.
+  void emit_stream(const std::size_t index, const std::string pointer)
+  {
+    const auto &schema = resolve(pointer);
+    const auto has = [&](const char *keyword) { return schema.is_object() && schema.contains(keyword); };
+    const auto allows_type = [&](const std::string_view name) {
+      if (!has("type")) { return true; }
+      const auto types = schema["type"].is_array() ? schema["type"] : nlohmann::json::array({ schema["type"] });
+      return std::any_of(types.begin(), types.end(), [&](const auto &type) { return type == name; });
+    };
+
+    bool streamable = schema.is_object();
+    for (const auto *keyword : { "enum", "const", "allOf", "anyOf", "oneOf", "not", "if" }) {
+      streamable = streamable && !has(keyword);
+    }
+    if (streamable && has("dependencies")) {
+      for (const auto &[key, dependency] : schema["dependencies"].items()) {
+        streamable = streamable && dependency.is_array();
+      }
+    }
+
+    std::string object = "nullptr";
+    if (streamable && allows_type("object")) {
+      emit_stream_object(index, pointer);
+      object = fmt::format("&detail::stream_object_{}", index);
+    }
+
+    std::string array = "nullptr";
+    if (streamable && allows_type("array") && !has("contains") && !(has("uniqueItems") && schema["uniqueItems"] == true)
+        && !(has("items") && schema["items"].is_array())) {
+      emit_stream_array(index, pointer);
+      array = fmt::format("&detail::stream_array_{}", index);
+    }
+
+    stream_nodes_.push_back(fmt::format("{{ &detail::validate_{}<JSON>, {}, {} }}", index, object, array));
+  }
+
+  // true if the function at `index` accepts every value, so streaming can skip the value
+  bool accepts_anything(const std::size_t index) const
+  {
+    const auto &schema = resolve(pending_[index]);
+    return schema == true || (schema.is_object() && schema.empty());
+  }
+
+  // the stream_ version of a `check` in emit()
+  void stream_check(const std::string_view indent, const std::string &condition, const std::string &message)
+  {
+    stream_.push_back(fmt::format("{}if (!({})) {{", indent, condition));
+    stream_.push_back(fmt::format("{}  valid = false;", indent));
+    stream_.push_back(
+      fmt::format("{}  if (!ctx.report(path, {})) {{ return false; }}", indent, cpp_string_literal(message)));
+    stream_.push_back(fmt::format("{}}}", indent));
+  }
+
+  void emit_stream_object(const std::size_t index, const std::string &pointer)
+  {
+    // function_for() may grow pending_, which `resolve` results do not depend on
+    const auto &schema = resolve(pointer);
+    const auto has_object = [&](const char *keyword) {
+      return schema.contains(keyword) && schema[keyword].is_object();
+    };
+    const bool additional = schema.contains("additionalProperties") && schema["additionalProperties"] != true;
+
+    std::vector<std::string> body;
+    const auto target = [&](const std::string_view indent, const std::string &subschema) {
+      const auto function = function_for(subschema);
+      if (!accepts_anything(function)) { body.push_back(fmt::format("{}targets.push_back({});", indent, function)); }
+    };
+
+    if (additional) { body.emplace_back("  bool matched = false;"); }
+    if (has_object("properties") && !schema["properties"].empty()) {
+      std::vector<std::string> literals;
+      for (const auto &[key, subschema] : schema["properties"].items()) { literals.push_back(cpp_string_literal(key)); }
+      body.push_back(fmt::format("  static constexpr std::array<std::string_view, {}> keys{{ {{ {} }} }};",
+        literals.size(),
+        fmt::join(literals, ", ")));
+      body.emplace_back("  switch (::json2cpp::validation::find_key(keys, key)) {");
+      std::size_t position = 0;
+      for (const auto &[key, subschema] : schema["properties"].items()) {
+        body.push_back(fmt::format("  case {}:", position++));
+        if (additional) { body.emplace_back("    matched = true;"); }
+        target("    ", fmt::format("{}/properties/{}", pointer, escape_pointer_token(key)));
+        body.emplace_back("    break;");
+      }
+      body.emplace_back("  default:");
+      body.emplace_back("    break;");
+      body.emplace_back("  }");
+    }
+    if (has_object("patternProperties")) {
+      for (const auto &[pattern, subschema] : schema["patternProperties"].items()) {
+        body.push_back(fmt::format("  if ({}) {{", pattern_search(pattern, "key")));
+        if (additional) { body.emplace_back("    matched = true;"); }
+        target("    ", fmt::format("{}/patternProperties/{}", pointer, escape_pointer_token(pattern)));
+        body.emplace_back("  }");
+      }
+    }
+    if (additional) {
+      if (schema["additionalProperties"] == false) {
+        body.emplace_back("  if (!matched) { return false; }");
+      } else {
+        body.emplace_back("  if (!matched) {");
+        target("    ", fmt::format("{}/additionalProperties", pointer));
+        body.emplace_back("  }");
+      }
+    }
+
+    stream_.push_back(fmt::format("inline bool stream_members_{}([[maybe_unused]] const std::string_view key, "
+                                  "[[maybe_unused]] std::vector<std::size_t> &targets)",
+      index));
+    stream_.emplace_back("{");
+    stream_.insert(stream_.end(), body.begin(), body.end());
+    stream_.emplace_back("  return true;");
+    stream_.emplace_back("}");
+
+    stream_.push_back(fmt::format("inline bool stream_keys_{}([[maybe_unused]] const std::vector<std::string> &keys, "
+                                  "[[maybe_unused]] ::json2cpp::validation::context &ctx, [[maybe_unused]] const "
+                                  "::json2cpp::validation::path_node &path)",
+      index));
+    stream_.emplace_back("{");
+    stream_.emplace_back("  bool valid = true;");
+    if (schema.contains("minProperties")) {
+      const auto count = schema["minProperties"].get<std::size_t>();
+      stream_check("  ",
+        fmt::format("keys.size() >= {}", count),
+        fmt::format("object must have at least {} properties", count));
+    }
+    if (schema.contains("maxProperties")) {
+      const auto count = schema["maxProperties"].get<std::size_t>();
+      stream_check("  ",
+        fmt::format("keys.size() <= {}", count),
+        fmt::format("object must have at most {} properties", count));
+    }
+    if (schema.contains("required")) {
+      std::set<std::string> seen;
+      for (const auto &key : schema["required"]) {
+        const auto name = key.get<std::string>();
+        if (!seen.insert(name).second) { continue; }
+        stream_check("  ",
+          fmt::format("::json2cpp::validation::contains_key(keys, {})", cpp_string_literal(name)),
+          fmt::format("missing required property \"{}\"", name));
+      }
+    }
+    if (has_object("dependencies")) {
+      for (const auto &[key, dependency] : schema["dependencies"].items()) {
+        stream_.push_back(
+          fmt::format("  if (::json2cpp::validation::contains_key(keys, {})) {{", cpp_string_literal(key)));
+        for (const nlohmann::json &name : dependency) {
+          stream_check("    ",
+            fmt::format("::json2cpp::validation::contains_key(keys, {})", cpp_string_literal(name.get<std::string>())),
+            fmt::format("property \"{}\" requires property \"{}\"", key, name.get<std::string>()));
+        }
+        stream_.emplace_back("  }");
+      }
+    }
+    stream_.emplace_back("  return valid;");
+    stream_.emplace_back("}");
+
+    stream_.push_back(fmt::format(
+      "inline constexpr ::json2cpp::validation::stream_object stream_object_{0}{{ &stream_members_{0}, "
+      "&stream_keys_{0} }};",
+      index));
+  }
+
+  void emit_stream_array(const std::size_t index, const std::string &pointer)
+  {
+    const auto &schema = resolve(pointer);
+
+    std::string items = "::json2cpp::validation::npos";
+    if (schema.contains("items")) {
+      const auto function = function_for(fmt::format("{}/items", pointer));
+      if (!accepts_anything(function)) { items = std::to_string(function); }
+    }
+
+    stream_.push_back(fmt::format("inline bool stream_count_{}([[maybe_unused]] const std::size_t count, "
+                                  "[[maybe_unused]] ::json2cpp::validation::context &ctx, [[maybe_unused]] const "
+                                  "::json2cpp::validation::path_node &path)",
+      index));
+    stream_.emplace_back("{");
+    stream_.emplace_back("  bool valid = true;");
+    if (schema.contains("minItems")) {
+      const auto count = schema["minItems"].get<std::size_t>();
+      stream_check("  ", fmt::format("count >= {}", count), fmt::format("array must have at least {} items", count));
+    }
+    if (schema.contains("maxItems")) {
+      const auto count = schema["maxItems"].get<std::size_t>();
+      stream_check("  ", fmt::format("count <= {}", count), fmt::format("array must have at most {} items", count));
+    }
+    stream_.emplace_back("  return valid;");
+    stream_.emplace_back("}");
+
+    stream_.push_back(fmt::format(
+      "inline constexpr ::json2cpp::validation::stream_array stream_array_{0}{{ {1}, &stream_count_{0} }};",
+      index,
+      items));
+  }
+
+  template<typename Check> void emit_type(const nlohmann::json &schema, Check &&check)
+  {
+    if (!schema.contains("type")) { return; }
+
+    const auto types = schema["type"].is_array() ? schema["type"] : nlohmann::json::array({ schema["type"] });
+    std::vector<std::string> conditions;
+    std::vector<std::string> names;
+    for (const auto &type : types) {
+      const auto name = type.get<std::string>();
+      names.push_back(name);
+      if (name == "null") {
+        conditions.emplace_back("value.is_null()");
+      } else if (name == "boolean") {
+        conditions.emplace_back("value.is_boolean()");
+      } else if (name == "object") {
+        conditions.emplace_back("value.is_object()");
+      } else if (name == "array") {
+        conditions.emplace_back("value.is_array()");
+      } else if (name == "number") {
+        conditions.emplace_back("value.is_number()");
+      } else if (name == "integer") {
+        conditions.emplace_back("value.is_number_integer()");
+      } else if (name == "string") {
+        conditions.emplace_back("value.is_string()");
+      } else {
+        throw std::runtime_error(fmt::format("Unknown type '{}' in schema", name));
+      }
+    }
+
+    check("  ",
+      fmt::format("{}", fmt::join(conditions, " || ")),
+      fmt::format("value is not of type {}", fmt::join(names, " or ")));
+  }
+
+  template<typename Check> void emit_enum(const nlohmann::json &schema, Check &&check)
+  {
+    if (schema.contains("const")) {
+      check("  ", equals("value", schema["const"]), fmt::format("value must be {}", schema["const"].dump()));
+    }
+
+    if (!schema.contains("enum")) { return; }
+    const auto &values = schema["enum"];
+
+    if (!values.empty()
+        && std::all_of(values.begin(), values.end(), [](const auto &value) { return value.is_string(); })) {
+      // string enums, the common case, are a binary search over the sorted values
+      std::set<std::string> sorted;
+      for (const auto &value : values) { sorted.insert(value.get<std::string>()); }
+      std::vector<std::string> literals;
+      std::transform(sorted.begin(), sorted.end(), std::back_inserter(literals), cpp_string_literal);
+
+      const auto index = enum_count_++;
+      support_.push_back(fmt::format("inline constexpr std::array<std::string_view, {}> enum_{}{{ {{ {} }} }};",
+        literals.size(),
+        index,
+        fmt::join(literals, ", ")));
+      check("  ",
+        fmt::format("value.is_string() && ::json2cpp::validation::find_key(enum_{}, "
+                    "::json2cpp::validation::string_of(value)) != ::json2cpp::validation::npos",
+          index),
+        "value is not one of the enumerated values");
+      return;
+    }
+
+    std::vector<std::string> conditions;
+    for (const auto &value : values) { conditions.push_back(equals("value", value)); }
+    if (conditions.empty()) { conditions.emplace_back("false"); }
+    check("  ", fmt::format("{}", fmt::join(conditions, " || ")), "value is not one of the enumerated values");
+  }
+
+  template<typename Check>
+  static void emit_number(const nlohmann::json &schema, std::vector<std::string> &lines, Check &&check)
+  {
+    const auto has = [&](const char *keyword) { return schema.contains(keyword) && schema[keyword].is_number(); };
+    if (!has("minimum") && !has("maximum") && !has("exclusiveMinimum") && !has("exclusiveMaximum")
+        && !has("multipleOf")) {
+      return;
+    }
+
+    lines.emplace_back("  if (value.is_number()) {");
+    lines.emplace_back("    const auto number = ::json2cpp::validation::number_of(value);");
+
+    // draft 4 spells exclusive bounds as a boolean next to minimum and maximum,
+    // later drafts as a number of their own
+    const auto flag = [&](const char *keyword) {
+      return schema.contains(keyword) && schema[keyword].is_boolean() && schema[keyword].get<bool>();
+    };
+    const auto bound = [&](const char *keyword, const bool exclusive, const char *op, const char *description) {
+      const auto &limit = schema[keyword];
+      check("    ",
+        fmt::format("number {}{} {}", op, exclusive ? "" : "=", fmt::format("{:a}", limit.get<double>())),
+        fmt::format("value must be {}{} {}", description, exclusive ? "" : " or equal to", limit.dump()));
+    };
+
+    if (has("minimum")) { bound("minimum", flag("exclusiveMinimum"), ">", "greater than"); }
+    if (has("maximum")) { bound("maximum", flag("exclusiveMaximum"), "<", "less than"); }
+    if (has("exclusiveMinimum")) { bound("exclusiveMinimum", true, ">", "greater than"); }
+    if (has("exclusiveMaximum")) { bound("exclusiveMaximum", true, "<", "less than"); }
+    if (has("multipleOf")) {
+      check("    ",
+        fmt::format("::json2cpp::validation::is_multiple_of(number, {:a})", schema["multipleOf"].get<double>()),
+        fmt::format("value must be a multiple of {}", schema["multipleOf"].dump()));
+    }
+    lines.emplace_back("  }");
+  }
+
+  template<typename Check>
+  void emit_string(const nlohmann::json &schema, std::vector<std::string> &lines, Check &&check)
+  {
+    if (!schema.contains("minLength") && !schema.contains("maxLength") && !schema.contains("pattern")) { return; }
+
+    lines.emplace_back("  if (value.is_string()) {");
+    lines.emplace_back("    const auto text = ::json2cpp::validation::string_of(value);");
+    if (schema.contains("minLength")) {
+      const auto length = schema["minLength"].get<std::size_t>();
+      check("    ",
+        fmt::format("::json2cpp::validation::utf8_length(text) >= {}", length),
+        fmt::format("string must be at least {} characters long", length));
+    }
+    if (schema.contains("maxLength")) {
+      const auto length = schema["maxLength"].get<std::size_t>();
+      check("    ",
+        fmt::format("::json2cpp::validation::utf8_length(text) <= {}", length),
+        fmt::format("string must be at most {} characters long", length));
+    }
+    if (schema.contains("pattern")) {
+      const auto pattern = schema["pattern"].get<std::string>();
+      check("    ",
+        pattern_search(pattern, "text"),
+        fmt::format("string does not match pattern {}", pattern));
+    }
+    lines.emplace_back("  }");
+  }
+
+  template<typename Check, typename MemberCall, typename Finish>
+  void emit_array(const nlohmann::json &schema,
+    const std::string &pointer,
+    std::vector<std::string> &lines,
+    Check &&check,
+    MemberCall &&call,
+    Finish &&finish_members)
+  {
+    const bool tuple = schema.contains("items") && schema["items"].is_array();
+    const bool items = schema.contains("items") && !tuple && schema["items"] != true;
+    const bool additional = tuple && schema.contains("additionalItems") && schema["additionalItems"] != true;
+    if (!schema.contains("minItems") && !schema.contains("maxItems") && !schema.contains("uniqueItems") && !items
+        && !tuple && !schema.contains("contains")) {
+      return;
+    }
+
+    lines.emplace_back("  if (value.is_array()) {");
+    if (schema.contains("minItems")) {
+      const auto count = schema["minItems"].get<std::size_t>();
+      check("    ", fmt::format("value.size() >= {}", count), fmt::format("array must have at least {} items", count));
+    }
+    if (schema.contains("maxItems")) {
+      const auto count = schema["maxItems"].get<std::size_t>();
+      check("    ", fmt::format("value.size() <= {}", count), fmt::format("array must have at most {} items", count));
+    }
+    if (schema.contains("uniqueItems") && schema["uniqueItems"] == true) {
+      check("    ", "::json2cpp::validation::has_unique_items(value)", "array items must be unique");
+    }
+    if (schema.contains("contains")) {
+      lines.emplace_back("    {");
+      lines.emplace_back("      auto branch = ctx.speculative();");
+      lines.emplace_back("      bool found = false;");
+      lines.push_back(fmt::format(
+        "      for (auto itr = value.begin(); !found && itr != value.end(); ++itr) {{ found = validate_{}(*itr, "
+        "branch, path); }}",
+        function_for(fmt::format("{}/contains", pointer))));
+      check("      ", "found", "array does not contain a matching item");
+      lines.emplace_back("    }");
+    }
+
+    if (items || tuple) {
+      lines.emplace_back("    ::json2cpp::validation::deferred_checks checks{ ctx, value.size() };");
+      lines.emplace_back("    std::size_t index = 0;");
+      lines.emplace_back("    for (auto itr = value.begin(); itr != value.end(); ++itr, ++index) {");
+      lines.emplace_back("      const ::json2cpp::validation::path_node element_path{ path, index };");
+      if (items) {
+        call("      ", fmt::format("{}/items", pointer), "*itr", "element_path");
+      } else {
+        lines.emplace_back("      switch (index) {");
+        for (std::size_t idx = 0; idx < schema["items"].size(); ++idx) {
+          lines.push_back(fmt::format("      case {}:", idx));
+          call("        ", fmt::format("{}/items/{}", pointer, idx), "*itr", "element_path");
+          lines.emplace_back("        break;");
+        }
+        lines.emplace_back("      default:");
+        if (additional && schema["additionalItems"] == false) {
+          check("        ", "false", "additional items are not allowed", "element_path");
+        } else if (additional) {
+          call("        ", fmt::format("{}/additionalItems", pointer), "*itr", "element_path");
+        }
+        lines.emplace_back("        break;");
+        lines.emplace_back("      }");
+      }
+      lines.emplace_back("    }");
+      finish_members("    ");
+    }
+    lines.emplace_back("  }");
+  }
+
+  template<typename Check, typename Call, typename MemberCall, typename Finish>
+  void emit_object(const nlohmann::json &schema,
+    const std::string &pointer,
+    std::vector<std::string> &lines,
+    Check &&check,
+    Call &&call,
+    MemberCall &&member_call,
+    Finish &&finish_members)
+  {
+    const auto has_object = [&](const char *keyword) {
+      return schema.contains(keyword) && schema[keyword].is_object();
+    };
+    const bool additional = schema.contains("additionalProperties") && schema["additionalProperties"] != true;
+    const bool has_required = schema.contains("required") && !schema["required"].empty();
+
+    if (!schema.contains("minProperties") && !schema.contains("maxProperties") && !has_object("properties")
+        && !has_object("patternProperties") && !additional && !has_required && !has_object("dependencies")) {
+      return;
+    }
+
+    lines.emplace_back("  if (value.is_object()) {");
+    if (schema.contains("minProperties")) {
+      const auto count = schema["minProperties"].get<std::size_t>();
+      check("    ",
+        fmt::format("value.size() >= {}", count),
+        fmt::format("object must have at least {} properties", count));
+    }
+    if (schema.contains("maxProperties")) {
+      const auto count = schema["maxProperties"].get<std::size_t>();
+      check("    ",
+        fmt::format("value.size() <= {}", count),
+        fmt::format("object must have at most {} properties", count));
+    }
+
+    // every key named by properties or required, sorted for find_key
+    std::map<std::string, std::pair<bool, std::size_t>> keys;
+    constexpr auto not_required = static_cast<std::size_t>(-1);
+    if (has_object("properties")) {
+      for (const auto &[key, subschema] : schema["properties"].items()) { keys[key] = { true, not_required }; }
+    }
+    std::vector<std::string> required;
+    if (has_required) {
+      for (const auto &key : schema["required"]) {
+        const auto name = key.get<std::string>();
+        if (keys.count(name) != 0 && keys[name].second != not_required) { continue; }
+        keys.try_emplace(name, false, not_required);
+        keys[name].second = required.size();
+        required.push_back(name);
+      }
+      lines.push_back(fmt::format("    std::array<bool, {}> required_found{{}};", required.size()));
+    }
+
+    const bool patterns = has_object("patternProperties") && !schema["patternProperties"].empty();
+    if (!keys.empty() || patterns || additional) {
+      lines.emplace_back("    ::json2cpp::validation::deferred_checks checks{ ctx, value.size() };");
+      lines.emplace_back("    for (auto itr = value.begin(); itr != value.end(); ++itr) {");
+      lines.emplace_back("      const std::string_view key = itr.key();");
+      lines.emplace_back("      const auto &member = itr.value();");
+      lines.emplace_back("      const ::json2cpp::validation::path_node member_path{ path, key };");
+      if (additional) { lines.emplace_back("      bool matched = false;"); }
+
+      if (!keys.empty()) {
+        std::vector<std::string> literals;
+        for (const auto &key : keys) { literals.push_back(cpp_string_literal(key.first)); }
+        lines.push_back(fmt::format("      static constexpr std::array<std::string_view, {}> keys{{ {{ {} }} }};",
+          literals.size(),
+          fmt::join(literals, ", ")));
+        lines.emplace_back("      switch (::json2cpp::validation::find_key(keys, key)) {");
+        std::size_t position = 0;
+        for (const auto &[key, info] : keys) {
+          lines.push_back(fmt::format("      case {}:", position++));
+          if (info.second != not_required) {
+            lines.push_back(fmt::format("        required_found[{}] = true;", info.second));
+          }
+          if (info.first) {
+            if (additional) { lines.emplace_back("        matched = true;"); }
+            member_call("        ",
+              fmt::format("{}/properties/{}", pointer, escape_pointer_token(key)),
+              "member",
+              "member_path");
+          }
+          lines.emplace_back("        break;");
+        }
+        lines.emplace_back("      default:");
+        lines.emplace_back("        break;");
+        lines.emplace_back("      }");
+      }
+
+      if (patterns) {
+        for (const auto &[pattern, subschema] : schema["patternProperties"].items()) {
+          lines.push_back(fmt::format("      if ({}) {{", pattern_search(pattern, "key")));
+          if (additional) { lines.emplace_back("        matched = true;"); }
+          member_call("        ",
+            fmt::format("{}/patternProperties/{}", pointer, escape_pointer_token(pattern)),
+            "member",
+            "member_path");
+          lines.emplace_back("      }");
+        }
+      }
+
+      if (additional) {
+        if (schema["additionalProperties"] == false) {
+          check("      ", "matched", "property is not allowed", "member_path");
+        } else {
+          lines.emplace_back("      if (!matched) {");
+          member_call("        ", fmt::format("{}/additionalProperties", pointer), "member", "member_path");
+          lines.emplace_back("      }");
+        }
+      }
+      lines.emplace_back("    }");
+      finish_members("    ");
+    }
+
+    for (std::size_t idx = 0; idx < required.size(); ++idx) {
+      check("    ",
+        fmt::format("required_found[{}]", idx),
+        fmt::format("missing required property \"{}\"", required[idx]));
+    }
+
+    if (has_object("dependencies")) {
+      for (const auto &[key, dependency] : schema["dependencies"].items()) {
+        lines.push_back(fmt::format(
+          "    if (::json2cpp::validation::find_member(value, {}) != nullptr) {{", cpp_string_literal(key)));
+        if (dependency.is_array()) {
+          for (const nlohmann::json &name : dependency) {
+            check("      ",
+              fmt::format("::json2cpp::validation::find_member(value, {}) != nullptr",
+                cpp_string_literal(name.get<std::string>())),
+              fmt::format("property \"{}\" requires property \"{}\"", key, name.get<std::string>()));
+          }
+        } else {
+          call("      ", fmt::format("{}/dependencies/{}", pointer, escape_pointer_token(key)), "value", "path");
+        }
+        lines.emplace_back("    }");
+      }
+    }
+    lines.emplace_back("  }");
+  }
+
+  const nlohmann::json &root_;
+  // serialized subschema -> function index
+  std::map<std::string, std::size_t> functions_;
+  // the location of the first subschema compiled into each function
+  std::vector<std::string> pending_;
+  // helper functions for patterns and structured constants
+  std::vector<std::string> support_;
+  // member dispatch functions for streaming, and one stream_node per function
+  std::vector<std::string> stream_;
+  std::vector<std::string> stream_nodes_;
+  struct pattern_entry
+  {
+    std::size_t index;
+    bool dfa;
+  };
+  std::map<std::string, pattern_entry> patterns_;
+  std::size_t pattern_count_{ 0 };
+  std::size_t dfa_count_{ 0 };
+  std::size_t regex_count_{ 0 };
+  std::size_t constant_count_{ 0 };
+  std::size_t enum_count_{ 0 };
+};
+
+}// namespace
+
+std::vector<std::string> compile_validator(const std::string_view document_name, const nlohmann::json &schema)
+{
+  return validator_compiler{ schema }.compile(document_name);
+}
+
+void write_validator(const std::vector<std::string> &lines, const std::filesystem::path &base_output)
+{
+  auto validator_name = base_output;
+  validator_name += "_validator.hpp";
+
+  std::ofstream output(validator_name);
+  for (const auto &line : lines) { output << line << '\n'; }
+}
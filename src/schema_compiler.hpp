@@ -0,0 +1,49 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSON2CPP_SCHEMA_COMPILER_HPP
+#define JSON2CPP_SCHEMA_COMPILER_HPP
+
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Generates the lines of a header declaring `compiled_json::<document_name>::validator`,
+// a set of validation functions specialized for `schema`. Every distinct subschema
+// becomes one function template, `$ref`s become direct calls to the function of
+// their target, and type, range, length, required, enum and property checks are
+// emitted inline. Only local references ("#...") are supported; anything the
+// generator cannot express throws std::runtime_error.
+std::vector<std::string> compile_validator(std::string_view document_name, const nlohmann::json &schema);
+
+// The JSON Pointer named by a local `$ref` such as "#/definitions/name"; throws
+// std::runtime_error for anything but a local reference
+std::string ref_pointer(const std::string &ref);
+
+// Writes the lines from `compile_validator` to `<base_output>_validator.hpp`
+void write_validator(const std::vector<std::string> &lines, const std::filesystem::path &base_output);
+
+#endif
@@ -0,0 +1,147 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "schema_defaults.hpp"
+#include "schema_compiler.hpp"
+#include <fmt/format.h>
+#include <map>
+#include <regex>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+class default_filler
+{
+public:
+  explicit default_filler(const nlohmann::json &root) : root_{ root } {}
+
+  void fill(const nlohmann::json &schema, nlohmann::json &value)
+  {
+    const auto &resolved = resolve(schema);
+    if (!resolved.is_object()) { return; }
+
+    if (const auto all = resolved.find("allOf"); all != resolved.end() && all->is_array()) {
+      for (const auto &subschema : *all) { fill(subschema, value); }
+    }
+
+    if (value.is_object()) {
+      fill_object(resolved, value);
+    } else if (value.is_array()) {
+      fill_array(resolved, value);
+    }
+  }
+
+  [[nodiscard]] std::size_t filled() const noexcept { return filled_; }
+
+private:
+  void fill_object(const nlohmann::json &schema, nlohmann::json &value)
+  {
+    static const nlohmann::json empty = nlohmann::json::object();
+    const auto properties_itr = schema.find("properties");
+    const auto &properties = properties_itr != schema.end() && properties_itr->is_object() ? *properties_itr : empty;
+    const auto patterns_itr = schema.find("patternProperties");
+    const auto &patterns = patterns_itr != schema.end() && patterns_itr->is_object() ? *patterns_itr : empty;
+    const auto additional = schema.find("additionalProperties");
+
+    for (const auto &[name, subschema] : properties.items()) {
+      const auto &resolved = resolve(subschema);
+      if (resolved.is_object() && resolved.contains("default") && !value.contains(name)) {
+        value[name] = resolved["default"];
+        ++filled_;
+      }
+    }
+
+    for (auto &[name, member] : value.items()) {
+      bool matched = false;
+      if (const auto property = properties.find(name); property != properties.end()) {
+        matched = true;
+        fill(*property, member);
+      }
+      for (const auto &[pattern, subschema] : patterns.items()) {
+        if (!std::regex_search(name, regex(pattern))) { continue; }
+        matched = true;
+        fill(subschema, member);
+      }
+      if (!matched && additional != schema.end()) { fill(*additional, member); }
+    }
+  }
+
+  void fill_array(const nlohmann::json &schema, nlohmann::json &value)
+  {
+    const auto items = schema.find("items");
+    if (items == schema.end()) { return; }
+    if (!items->is_array()) {
+      for (auto &element : value) { fill(*items, element); }
+      return;
+    }
+
+    const auto additional = schema.find("additionalItems");
+    for (std::size_t idx = 0; idx < value.size(); ++idx) {
+      if (idx < items->size()) {
+        fill((*items)[idx], value[idx]);
+      } else if (additional != schema.end()) {
+        fill(*additional, value[idx]);
+      }
+    }
+  }
+
+  // follows `$ref` chains to the subschema they name
+  [[nodiscard]] const nlohmann::json &resolve(const nlohmann::json &schema) const
+  {
+    const nlohmann::json *node = &schema;
+    std::set<std::string> seen;
+    while (node->is_object() && node->contains("$ref")) {
+      const auto pointer = ref_pointer(node->at("$ref").get<std::string>());
+      if (!seen.insert(pointer).second) {
+        throw std::runtime_error(fmt::format("Circular $ref at '{}' while applying schema defaults", pointer));
+      }
+      node = &root_.at(nlohmann::json::json_pointer(pointer));
+    }
+    return *node;
+  }
+
+  [[nodiscard]] const std::regex &regex(const std::string &pattern)
+  {
+    auto found = patterns_.find(pattern);
+    if (found == patterns_.end()) {
+      found = patterns_.emplace(pattern, std::regex(pattern, std::regex::ECMAScript)).first;
+    }
+    return found->second;
+  }
+
+  const nlohmann::json &root_;
+  std::map<std::string, std::regex> patterns_;
+  std::size_t filled_{ 0 };
+};
+
+}// namespace
+
+std::size_t apply_schema_defaults(const nlohmann::json &schema, nlohmann::json &document)
+{
+  default_filler filler(schema);
+  filler.fill(schema, document);
+  return filler.filled();
+}
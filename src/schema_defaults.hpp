@@ -0,0 +1,41 @@
+/*
+MIT License
+
+Copyright (c) 2022 Jason Turner
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef JSON2CPP_SCHEMA_DEFAULTS_HPP
+#define JSON2CPP_SCHEMA_DEFAULTS_HPP
+
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+// Adds to every object of `document` the properties that `schema` declares with a
+// `default` but the object lacks, so that reading them from the compiled document
+// succeeds on the first lookup and never needs the schema. Subschemas are found
+// through properties, patternProperties, additionalProperties, items,
+// additionalItems, allOf and local `$ref`s; anyOf, oneOf and if/then/else are not
+// followed because which branch applies depends on validation. Objects the
+// document does not have are not created, but defaults are filled inside a
+// default that is itself an object. Returns the number of properties added.
+std::size_t apply_schema_defaults(const nlohmann::json &schema, nlohmann::json &document);
+
+#endif
@@ -22,6 +22,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #ifdef __GNUC__
@@ -33,17 +35,37 @@ SOFTWARE.
 #pragma GCC diagnostic pop
 #endif
 #include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <CLI/CLI.hpp>
 #include <spdlog/spdlog.h>
 
 #include <json2cpp/json2cpp_adapter.hpp>
+#include <json2cpp/json2cpp_parallel_validation.hpp>
+#include <json2cpp/json2cpp_schema_subset.hpp>
+#include <json2cpp/json2cpp_stream_validation.hpp>
+#include <json2cpp/json2cpp_thread_pool.hpp>
 #include <valijson/adapters/nlohmann_json_adapter.hpp>
 #include <valijson/schema.hpp>
 #include <valijson/schema_parser.hpp>
 #include <valijson/validator.hpp>
 
 #include "schema.hpp"
+// generated next to schema.hpp by json2cpp --validator
+#include "schema_validator.hpp"
 
 
 bool validate(const std::filesystem::path &schema_file_name, const std::filesystem::path &file_to_validate)
@@ -90,7 +112,7 @@ bool validate(const std::filesystem::path &schema_file_name, const std::filesyst
   return result;
 }
 
-bool validate_internal(const std::filesystem::path &file_to_validate)
+bool validate_internal(const std::filesystem::path &file_to_validate, const bool lazy)
 {
   using valijson::Schema;
   using valijson::SchemaParser;
@@ -98,29 +120,353 @@ bool validate_internal(const std::filesystem::path &file_to_validate)
   using valijson::adapters::json2cppJsonAdapter;
   using valijson::adapters::NlohmannJsonAdapter;
 
+  spdlog::info("Creating nlohmann::json object");
+  nlohmann::json document;
+  spdlog::info("Opening json file");
+  std::ifstream input_file(file_to_validate);
+  spdlog::info("Loading json file");
+  input_file >> document;
+
   // Parse JSON schema content using valijson
   spdlog::info("Creating Schema object");
   Schema mySchema;
   spdlog::info("Creating SchemaParser object");
   SchemaParser parser;
+  // with --lazy only the object types present in the document are populated
+  std::optional<json2cpp::schema_subset> subset;
+  if (lazy) {
+    subset.emplace(compiled_json::energyplus_schema::get(), document);
+    spdlog::info("Populating {} of the schema's object types", subset->property_count());
+  }
   spdlog::info("Creating json2cppJsonAdapter object");
-  json2cppJsonAdapter mySchemaAdapter(compiled_json::energyplus_schema::get());
+  json2cppJsonAdapter mySchemaAdapter(subset ? subset->get() : compiled_json::energyplus_schema::get());
   spdlog::info("parser.populateSchema object");
   parser.populateSchema(mySchemaAdapter, mySchema);
 
   spdlog::info("Creating Validator object");
   Validator validator;
+  spdlog::info("Creating NlohmannJsonAdapter object");
+  NlohmannJsonAdapter myTargetAdapter(document);
+
+  spdlog::info("validator.validate");
+  const auto result = validator.validate(mySchema, myTargetAdapter, nullptr);
+  spdlog::info("returning result {}", result);
+
+  return result;
+}
+
+// entries of the memo used by --memoize, 8 MiB
+constexpr std::size_t memo_entries = std::size_t{ 1 } << 20U;
+
+void report_memo(const json2cpp::validation::memo &results)
+{
+  const auto stats = results.stats();
+  spdlog::info("memo: {} lookups, {} hits, {:.1f}% hit rate",
+    stats.lookups,
+    stats.hits,
+    100.0 * stats.hit_rate());
+}
+
+bool validate_generated(const std::filesystem::path &file_to_validate, const std::size_t threads, const bool memoize)
+{
   spdlog::info("Creating nlohmann::json object");
   nlohmann::json document;
   spdlog::info("Opening json file");
   std::ifstream input_file(file_to_validate);
   spdlog::info("Loading json file");
   input_file >> document;
-  spdlog::info("Creating NlohmannJsonAdapter object");
-  NlohmannJsonAdapter myTargetAdapter(document);
 
-  spdlog::info("validator.validate");
-  const auto result = validator.validate(mySchema, myTargetAdapter, nullptr);
+  // the schema was compiled into dedicated validation functions by json2cpp --validator,
+  // there is nothing to populate at runtime
+  std::vector<json2cpp::validation::error> errors;
+  std::optional<json2cpp::thread_pool> pool;
+  std::optional<json2cpp::validation::pool_executor> parallel;
+  json2cpp::validation::context ctx{ errors };
+  if (threads > 1) {
+    // large objects and arrays are split into tasks; the errors come out in the
+    // same order whatever the number of threads
+    spdlog::info("validator::validate on {} threads", threads);
+    pool.emplace(threads);
+    parallel.emplace(*pool);
+    ctx = json2cpp::validation::context{ errors, *parallel };
+  }
+
+  json2cpp::validation::memo results{ memo_entries };
+  json2cpp::validation::subtree_hashes hashes;
+  if (memoize) {
+    // identical subtrees, such as repeated constructions or schedules, are checked once
+    spdlog::info("Hashing subtrees");
+    hashes = json2cpp::validation::subtree_hashes{ document, results };
+    ctx.use_memo(results, hashes);
+  }
+
+  spdlog::info("validator::validate");
+  static_cast<void>(compiled_json::energyplus_schema::validator::validate(document, ctx));
+  if (memoize) { report_memo(results); }
+  for (const auto &error : errors) { spdlog::error("{}: {}", error.path, error.message); }
+  spdlog::info("returning result {}", errors.empty());
+
+  return errors.empty();
+}
+
+// The outcome of validating one document of a batch
+struct batch_result
+{
+  std::filesystem::path file;
+  std::uintmax_t bytes{ 0 };
+  bool valid{ false };
+  // why the document could not be read or parsed, empty if it was validated
+  std::string failure;
+  double milliseconds{ 0 };
+};
+
+// the files named in `inputs`, with directories replaced by the *.json and *.epJSON files below them
+std::vector<std::filesystem::path> collect_documents(const std::vector<std::filesystem::path> &inputs)
+{
+  std::vector<std::filesystem::path> documents;
+  for (const auto &input : inputs) {
+    if (!std::filesystem::is_directory(input)) {
+      documents.push_back(input);
+      continue;
+    }
+
+    std::vector<std::filesystem::path> found;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(input)) {
+      const auto extension = entry.path().extension();
+      if (entry.is_regular_file() && (extension == ".json" || extension == ".epJSON")) {
+        found.push_back(entry.path());
+      }
+    }
+    std::sort(found.begin(), found.end());
+    documents.insert(documents.end(), found.begin(), found.end());
+  }
+  return documents;
+}
+
+// Loads and checks every file on `pool`. `check(slot, document)` gets a slot in
+// [0, pool.size()] that no other thread uses at the same time, for per-thread
+// state: the worker index, or pool.size() for the thread waiting on the batch.
+template<typename Check>
+std::vector<batch_result>
+  validate_batch(const std::vector<std::filesystem::path> &files, json2cpp::thread_pool &pool, const Check &check)
+{
+  std::vector<batch_result> results(files.size());
+  json2cpp::task_group group(pool);
+
+  for (std::size_t idx = 0; idx < files.size(); ++idx) {
+    group.run([&, idx] {
+      auto &result = results[idx];
+      result.file = files[idx];
+      const auto start = std::chrono::steady_clock::now();
+      try {
+        result.bytes = std::filesystem::file_size(result.file);
+        nlohmann::json document;
+        std::ifstream input_file(result.file);
+        input_file >> document;
+        result.valid = check(std::min(pool.current_worker(), pool.size()), document);
+      } catch (const std::exception &e) {
+        result.failure = e.what();
+      }
+      result.milliseconds =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    });
+  }
+
+  group.wait();
+  return results;
+}
+
+// logs the per-file results in input order, then throughput and latency percentiles
+bool report_batch(const std::vector<batch_result> &results, const double seconds, const std::size_t threads)
+{
+  std::size_t valid = 0;
+  std::size_t invalid = 0;
+  std::size_t unreadable = 0;
+  std::uintmax_t bytes = 0;
+  std::vector<double> latencies;
+
+  for (const auto &result : results) {
+    if (!result.failure.empty()) {
+      ++unreadable;
+      spdlog::error("{}: {}", result.file.string(), result.failure);
+    } else if (result.valid) {
+      ++valid;
+      spdlog::info("{}: valid ({:.2f} ms)", result.file.string(), result.milliseconds);
+    } else {
+      ++invalid;
+      spdlog::warn("{}: invalid ({:.2f} ms)", result.file.string(), result.milliseconds);
+    }
+    bytes += result.bytes;
+    latencies.push_back(result.milliseconds);
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](const double fraction) {
+    if (latencies.empty()) { return 0.0; }
+    const auto rank = static_cast<std::size_t>(fraction * static_cast<double>(latencies.size() - 1) + 0.5);
+    return latencies[rank];
+  };
+
+  spdlog::info("{} documents on {} threads: {} valid, {} invalid, {} unreadable",
+    results.size(),
+    threads,
+    valid,
+    invalid,
+    unreadable);
+  if (seconds > 0) {
+    spdlog::info("{:.3f} s, {:.1f} documents/s, {:.1f} MiB/s",
+      seconds,
+      static_cast<double>(results.size()) / seconds,
+      static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds);
+  }
+  spdlog::info("latency ms: p50 {:.2f}  p90 {:.2f}  p99 {:.2f}  max {:.2f}",
+    percentile(0.5),
+    percentile(0.9),
+    percentile(0.99),
+    latencies.empty() ? 0.0 : latencies.back());
+
+  return invalid == 0 && unreadable == 0;
+}
+
+bool validate_many(const std::filesystem::path &schema_file_name,
+  const std::vector<std::filesystem::path> &inputs,
+  const std::size_t threads,
+  const bool internal,
+  const bool generated,
+  const bool memoize)
+{
+  using valijson::Schema;
+  using valijson::SchemaParser;
+  using valijson::Validator;
+  using valijson::adapters::json2cppJsonAdapter;
+  using valijson::adapters::NlohmannJsonAdapter;
+
+  const auto files = collect_documents(inputs);
+  json2cpp::thread_pool pool(threads);
+  spdlog::info("Validating {} documents on {} threads", files.size(), pool.size());
+
+  std::vector<batch_result> results;
+  const auto start = std::chrono::steady_clock::now();
+
+  if (generated) {
+    // with --memoize the documents share one memo, so subtrees repeated across
+    // documents are checked once for the whole batch
+    json2cpp::validation::memo memo_results{ memo_entries };
+    results = validate_batch(files, pool, [&](std::size_t, const nlohmann::json &document) {
+      if (!memoize) { return compiled_json::energyplus_schema::validator::validate(document); }
+      const json2cpp::validation::subtree_hashes hashes{ document };
+      json2cpp::validation::context ctx;
+      ctx.use_memo(memo_results, hashes);
+      return compiled_json::energyplus_schema::validator::validate(document, ctx);
+    });
+    if (memoize) { report_memo(memo_results); }
+  } else {
+    // the Schema is populated once and only read while validating; a Validator
+    // caches compiled regexes, so every thread gets its own
+    Schema mySchema;
+    SchemaParser parser;
+    nlohmann::json schema;
+    if (internal) {
+      parser.populateSchema(json2cppJsonAdapter(compiled_json::energyplus_schema::get()), mySchema);
+    } else {
+      std::ifstream schema_file(schema_file_name);
+      schema_file >> schema;
+      parser.populateSchema(NlohmannJsonAdapter(schema), mySchema);
+    }
+    spdlog::info("Schema populated in {:.1f} ms",
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+    std::vector<Validator> validators(pool.size() + 1);
+    results = validate_batch(files, pool, [&](const std::size_t slot, const nlohmann::json &document) {
+      return validators[slot].validate(mySchema, NlohmannJsonAdapter(document), nullptr);
+    });
+  }
+
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return report_batch(results, seconds, pool.size());
+}
+
+// The contents of a file, memory-mapped where the platform supports it so that
+// large documents are paged in as the parser reaches them
+class mapped_file
+{
+public:
+  explicit mapped_file(const std::filesystem::path &file)
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    const int descriptor = ::open(file.c_str(), O_RDONLY);
+    if (descriptor < 0) { throw std::runtime_error("Unable to open " + file.string()); }
+    struct stat status
+    {
+    };
+    if (::fstat(descriptor, &status) != 0) {
+      ::close(descriptor);
+      throw std::runtime_error("Unable to read the size of " + file.string());
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ != 0) {
+      void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+      if (mapping == MAP_FAILED) {
+        ::close(descriptor);
+        throw std::runtime_error("Unable to map " + file.string());
+      }
+      ::madvise(mapping, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const char *>(mapping);
+    }
+    ::close(descriptor);
+#else
+    std::ifstream input(file, std::ios::binary);
+    if (!input) { throw std::runtime_error("Unable to open " + file.string()); }
+    std::ostringstream buffer;
+    buffer << input.rdbuf();
+    contents_ = buffer.str();
+    data_ = contents_.data();
+    size_ = contents_.size();
+#endif
+  }
+
+  mapped_file(const mapped_file &) = delete;
+  mapped_file &operator=(const mapped_file &) = delete;
+  mapped_file(mapped_file &&) = delete;
+  mapped_file &operator=(mapped_file &&) = delete;
+
+  ~mapped_file()
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    if (data_ != nullptr) { ::munmap(const_cast<char *>(data_), size_); }
+#endif
+  }
+
+  [[nodiscard]] std::string_view contents() const noexcept { return { data_, size_ }; }
+
+private:
+  const char *data_{ nullptr };
+  std::size_t size_{ 0 };
+#if !(defined(__unix__) || defined(__APPLE__))
+  std::string contents_;
+#endif
+};
+
+bool validate_streaming(const std::filesystem::path &file_to_validate, const bool stop_at_first_error)
+{
+  spdlog::info("Mapping json file");
+  const mapped_file input(file_to_validate);
+
+  // errors are logged as the parser reaches them; no nlohmann::json of the whole
+  // document is ever built
+  json2cpp::validation::stream_options options;
+  options.stop_at_first_error = stop_at_first_error;
+  options.on_error = [](const json2cpp::validation::error &error) {
+    spdlog::error("{}: {}", error.path, error.message);
+  };
+
+  spdlog::info("Validating while parsing");
+  const auto contents = input.contents();
+  const auto result = json2cpp::validation::validate_stream(
+    compiled_json::energyplus_schema::validator::stream_schema<nlohmann::json>(),
+    contents.data(),
+    contents.data() + contents.size(),
+    std::move(options));
   spdlog::info("returning result {}", result);
 
   return result;
@@ -156,6 +502,41 @@ void walk_internal(std::int64_t &int_sum,
   }
 }
 
+// the same walk over a compiled document, switching on each node's type once
+void walk_internal(std::int64_t &int_sum,
+  double &double_sum,
+  std::size_t &string_sizes,
+  int &null_count,
+  int &array_count,
+  int &object_count,
+  const json2cpp::json &obj)
+{
+  json2cpp::visit(
+    [&](const auto &value) {
+      using type = std::decay_t<decltype(value)>;
+      if constexpr (std::is_same_v<type, std::int64_t> || std::is_same_v<type, std::uint64_t>) {
+        int_sum += static_cast<std::int64_t>(value);
+      } else if constexpr (std::is_same_v<type, double>) {
+        double_sum += value;
+      } else if constexpr (std::is_same_v<type, std::string_view>) {
+        string_sizes += value.size();
+      } else if constexpr (std::is_same_v<type, std::nullptr_t>) {
+        ++null_count;
+      } else if constexpr (std::is_same_v<type, json2cpp::array_t>) {
+        ++array_count;
+        for (const auto &child : value) {
+          walk_internal(int_sum, double_sum, string_sizes, null_count, array_count, object_count, child);
+        }
+      } else if constexpr (std::is_same_v<type, json2cpp::object_t>) {
+        ++object_count;
+        for (const auto &member : value) {
+          walk_internal(int_sum, double_sum, string_sizes, null_count, array_count, object_count, member.second);
+        }
+      }
+    },
+    obj);
+}
+
 template<typename JSON> void walk(const JSON &objects)
 {
   std::int64_t int_sum{};
@@ -181,14 +562,39 @@ int main(int argc, const char **argv)
     std::filesystem::path schema_file_name;
     std::filesystem::path document_to_validate;
 
+    std::vector<std::filesystem::path> batch;
+    std::size_t threads = std::thread::hardware_concurrency();
+
     bool do_walk = false;
     bool internal = false;
+    bool generated = false;
+    bool stream = false;
+    bool stop_at_first_error = false;
+    bool memoize = false;
+    bool lazy = false;
     bool show_version = false;
     app.add_option("<schema_file>", schema_file_name);
     auto *doc = app.add_option("<document_to_validate>", document_to_validate);
     app.add_flag("--version", show_version, "Show version information");
     app.add_flag("--walk", do_walk, "Just walk the schema and count objects (perf test)")->excludes(doc);
     app.add_flag("--internal", internal, "Use internal schema");
+    app.add_flag(
+      "--generated", generated, "Use the validator generated from the internal schema by json2cpp --validator");
+    app.add_flag("--stream",
+      stream,
+      "Validate with the generated validator while parsing the memory-mapped document, without loading it");
+    app.add_flag("--stop-at-first-error", stop_at_first_error, "With --stream, stop reading at the first error");
+    app.add_flag("--lazy",
+      lazy,
+      "With --internal, populate only the schema of the object types the document contains");
+    app.add_flag("--memoize",
+      memoize,
+      "With --generated, validate each distinct subtree once per subschema and report the memo hit rate");
+    app.add_option("--batch",
+         batch,
+         "Validate these files, and the *.json and *.epJSON files below these directories, sharing one schema")
+      ->excludes(doc);
+    app.add_option("--threads", threads, "Worker threads used by --batch, and by --generated for a single document");
 
     CLI11_PARSE(app, argc, argv);
 
@@ -207,8 +613,17 @@ int main(int argc, const char **argv)
       return EXIT_SUCCESS;
     }
 
-    if (internal) {
-      validate_internal(document_to_validate);
+    if (!batch.empty()) {
+      const bool valid = validate_many(schema_file_name, batch, threads, internal, generated, memoize);
+      return valid ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (stream) {
+      validate_streaming(document_to_validate, stop_at_first_error);
+    } else if (generated) {
+      validate_generated(document_to_validate, threads, memoize);
+    } else if (internal) {
+      validate_internal(document_to_validate, lazy);
     } else {
       validate(schema_file_name, document_to_validate);
     }
@@ -1,5 +1,7 @@
 #include "test_json_impl.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <json2cpp/json2cpp_cursor.hpp>
+#include <type_traits>
 
 
 TEST_CASE("Can read object size")
@@ -31,3 +33,93 @@ TEST_CASE("Can read iterator key")
 
   STATIC_REQUIRE(document.begin().key() == "glossary");
 }
+
+constexpr auto glossary_entry_key(const std::size_t idx)
+{
+  constexpr auto &document = compiled_json::test_json::impl::document;// NOLINT No, I'm not going to mark this `const`
+
+  return document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"].keys()[idx];
+}
+
+TEST_CASE("Can index keys and values of an object")
+{
+  constexpr auto &document = compiled_json::test_json::impl::document;// NOLINT No, I'm not going to mark this `const`
+
+  STATIC_REQUIRE(glossary_entry_key(2) == "GlossDef");
+  STATIC_REQUIRE(document["glossary"].values()[1].get<std::string_view>() == "example glossary");
+  STATIC_REQUIRE(document["glossary"].end() - document["glossary"].begin() == 2);
+  STATIC_REQUIRE((document["glossary"].begin() + 1)->get<std::string_view>() == "example glossary");
+}
+
+struct string_totals
+{
+  std::size_t strings{ 0 };
+  std::size_t length{ 0 };
+};
+
+// the number of strings under `node` and their total length
+constexpr string_totals count_strings(const json2cpp::json &node)
+{
+  return json2cpp::visit(
+    [](const auto &value) {
+      using type = std::decay_t<decltype(value)>;
+      string_totals totals;
+      if constexpr (std::is_same_v<type, std::string_view>) {
+        totals.strings = 1;
+        totals.length = value.size();
+      } else if constexpr (std::is_same_v<type, json2cpp::array_t>) {
+        for (const auto &child : value) {
+          const auto child_totals = count_strings(child);
+          totals.strings += child_totals.strings;
+          totals.length += child_totals.length;
+        }
+      } else if constexpr (std::is_same_v<type, json2cpp::object_t>) {
+        for (const auto &member : value) {
+          const auto child_totals = count_strings(member.second);
+          totals.strings += child_totals.strings;
+          totals.length += child_totals.length;
+        }
+      }
+      return totals;
+    },
+    node);
+}
+
+TEST_CASE("Can visit values by type")
+{
+  constexpr auto &document = compiled_json::test_json::impl::document;// NOLINT No, I'm not going to mark this `const`
+
+  STATIC_REQUIRE(count_strings(document["glossary"]["title"]).length == 16);
+  STATIC_REQUIRE(count_strings(document).strings == 11);
+  STATIC_REQUIRE(
+    json2cpp::visit([](const auto &value) { return std::is_same_v<std::decay_t<decltype(value)>, std::nullptr_t>; },
+      document["glossary"]["GlossDiv"]["subtitle"]));
+}
+
+template<typename Cursor> constexpr std::size_t count_entries(Cursor cursor)
+{
+  std::size_t entries = 0;
+  for (; !cursor.done(); cursor.next()) { ++entries; }
+  return entries;
+}
+
+template<typename Cursor> constexpr json2cpp::cursor_entry last_entry(Cursor cursor)
+{
+  json2cpp::cursor_entry last{};
+  for (const auto &entry : cursor) { last = entry; }
+  return last;
+}
+
+TEST_CASE("Can walk a document without recursion")
+{
+  constexpr auto &document = compiled_json::test_json::impl::document;// NOLINT No, I'm not going to mark this `const`
+  constexpr auto depth = json2cpp::max_depth(document);
+
+  STATIC_REQUIRE(depth == 7);
+  STATIC_REQUIRE(count_entries(json2cpp::depth_first_cursor<depth>{ document }) == 19);
+  STATIC_REQUIRE(count_entries(json2cpp::breadth_first_cursor<depth>{ document }) == 19);
+  // "XML", the second element of the deepest array
+  STATIC_REQUIRE(last_entry(json2cpp::breadth_first_cursor<depth>{ document }).depth == 7);
+  STATIC_REQUIRE(last_entry(json2cpp::breadth_first_cursor<depth>{ document }).index == 1);
+  STATIC_REQUIRE(!last_entry(json2cpp::breadth_first_cursor<depth>{ document }).is_member);
+}
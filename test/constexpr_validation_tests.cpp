@@ -0,0 +1,67 @@
+#include "allof_integers_and_numbers.schema_impl.hpp"
+#include "array_doubles_10_20_30_40_impl.hpp"
+#include "array_integers_10_20_30_40_impl.hpp"
+#include "epjson_model.schema_impl.hpp"
+#include "test_json_impl.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <json2cpp/json2cpp_constexpr_validation.hpp>
+
+namespace {
+// NOLINTNEXTLINE No, I'm not going to mark these `const`
+constexpr auto &allof_schema = compiled_json::allof_integers_and_numbers_schema::impl::document;
+// NOLINTNEXTLINE
+constexpr auto &model_schema = compiled_json::epjson_model_schema::impl::document;
+
+constexpr bool matches(const std::string_view pattern, const std::string_view text)
+{
+  return json2cpp::schema_detail::search(pattern, text);
+}
+}// namespace
+
+TEST_CASE("A compiled document can be validated against a compiled schema at compile time")
+{
+  STATIC_REQUIRE(json2cpp::validate(allof_schema, compiled_json::array_integers_10_20_30_40::impl::document));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(allof_schema, compiled_json::array_doubles_10_20_30_40::impl::document));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(allof_schema, compiled_json::test_json::impl::document));
+}
+
+TEST_CASE("Compile time validation follows properties, patternProperties and local $refs")
+{
+  // the glossary is neither a Building nor a Version, so the required keywords fail
+  STATIC_REQUIRE_FALSE(json2cpp::validate(model_schema, compiled_json::test_json::impl::document));
+
+  constexpr auto &building = model_schema["properties"]["Building"]["patternProperties"][".*"]["properties"];
+  STATIC_REQUIRE(json2cpp::validate(building["terrain"], json2cpp::json{ std::string_view{ "City" } }));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(building["terrain"], json2cpp::json{ std::string_view{ "Mars" } }));
+  STATIC_REQUIRE(json2cpp::validate(building["north_axis"], json2cpp::json{ -360.0 }));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(building["north_axis"], json2cpp::json{ std::int64_t{ 361 } }));
+  STATIC_REQUIRE(json2cpp::validate(building["loads_convergence_tolerance_value"], json2cpp::json{ 0.5 }));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(building["loads_convergence_tolerance_value"], json2cpp::json{ 0.0 }));
+  STATIC_REQUIRE_FALSE(
+    json2cpp::validate(building["maximum_number_of_warmup_days"], json2cpp::json{ std::uint64_t{ 0 } }));
+
+  // "field" is reached through additionalProperties and a $ref into the definitions
+  constexpr auto &field = model_schema["definitions"]["field"];
+  constexpr auto &glossary = compiled_json::test_json::impl::document["glossary"];
+  constexpr auto &definition = glossary["GlossDiv"]["GlossList"]["GlossEntry"];
+  // GlossSeeAlso is an array of strings where a field only allows an array of objects
+  STATIC_REQUIRE_FALSE(
+    json2cpp::validate(model_schema["definitions"]["instance"], definition["GlossDef"], model_schema));
+  STATIC_REQUIRE(json2cpp::validate(field, json2cpp::json{ std::string_view{ "Zone 1" } }));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(field, json2cpp::json{ std::string_view{ "" } }));
+  STATIC_REQUIRE_FALSE(json2cpp::validate(field, json2cpp::json{ true }));
+}
+
+TEST_CASE("Compile time patterns use ECMAScript search semantics")
+{
+  STATIC_REQUIRE(matches("^[0-9]+\\.[0-9]+$", "22.2"));
+  STATIC_REQUIRE_FALSE(matches("^[0-9]+\\.[0-9]+$", "22."));
+  STATIC_REQUIRE(matches("^.*\\S.*$", "  a  "));
+  STATIC_REQUIRE_FALSE(matches("^.*\\S.*$", "   "));
+  STATIC_REQUIRE(matches("b{2,3}", "abbc"));
+  STATIC_REQUIRE_FALSE(matches("^ab{2,3}c$", "abbbbc"));
+  STATIC_REQUIRE(matches("^[^a-c]x?$", "d"));
+  STATIC_REQUIRE(matches("^.$", "é"));
+  STATIC_REQUIRE_FALSE(matches("^..$", "é"));
+  STATIC_REQUIRE(matches("^\\w+\\s\\d*?$", "snake_case 42"));
+}
@@ -0,0 +1,63 @@
+// Built with JSON2CPP_PROFILE defined, so the runtime records what it is asked for
+#include "test_json.hpp"
+#include "test_json_impl.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <json2cpp/json2cpp_parser.hpp>
+#include <json2cpp/json2cpp_profile.hpp>
+#include <sstream>
+#include <string>
+
+namespace {
+// the recorded node at `pointer` in a profile written by write_profile
+const json2cpp::json *profiled_node(const json2cpp::json &profile, const std::string_view pointer)
+{
+  for (const auto &node : profile["nodes"]) {
+    if (node["pointer"].get<std::string_view>() == pointer) { return &node; }
+  }
+  return nullptr;
+}
+}// namespace
+
+TEST_CASE("Profiling does not get in the way of constant evaluation")
+{
+  STATIC_REQUIRE(compiled_json::test_json::impl::document["glossary"]["title"].get<std::string_view>()
+                 == "example glossary");
+}
+
+TEST_CASE("Lookups, key comparisons and touches are recorded per node")
+{
+  json2cpp::reset_profile();
+
+  const auto &document = compiled_json::test_json::get();
+  const auto &entry = document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+  for (int idx = 0; idx < 3; ++idx) { REQUIRE(entry["GlossSee"].get<std::string_view>() == "markup"); }
+  REQUIRE(entry.find("Missing") == entry.end());
+  REQUIRE(document["glossary"]["GlossDiv"]["title"].get<std::string_view>() == "S");
+
+  std::ostringstream out;
+  json2cpp::write_profile(out, document);
+  const auto text = out.str();
+  const auto profile = json2cpp::parse(text);
+
+  REQUIRE(profile.root()["json2cpp_profile"].get<std::int64_t>() == 1);
+
+  const auto *root = profiled_node(profile.root(), "");
+  REQUIRE(root != nullptr);
+  REQUIRE((*root)["touches"].get<std::int64_t>() == 2);
+  REQUIRE((*root)["keys"]["glossary"]["lookups"].get<std::int64_t>() == 2);
+
+  // members are sorted, so GlossSee is the fourth of seven keys compared
+  const auto *glossary_entry = profiled_node(profile.root(), "/glossary/GlossDiv/GlossList/GlossEntry");
+  REQUIRE(glossary_entry != nullptr);
+  REQUIRE((*glossary_entry)["keys"]["GlossSee"]["lookups"].get<std::int64_t>() == 3);
+  REQUIRE((*glossary_entry)["keys"]["GlossSee"]["comparisons"].get<std::int64_t>() == 12);
+  REQUIRE((*glossary_entry)["keys"]["Missing"]["comparisons"].get<std::int64_t>() == 7);
+
+  // never reached, so left out
+  REQUIRE(profiled_node(profile.root(), "/glossary/GlossDiv/GlossList/GlossEntry/GlossDef") == nullptr);
+
+  json2cpp::reset_profile();
+  std::ostringstream empty;
+  json2cpp::write_profile(empty, document);
+  REQUIRE(empty.str() == "{\"json2cpp_profile\":1,\"nodes\":[]}\n");
+}
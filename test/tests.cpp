@@ -1,5 +1,34 @@
+#include "epjson_model_compressed.hpp"
+#include "refbldg_medium_office_text.hpp"
 #include "test_json.hpp"
+#include "test_json_defaults.hpp"
+#include "test_json_hashes.hpp"
+#include "test_json_profiled.hpp"
+#include "test_json_sections.hpp"
+#include "test_json_subset.hpp"
+#include "test_json_text.hpp"
+#include <algorithm>
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <json2cpp/json2cpp_compressed.hpp>
+#include <json2cpp/json2cpp_cursor.hpp>
+#include <json2cpp/json2cpp_hash.hpp>
+#include <json2cpp/json2cpp_overlay.hpp>
+#include <json2cpp/json2cpp_parallel.hpp>
+#include <json2cpp/json2cpp_parser.hpp>
+#include <json2cpp/json2cpp_schema_subset.hpp>
+#include <json2cpp/json2cpp_serializer.hpp>
+#include <json2cpp/json2cpp_thread_pool.hpp>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Can read object size")
 {
@@ -27,3 +56,571 @@ TEST_CASE("Can read iterator key")
   const auto &document = compiled_json::test_json::get();
   REQUIRE(document.begin().key() == "glossary");
 }
+
+TEST_CASE("Object members can be iterated as keys, values and items")
+{
+  const auto &entry = compiled_json::test_json::get()["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+
+  // compiled objects are sorted, so keys can be searched by bisection
+  const auto keys = entry.keys();
+  const auto found = std::lower_bound(keys.begin(), keys.end(), std::string_view{ "GlossTerm" });
+  REQUIRE(found != keys.end());
+  REQUIRE(found.value().get<std::string_view>() == "Standard Generalized Markup Language");
+  REQUIRE(std::distance(keys.begin(), found) == 4);
+  REQUIRE(entry.values()[4] == *std::next(entry.begin(), 4));
+
+  std::size_t string_sizes = 0;
+  for (const auto &[key, value] : entry.items()) {
+    if (value.is_string()) { string_sizes += key.size() + value.get<std::string_view>().size(); }
+  }
+  REQUIRE(string_sizes == 105);
+
+  const auto &see_also = entry["GlossDef"]["GlossSeeAlso"];
+  REQUIRE(std::prev(see_also.end())->get<std::string_view>() == "XML");
+  REQUIRE(see_also.begin()[1] == see_also.array_data()[1]);
+  REQUIRE_THROWS_AS(see_also.keys(), std::runtime_error);
+
+#if defined(__cpp_lib_ranges)
+  STATIC_REQUIRE(std::random_access_iterator<json2cpp::json::iterator>);
+  STATIC_REQUIRE(std::random_access_iterator<json2cpp::json::key_iterator>);
+  STATIC_REQUIRE(std::random_access_iterator<json2cpp::json::item_iterator>);
+#endif
+}
+
+TEST_CASE("Schema defaults are compiled into the document")
+{
+  const auto &entry = compiled_json::test_json_defaults::get()["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+
+  REQUIRE(entry["Language"].get<std::string_view>() == "en");
+  REQUIRE(entry["GlossDef"]["Revision"].get<std::int64_t>() == 1);
+  REQUIRE(entry["GlossDef"]["Reviewed"].get<bool>() == false);
+
+  // values present in the input are kept
+  REQUIRE(entry["Acronym"].get<std::string_view>() == "SGML");
+  REQUIRE(entry["GlossDef"]["GlossSeeAlso"].size() == 2);
+
+  // and nothing else changes
+  const auto &original = compiled_json::test_json::get()["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+  REQUIRE(entry.size() == original.size() + 1);
+  REQUIRE(entry["GlossDef"].size() == original["GlossDef"].size() + 2);
+}
+
+TEST_CASE("Thread pool runs every task of a group")
+{
+  json2cpp::thread_pool pool(4);
+  json2cpp::task_group group(pool);
+  std::atomic<int> count{ 0 };
+  for (int idx = 0; idx < 1000; ++idx) {
+    group.run([&] { ++count; });
+  }
+  group.wait();
+  REQUIRE(count == 1000);
+}
+
+namespace {
+std::size_t count_leaves(json2cpp::thread_pool &pool, const std::size_t depth)
+{
+  if (depth == 0) { return 1; }
+  std::size_t left = 0;
+  std::size_t right = 0;
+  json2cpp::task_group group(pool);
+  group.run([&] { left = count_leaves(pool, depth - 1); });
+  group.run([&] { right = count_leaves(pool, depth - 1); });
+  group.wait();
+  return left + right;
+}
+}// namespace
+
+TEST_CASE("Task groups can be waited for from inside the pool")
+{
+  json2cpp::thread_pool pool(2);
+  REQUIRE(count_leaves(pool, 10) == 1024);
+}
+
+TEST_CASE("Task group rethrows the exception of a task")
+{
+  json2cpp::thread_pool pool(2);
+  json2cpp::task_group group(pool);
+  group.run([] { throw std::runtime_error("task failed"); });
+  REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+}
+
+TEST_CASE("Parallel walks visit every node once whatever the plan")
+{
+  std::string text = "[";
+  for (int idx = 0; idx < 3000; ++idx) {
+    if (idx != 0) { text += ','; }
+    text += R"({"id": )" + std::to_string(idx) + R"(, "tags": ["a", "bc"], "child": {"id": 1}})";
+  }
+  text += ']';
+  const auto parsed = json2cpp::parse(text);
+
+  json2cpp::thread_pool pool(4);
+  const auto count_and_sum = [](std::pair<std::size_t, std::int64_t> &totals, const json2cpp::json &node) {
+    ++totals.first;
+    if (node.is_number_integer()) { totals.second += node.get<std::int64_t>(); }
+  };
+  const auto add = [](std::pair<std::size_t, std::int64_t> lhs, const std::pair<std::size_t, std::int64_t> &rhs) {
+    return std::pair{ lhs.first + rhs.first, lhs.second + rhs.second };
+  };
+
+  // 3000 elements of 7 nodes and the array itself
+  constexpr std::pair<std::size_t, std::int64_t> expected{ 21001, 2999 * 3000 / 2 + 3000 };
+  const json2cpp::walk_plan plan{ parsed.root(), pool.size() };
+  REQUIRE(plan.node_count() == expected.first);
+  REQUIRE(plan.tasks().size() > 1);
+  const auto totals = json2cpp::parallel_reduce(pool, plan, std::pair<std::size_t, std::int64_t>{}, count_and_sum, add);
+  REQUIRE(totals == expected);
+
+  // one node per task, splitting every container
+  const auto &document = compiled_json::test_json::get();
+  const json2cpp::walk_plan fine{ document, 4, 4, 1 };
+  std::atomic<std::size_t> visits{ 0 };
+  json2cpp::parallel_walk(pool, fine, [&](const json2cpp::json &) { ++visits; });
+  REQUIRE(visits == fine.node_count());
+  REQUIRE(fine.split_nodes().size() > 1);
+
+  // a scalar is a plan of its own
+  std::atomic<std::size_t> scalars{ 0 };
+  json2cpp::parallel_walk(pool, document["glossary"]["title"], [&](const json2cpp::json &) { ++scalars; });
+  REQUIRE(scalars == 1);
+}
+
+namespace {
+void preorder(const json2cpp::json &node, const std::size_t depth, std::vector<json2cpp::cursor_entry> &entries)
+{
+  if (!node.is_structured()) { return; }
+  for (auto itr = node.begin(); itr != node.end(); ++itr) {
+    json2cpp::cursor_entry entry;
+    entry.depth = depth;
+    entry.index = static_cast<std::size_t>(itr - node.begin());
+    entry.is_member = node.is_object();
+    if (node.is_object()) { entry.key = itr.key(); }
+    entry.node = &*itr;
+    entries.push_back(entry);
+    preorder(*itr, depth + 1, entries);
+  }
+}
+
+bool same_entries(const json2cpp::cursor_entry &lhs, const json2cpp::cursor_entry &rhs)
+{
+  return lhs.depth == rhs.depth && lhs.index == rhs.index && lhs.key == rhs.key && lhs.is_member == rhs.is_member
+         && lhs.node == rhs.node;
+}
+}// namespace
+
+TEST_CASE("Cursors visit every node without recursion")
+{
+  const auto &document = compiled_json::test_json::get();
+
+  std::vector<json2cpp::cursor_entry> expected{ json2cpp::cursor_entry{ 0, 0, {}, false, &document } };
+  preorder(document, 1, expected);
+
+  std::vector<json2cpp::cursor_entry> depth_first;
+  for (const auto &entry : json2cpp::depth_first_cursor<>{ document }) { depth_first.push_back(entry); }
+  REQUIRE(std::equal(depth_first.begin(), depth_first.end(), expected.begin(), expected.end(), same_entries));
+
+  // the same nodes, one depth after the other, in document order within a depth
+  std::vector<json2cpp::cursor_entry> breadth_first;
+  for (const auto &entry : json2cpp::breadth_first_cursor<7>{ document }) { breadth_first.push_back(entry); }
+  std::stable_sort(
+    expected.begin(), expected.end(), [](const auto &lhs, const auto &rhs) { return lhs.depth < rhs.depth; });
+  REQUIRE(std::equal(breadth_first.begin(), breadth_first.end(), expected.begin(), expected.end(), same_entries));
+
+  // pruned below "GlossDiv"
+  std::size_t visited = 0;
+  for (json2cpp::depth_first_cursor<7> cursor{ document }; !cursor.done(); cursor.next()) {
+    ++visited;
+    if (cursor.current().key == "GlossDiv") { cursor.skip_children(); }
+  }
+  REQUIRE(visited == 4);
+
+  REQUIRE_THROWS_AS(
+    [&] {
+      for (json2cpp::depth_first_cursor<6> cursor{ document }; !cursor.done(); cursor.next()) {}
+    }(),
+    std::runtime_error);
+
+#if defined(JSON2CPP_HAS_COROUTINES)
+  std::vector<json2cpp::cursor_entry> generated;
+  for (const auto &entry : json2cpp::breadth_first<7>(document)) { generated.push_back(entry); }
+  REQUIRE(std::equal(generated.begin(), generated.end(), breadth_first.begin(), breadth_first.end(), same_entries));
+  generated.clear();
+  for (const auto &entry : json2cpp::depth_first(document)) { generated.push_back(entry); }
+  REQUIRE(std::equal(generated.begin(), generated.end(), depth_first.begin(), depth_first.end(), same_entries));
+#endif
+}
+
+namespace {
+bool same_document(const json2cpp::json &lhs, const json2cpp::json &rhs)
+{
+  if (lhs.is_object() != rhs.is_object() || lhs.is_array() != rhs.is_array() || lhs.size() != rhs.size()) {
+    return false;
+  }
+  if (lhs.is_object()) {
+    for (auto itr = lhs.begin(); itr != lhs.end(); ++itr) {
+      if (rhs.count(itr.key()) == 0 || !same_document(*itr, rhs[itr.key()])) { return false; }
+    }
+    return true;
+  }
+  if (lhs.is_array()) {
+    for (std::size_t idx = 0; idx < lhs.size(); ++idx) {
+      if (!same_document(lhs[idx], rhs[idx])) { return false; }
+    }
+    return true;
+  }
+  if (lhs.is_string()) { return rhs.is_string() && lhs.get<std::string_view>() == rhs.get<std::string_view>(); }
+  return lhs.is_null() && rhs.is_null();
+}
+}// namespace
+
+TEST_CASE("Runtime parser builds the same document as the generator")
+{
+  std::ifstream input(std::filesystem::path{ JSON2CPP_EXAMPLES_DIR } / "test.json");
+  std::stringstream text;
+  text << input.rdbuf();
+  const auto contents = text.str();
+
+  const auto in_situ = json2cpp::parse(contents);
+  REQUIRE(same_document(in_situ.root(), compiled_json::test_json::get()));
+
+  const auto copied = json2cpp::parse(contents, json2cpp::parse_options{ true });
+  REQUIRE(same_document(copied.root(), compiled_json::test_json::get()));
+  REQUIRE(copied.arena_size() > in_situ.arena_size());
+}
+
+TEST_CASE("Runtime parser decodes escapes and keeps the kind of every number")
+{
+  const std::string text =
+    R"({"k\u00e9y": ["\ud83d\ude00", "a\"b\\c\/\n", -9223372036854775808, 18446744073709551615, 1e3, -0, 2.5,)"
+    R"( true, null, {}, []]})";
+  const auto parsed = json2cpp::parse(text);
+  const auto &values = parsed.root()["k\xc3\xa9y"];
+
+  REQUIRE(values.size() == 11);
+  REQUIRE(values[0].get<std::string_view>() == "\xf0\x9f\x98\x80");
+  REQUIRE(values[1].get<std::string_view>() == "a\"b\\c/\n");
+  REQUIRE(values[2].is_number_signed());
+  REQUIRE(values[2].get<std::int64_t>() == std::numeric_limits<std::int64_t>::min());
+  REQUIRE(values[3].is_number_unsigned());
+  REQUIRE(values[3].get<std::uint64_t>() == std::numeric_limits<std::uint64_t>::max());
+  REQUIRE(values[4].get<double>() == 1000.0);
+  REQUIRE(values[5].is_number_signed());
+  REQUIRE(values[6].get<double>() == 2.5);
+  REQUIRE(values[7].get<bool>());
+  REQUIRE(values[8].is_null());
+  REQUIRE(values[9].is_object());
+  REQUIRE(values[10].empty());
+}
+
+TEST_CASE("Runtime parser rejects malformed JSON")
+{
+  for (const std::string_view text : { "", "[1,]", "{\"a\" 1}", "tru", "[1] x", "\"\\x\"", "01", "1.", "{\"a\":1,}" }) {
+    CAPTURE(text);
+    REQUIRE_THROWS_AS(json2cpp::parse(text), std::runtime_error);
+  }
+  REQUIRE_THROWS_AS(json2cpp::parse(std::string(2000, '[') + std::string(2000, ']')), std::runtime_error);
+
+  // strings and member names must be valid UTF-8
+  for (const std::string_view text : { "\"\xff\"",
+         "\"\xc0\xaf\"",
+         "\"\xe0\x80\xaf\"",
+         "\"\xed\xa0\x80\"",
+         "\"\xf4\x90\x80\x80\"",
+         "\"\xc3\"",
+         "\"abcdefgh\x80\"",
+         "{\"k\xe9y\": 1}" }) {
+    CAPTURE(text);
+    REQUIRE_THROWS_AS(json2cpp::parse(text), std::runtime_error);
+  }
+  const auto valid =
+    json2cpp::parse("[\"h\xc3\xa9llo w\xc3\xb6rld \xe2\x82\xac \xf0\x9f\x98\x80\", \"\xf4\x8f\xbf\xbf\"]");
+  REQUIRE(valid.root()[0].get<std::string_view>() == "h\xc3\xa9llo w\xc3\xb6rld \xe2\x82\xac \xf0\x9f\x98\x80");
+  REQUIRE(valid.root()[1].get<std::string_view>().size() == 4);
+}
+
+TEST_CASE("A schema subset keeps the properties a $ref points into")
+{
+  const auto schema = json2cpp::parse(R"({"properties": {"a": {"type": "integer"}, "b/c": {"type": "string"},
+    "d": {"items": {"$ref": "#/properties/a"}}, "e": {"$ref": "#/properties/b~1c/type"}, "f": {}}})");
+  const json2cpp::schema_subset subset{ schema.root(), std::vector<std::string_view>{ "d" } };
+  CHECK(subset.property_count() == 3);
+  CHECK(subset.get()["properties"].count("a") == 1);
+  CHECK(subset.get()["properties"].count("b/c") == 1);
+  CHECK(subset.get()["properties"].count("f") == 0);
+
+  // a reference to the root validates other values against all of its properties
+  const auto recursive = json2cpp::parse(R"({"properties": {"a": {}, "b": {"items": {"$ref": "#"}}}})");
+  CHECK(json2cpp::schema_subset{ recursive.root(), std::vector<std::string_view>{ "a" } }.property_count() == 2);
+}
+
+TEST_CASE("An overlay shows a compiled document with a merge patch applied")
+{
+  const auto patch = json2cpp::parse(R"({"glossary": {"title": "patched", "GlossDiv": {"subtitle": "new",
+    "title": null}, "GlossSee": ["a", null]}})");
+  const json2cpp::overlay document{ compiled_json::test_json::get(), patch.root() };
+  const auto glossary = document["glossary"];
+
+  REQUIRE(glossary["title"].get<std::string_view>() == "patched");
+  REQUIRE(glossary["GlossSee"].is_array());
+  REQUIRE(glossary["GlossSee"][1].is_null());
+
+  // a null in the patch removes the member, an object merges into the base object
+  const auto division = glossary["GlossDiv"];
+  REQUIRE_FALSE(division.contains("title"));
+  REQUIRE_THROWS_AS(division["title"], std::runtime_error);
+  REQUIRE(division["subtitle"].get<std::string_view>() == "new");
+  REQUIRE(division["GlossList"]["GlossEntry"]["ID"].get<std::string_view>() == "SGML");
+  REQUIRE_FALSE(division["GlossList"].patched());
+
+  // base members in their order, then members only the patch adds
+  std::vector<std::string_view> keys;
+  for (auto itr = glossary.begin(); itr != glossary.end(); ++itr) { keys.push_back(itr.key()); }
+  REQUIRE(keys == std::vector<std::string_view>{ "GlossDiv", "title", "GlossSee" });
+  REQUIRE(glossary.size() == 3);
+  REQUIRE(division.size() == 2);
+
+  // keys in order on both sides are counted in one pass, the same as iterating
+  const auto sorted_patch = json2cpp::parse(R"({"Abbrev": null, "Acronym": "X", "Added": 1, "GlossDef": null,
+    "GlossSee": "y", "ZZ": null, "Zed": true})");
+  const auto &entry = compiled_json::test_json::get()["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+  const json2cpp::overlay patched_entry{ entry, sorted_patch.root() };
+  std::size_t iterated = 0;
+  for (auto itr = patched_entry.begin(); itr != patched_entry.end(); ++itr) { ++iterated; }
+  REQUIRE(patched_entry.size() == entry.size());
+  REQUIRE(patched_entry.size() == iterated);
+}
+
+namespace {
+// checks every subtree of `node` against the serializer and returns how many were views of the stored text
+std::size_t check_dumps(const json2cpp::json &node)
+{
+  std::string buffer;
+  const auto text = compiled_json::test_json_text::dump(node, buffer);
+  REQUIRE(text == json2cpp::serialize(node));
+
+  const auto whole = compiled_json::test_json_text::text();
+  std::size_t stored = text.data() >= whole.data() && text.data() < whole.data() + whole.size() ? 1 : 0;
+  if (node.is_structured()) {
+    for (const auto &child : node) { stored += check_dumps(child); }
+  }
+  return stored;
+}
+}// namespace
+
+TEST_CASE("dump() returns arrays and objects as views of the emitted text")
+{
+  const auto &document = compiled_json::test_json_text::get();
+  REQUIRE(compiled_json::test_json_text::text() == json2cpp::serialize(document));
+
+  // 7 non-empty arrays and objects in test.json, the scalars are serialized
+  REQUIRE(check_dumps(document) == 7);
+
+  std::string buffer;
+  REQUIRE(compiled_json::test_json_text::dump(document["glossary"]["GlossDiv"]["title"], buffer) == R"("S")");
+  REQUIRE(compiled_json::test_json_text::dump(compiled_json::test_json::get(), buffer)
+          == compiled_json::test_json_text::text());
+
+  // a view of some of a compiled array's elements is not the array
+  const auto &see_also =
+    document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"]["GlossDef"]["GlossSeeAlso"].array_data();
+  const json2cpp::json first{ json2cpp::array_t{ see_also.begin(), see_also.begin() + 1 } };
+  REQUIRE(compiled_json::test_json_text::dump(first, buffer) == R"(["GML"])");
+}
+
+TEST_CASE("dump() serves documents larger than a string literal may be")
+{
+  const auto &document = compiled_json::refbldg_medium_office_text::get();
+  const auto text = compiled_json::refbldg_medium_office_text::text();
+  REQUIRE(text.size() > 65536);
+  REQUIRE(text == json2cpp::serialize(document));
+
+  std::string buffer;
+  const auto &zones = document["Zone"];
+  const auto zone = compiled_json::refbldg_medium_office_text::dump(zones, buffer);
+  REQUIRE(zone == json2cpp::serialize(zones));
+  REQUIRE(zone.data() >= text.data());
+  REQUIRE(zone.data() < text.data() + text.size());
+}
+
+TEST_CASE("The serializer escapes strings and formats numbers like nlohmann::json")
+{
+  const auto parsed = json2cpp::parse(
+    R"({"a\u0001\"\\/\t": [1, -2, 18446744073709551615, 0.5, 1e-5, 1e15, 100.0, -0.0, true, null, {}, []]})");
+  REQUIRE(json2cpp::serialize(parsed.root())
+          == R"({"a\u0001\"\\/\t":[1,-2,18446744073709551615,0.5,1e-05,1e+15,100.0,-0.0,true,null,{},[]]})");
+}
+
+TEST_CASE("Generated subtree hashes match hashes computed at runtime")
+{
+  const auto &document = compiled_json::test_json_hashes::get();
+  const json2cpp::hash_index computed{ document };
+  REQUIRE(compiled_json::test_json_hashes::hashes().size() == 7);
+  REQUIRE(computed.size() == 7);
+
+  const auto &entry = document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+  REQUIRE(compiled_json::test_json_hashes::hash(document) == computed.hash(document));
+  REQUIRE(compiled_json::test_json_hashes::hash(entry) == json2cpp::structural_hash(entry));
+  REQUIRE(compiled_json::test_json_hashes::hash(entry["GlossDef"]["GlossSeeAlso"])
+          == json2cpp::structural_hash(entry["GlossDef"]["GlossSeeAlso"]));
+  REQUIRE(
+    compiled_json::test_json_hashes::hash(entry["ID"]) == compiled_json::test_json_hashes::hash(entry["Acronym"]));
+
+  // a view of some of a compiled array's elements is not the array
+  const auto &see_also = entry["GlossDef"]["GlossSeeAlso"].array_data();
+  const json2cpp::json first{ json2cpp::array_t{ see_also.begin(), see_also.begin() + 1 } };
+  REQUIRE(compiled_json::test_json_hashes::hash(first) == json2cpp::structural_hash(first));
+  REQUIRE(compiled_json::test_json_hashes::hash(first)
+          != compiled_json::test_json_hashes::hash(entry["GlossDef"]["GlossSeeAlso"]));
+
+  // member order and the representation of numbers do not matter, to hashes or to ==
+  const auto reordered = json2cpp::parse(R"({"b": [1, 2.0, -3], "a": {"x": null}})");
+  const auto sorted = json2cpp::parse(R"({"a": {"x": null}, "b": [1.0, 2, -3.0]})");
+  REQUIRE(reordered.root() == sorted.root());
+  REQUIRE(json2cpp::structural_hash(reordered.root()) == json2cpp::structural_hash(sorted.root()));
+  REQUIRE(json2cpp::parse("[1.5]").root() != json2cpp::parse("[1]").root());
+  REQUIRE(json2cpp::structural_hash(json2cpp::parse("[1.5]").root())
+          != json2cpp::structural_hash(json2cpp::parse("[1]").root()));
+}
+
+TEST_CASE("diff() reports the changes between two versions of a document")
+{
+  std::ifstream input(JSON2CPP_EXAMPLES_DIR "/test.json");
+  std::ostringstream buffer;
+  buffer << input.rdbuf();
+  const std::string text = buffer.str();
+  const auto unchanged = json2cpp::parse(text);
+  const json2cpp::hash_index unchanged_hashes{ unchanged.root() };
+
+  const auto &document = compiled_json::test_json_hashes::get();
+  const auto &hashes = compiled_json::test_json_hashes::hashes();
+  REQUIRE(json2cpp::equal(document, hashes, unchanged.root(), unchanged_hashes));
+  REQUIRE(json2cpp::diff(document, hashes, unchanged.root(), unchanged_hashes).empty());
+  REQUIRE(document == unchanged.root());
+
+  const auto changed = json2cpp::parse(R"({"glossary": {"title": "example glossary", "GlossDiv": {"title": "S",
+    "GlossList": {"GlossEntry": {"ID": "SGML", "SortAs": "SGML", "GlossTerm": "Standard Generalized Markup Language",
+    "Acronym": "SGML", "Abbrev": "ISO 8879:1986", "GlossDef": {"para": "A markup language.",
+    "GlossSeeAlso": ["GML", "SGML", "XML"]}, "GlossSee": "markup", "a/b": 1}}}}})");
+  const json2cpp::hash_index changed_hashes{ changed.root() };
+  REQUIRE_FALSE(json2cpp::equal(document, hashes, changed.root(), changed_hashes));
+
+  const auto differences = json2cpp::diff(document, hashes, changed.root(), changed_hashes);
+  REQUIRE(differences.size() == 5);
+  CHECK(differences[0].pointer == "/glossary/GlossDiv/GlossList/GlossEntry/GlossDef/GlossSeeAlso/1");
+  CHECK(differences[0].change == json2cpp::difference::kind::replaced);
+  CHECK(differences[1].pointer == "/glossary/GlossDiv/GlossList/GlossEntry/GlossDef/GlossSeeAlso/2");
+  CHECK(differences[1].change == json2cpp::difference::kind::added);
+  CHECK(differences[1].before == nullptr);
+  CHECK(differences[1].after->get<std::string_view>() == "XML");
+  CHECK(differences[2].pointer == "/glossary/GlossDiv/GlossList/GlossEntry/GlossDef/para");
+  CHECK(differences[3].pointer == "/glossary/GlossDiv/GlossList/GlossEntry/a~1b");
+  CHECK(differences[3].change == json2cpp::difference::kind::added);
+  CHECK(differences[4].pointer == "/glossary/GlossDiv/subtitle");
+  CHECK(differences[4].change == json2cpp::difference::kind::removed);
+  CHECK(differences[4].before->is_null());
+
+  // objects with sorted keys are merged rather than searched, with the same result
+  const auto sorted_before = json2cpp::parse(R"({"a": 1, "b": 2, "d": [4]})");
+  const auto sorted_after = json2cpp::parse(R"({"a": 1.0, "c": 3, "d": [5]})");
+  const auto merged = json2cpp::diff(sorted_before.root(), sorted_after.root());
+  REQUIRE(merged.size() == 3);
+  CHECK(merged[0].pointer == "/b");
+  CHECK(merged[0].change == json2cpp::difference::kind::removed);
+  CHECK(merged[1].pointer == "/d/0");
+  CHECK(merged[1].change == json2cpp::difference::kind::replaced);
+  CHECK(merged[2].pointer == "/c");
+  CHECK(merged[2].change == json2cpp::difference::kind::added);
+}
+
+TEST_CASE("Section accessors return subtrees of the document without referring to the rest")
+{
+  namespace sections = compiled_json::test_json_sections::sections;
+  const auto &document = compiled_json::test_json_sections::get();
+  const auto &definition = document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"]["GlossDef"];
+
+  REQUIRE(sections::glossary() == document["glossary"]);
+  REQUIRE(sections::glossary().object_data().begin() == document["glossary"].object_data().begin());
+  REQUIRE(sections::glossary_GlossDiv_GlossList_GlossEntry_GlossDef() == definition);
+  REQUIRE(sections::glossary_GlossDiv_GlossList_GlossEntry_GlossDef()["GlossSeeAlso"].size() == 2);
+  REQUIRE(sections::glossary_GlossDiv_GlossList_GlossEntry_GlossDef_GlossSeeAlso_1().get<std::string_view>() == "XML");
+}
+
+TEST_CASE("Compressed members are expanded once, on first use")
+{
+  namespace sections = compiled_json::epjson_model_compressed::sections;
+  std::ifstream input(JSON2CPP_EXAMPLES_DIR "/epjson_model.schema.json");
+  std::ostringstream buffer;
+  buffer << input.rdbuf();
+  const std::string text = buffer.str();
+  const auto expected = json2cpp::parse(text);
+
+  // every thread sees the same expansion
+  json2cpp::thread_pool pool(4);
+  json2cpp::task_group group(pool);
+  std::array<const json2cpp::json *, 16> seen{};
+  for (auto &result : seen) {
+    group.run([&result] { result = &sections::definitions(); });
+  }
+  group.wait();
+  for (const auto *result : seen) { REQUIRE(result == seen.front()); }
+
+  REQUIRE(sections::definitions() == expected.root()["definitions"]);
+  REQUIRE(sections::properties() == expected.root()["properties"]);
+  REQUIRE(sections::type().get<std::string_view>() == "object");
+  REQUIRE(compiled_json::epjson_model_compressed::get() == expected.root());
+  REQUIRE(&compiled_json::epjson_model_compressed::get()["properties"].object_data().begin()->second
+          == &sections::properties().object_data().begin()->second);
+}
+
+TEST_CASE("The LZ codec round-trips and rejects corrupt input")
+{
+  std::string text;
+  for (int idx = 0; idx < 200; ++idx) {
+    text += R"({"name": "Zone )" + std::to_string(idx % 7) + R"(", "area": 12.5},)";
+  }
+  text += std::string(1000, ' ') + "end";
+
+  const auto compressed = json2cpp::compress(text);
+  REQUIRE(compressed.size() < text.size() / 4);
+  const auto *bytes = reinterpret_cast<const unsigned char *>(compressed.data());
+  REQUIRE(json2cpp::decompress(bytes, compressed.size(), text.size()) == text);
+  REQUIRE(json2cpp::compress("").size() == 1);
+  REQUIRE(json2cpp::decompress(bytes, 0, 0).empty());
+
+  REQUIRE_THROWS_AS(json2cpp::decompress(bytes, compressed.size(), text.size() + 1), std::runtime_error);
+  REQUIRE_THROWS_AS(json2cpp::decompress(bytes, compressed.size() - 1, text.size()), std::runtime_error);
+}
+
+TEST_CASE("A profiled layout scans the most looked-up keys first")
+{
+  const auto &document = compiled_json::test_json_profiled::get();
+  const auto &entry = document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+
+  // examples/test.profile.json looked up GlossSee three times and GlossTerm once
+  std::vector<std::string_view> keys;
+  for (auto itr = entry.begin(); itr != entry.end(); ++itr) { keys.push_back(itr.key()); }
+  REQUIRE(
+    keys == std::vector<std::string_view>{ "GlossSee", "GlossTerm", "Abbrev", "Acronym", "GlossDef", "ID", "SortAs" });
+  REQUIRE(entry["GlossDef"]["GlossSeeAlso"][1].get<std::string_view>() == "XML");
+  REQUIRE(document == compiled_json::test_json::get());
+}
+
+TEST_CASE("A subset keeps the selected subtrees where they were")
+{
+  const auto &subset = compiled_json::test_json_subset::get();
+  const auto &document = compiled_json::test_json::get();
+  const auto &entry = subset["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"];
+
+  REQUIRE(subset["glossary"].size() == 1);
+  REQUIRE(subset["glossary"]["GlossDiv"].count("title") == 0);
+  REQUIRE(entry.size() == 3);
+  REQUIRE(entry.count("ID") == 0);
+  REQUIRE(entry["GlossTerm"] == document["glossary"]["GlossDiv"]["GlossList"]["GlossEntry"]["GlossTerm"]);
+  REQUIRE(entry["GlossDef"].count("para") == 0);
+
+  // the excluded first element leaves a null behind, so the second keeps its index
+  REQUIRE(entry["GlossDef"]["GlossSeeAlso"].size() == 2);
+  REQUIRE(entry["GlossDef"]["GlossSeeAlso"][0].is_null());
+  REQUIRE(entry["GlossDef"]["GlossSeeAlso"][1].get<std::string_view>() == "XML");
+}
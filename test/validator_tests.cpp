@@ -0,0 +1,315 @@
+#include "allof_integers_and_numbers.schema_validator.hpp"
+#include "array_doubles_10_20_30_40.hpp"
+#include "array_integers_10_20_30_40.hpp"
+#include "epjson_model.schema_validator.hpp"
+#include "string_patterns.schema_validator.hpp"
+
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <json2cpp/json2cpp_parallel_validation.hpp>
+#include <json2cpp/json2cpp_parser.hpp>
+#include <json2cpp/json2cpp_stream_validation.hpp>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <tuple>
+
+namespace {
+nlohmann::json load_example(const std::string_view name)
+{
+  std::ifstream input(std::filesystem::path{ JSON2CPP_EXAMPLES_DIR } / name);
+  nlohmann::json document;
+  input >> document;
+  return document;
+}
+}// namespace
+
+TEST_CASE("Generated validator accepts a valid compiled document")
+{
+  REQUIRE(compiled_json::allof_integers_and_numbers_schema::validator::validate(
+    compiled_json::array_integers_10_20_30_40::get()));
+}
+
+TEST_CASE("Generated validator rejects an invalid compiled document")
+{
+  const auto &document = compiled_json::array_doubles_10_20_30_40::get();
+  REQUIRE_FALSE(compiled_json::allof_integers_and_numbers_schema::validator::validate(document));
+
+  const auto errors = compiled_json::allof_integers_and_numbers_schema::validator::errors(document);
+  REQUIRE(!errors.empty());
+  CHECK(errors.front().path == "/0");
+}
+
+TEST_CASE("Generated validator accepts documents parsed at runtime")
+{
+  std::ifstream input(
+    std::filesystem::path{ JSON2CPP_EXAMPLES_DIR } / "RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  std::ostringstream buffer;
+  buffer << input.rdbuf();
+  const std::string text = buffer.str();
+  const auto document = json2cpp::parse(text);
+  REQUIRE(compiled_json::epjson_model_schema::validator::validate(document.root()));
+
+  const auto repeated = json2cpp::parse("[1, 2, 1]");
+  REQUIRE_FALSE(compiled_json::allof_integers_and_numbers_schema::validator::validate(repeated.root()));
+}
+
+TEST_CASE("Generated validator handles uniqueItems")
+{
+  REQUIRE_FALSE(compiled_json::allof_integers_and_numbers_schema::validator::validate(nlohmann::json{ 1, 2, 1 }));
+  REQUIRE(compiled_json::allof_integers_and_numbers_schema::validator::validate(nlohmann::json{ 1, 2, 3 }));
+}
+
+TEST_CASE("Generated validator accepts the reference building model")
+{
+  const auto document = load_example("RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  const auto errors = compiled_json::epjson_model_schema::validator::errors(document);
+  for (const auto &error : errors) { UNSCOPED_INFO(error.path << ": " << error.message); }
+  REQUIRE(errors.empty());
+}
+
+TEST_CASE("Generated validator reports every failure with its location")
+{
+  auto document = load_example("RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  document.erase("Version");
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["terrain"] = "Forest";
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["north_axis"] = 400;
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["colour"] = "red";
+  document["Zone"]["Core_bottom"]["x_origin"] = nullptr;
+
+  REQUIRE_FALSE(compiled_json::epjson_model_schema::validator::validate(document));
+
+  const auto errors = compiled_json::epjson_model_schema::validator::errors(document);
+  const auto has_error = [&](const std::string_view path) {
+    return std::any_of(errors.begin(), errors.end(), [&](const auto &error) { return error.path == path; });
+  };
+
+  CHECK(errors.size() == 5);
+  CHECK(has_error(""));
+  CHECK(has_error("/Building/Ref Bldg Medium Office New2004_v1.3_5.0/terrain"));
+  CHECK(has_error("/Building/Ref Bldg Medium Office New2004_v1.3_5.0/north_axis"));
+  CHECK(has_error("/Building/Ref Bldg Medium Office New2004_v1.3_5.0/colour"));
+  CHECK(has_error("/Zone/Core_bottom/x_origin"));
+}
+
+TEST_CASE("Generated validator matches patterns with build time DFAs")
+{
+  const auto valid = [](const nlohmann::json &document) {
+    return compiled_json::string_patterns_schema::validator::validate(document);
+  };
+
+  CHECK(valid({ { "identifier", "_json2cpp" } }));
+  CHECK_FALSE(valid({ { "identifier", "2cpp" } }));
+  CHECK_FALSE(valid({ { "identifier", "json-2cpp" } }));
+
+  CHECK(valid({ { "version", "1.2" } }));
+  CHECK(valid({ { "version", "10.20.30" } }));
+  CHECK_FALSE(valid({ { "version", "1.2." } }));
+  CHECK_FALSE(valid({ { "version", "v1.2" } }));
+
+  // multi-byte UTF-8 in the pattern and in the input
+  CHECK(valid({ { "greeting", "héllowörldhéllo" } }));
+  CHECK_FALSE(valid({ { "greeting", "hello" } }));
+
+  // `.` matches one code point, not one byte
+  CHECK(valid({ { "symbol", "€" } }));
+  CHECK(valid({ { "symbol", "😀" } }));
+  CHECK_FALSE(valid({ { "symbol", "ab" } }));
+  CHECK_FALSE(valid({ { "symbol", "\n" } }));
+
+  CHECK(valid({ { "x-count", 1 } }));
+  CHECK_FALSE(valid({ { "x-count", "one" } }));
+  CHECK(valid({ { "x-Count", "not matched by the pattern" } }));
+}
+
+TEST_CASE("Generated validator falls back to std::regex for backreferences")
+{
+  CHECK(compiled_json::string_patterns_schema::validator::validate(nlohmann::json{ { "doubled", "aa" } }));
+  CHECK_FALSE(compiled_json::string_patterns_schema::validator::validate(nlohmann::json{ { "doubled", "ab" } }));
+}
+
+TEST_CASE("Parallel validation reports the same errors whatever the thread count")
+{
+  auto document = load_example("RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  document.erase("Version");
+  document["Zone"]["Core_bottom"]["x_origin"] = nullptr;
+  document["Zone"]["Core_top"]["y_origin"] = nullptr;
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["terrain"] = "Forest";
+
+  const auto serial = compiled_json::epjson_model_schema::validator::errors(document);
+  REQUIRE(serial.size() == 4);
+
+  const auto parallel_errors = [&](const std::size_t threads) {
+    json2cpp::thread_pool pool(threads);
+    // a grain of 1 splits every object and array, not only the large ones
+    json2cpp::validation::pool_executor parallel{ pool, 1 };
+    std::vector<json2cpp::validation::error> errors;
+    json2cpp::validation::context ctx{ errors, parallel };
+    CHECK_FALSE(compiled_json::epjson_model_schema::validator::validate(document, ctx));
+    return errors;
+  };
+
+  const auto same = [](const auto &lhs, const auto &rhs) {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const auto &left, const auto &right) {
+      return left.path == right.path && left.message == right.message;
+    });
+  };
+  const auto sorted = [](auto errors) {
+    std::sort(errors.begin(), errors.end(), [](const auto &lhs, const auto &rhs) {
+      return std::tie(lhs.path, lhs.message) < std::tie(rhs.path, rhs.message);
+    });
+    return errors;
+  };
+
+  const auto one_thread = parallel_errors(1);
+  CHECK(same(sorted(one_thread), sorted(serial)));
+  for (const std::size_t threads : { std::size_t{ 2 }, std::size_t{ 4 }, std::size_t{ 8 } }) {
+    CHECK(same(parallel_errors(threads), one_thread));
+  }
+
+  json2cpp::thread_pool pool(4);
+  json2cpp::validation::pool_executor parallel{ pool, 1 };
+  json2cpp::validation::context first_failure{ parallel };
+  CHECK_FALSE(compiled_json::epjson_model_schema::validator::validate(document, first_failure));
+  json2cpp::validation::context valid{ parallel };
+  CHECK(compiled_json::epjson_model_schema::validator::validate(
+    load_example("RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON"), valid));
+}
+
+TEST_CASE("Memoized validation reports the same errors and skips repeated subtrees")
+{
+  auto document = load_example("RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  document["Zone"]["Core_bottom"]["x_origin"] = nullptr;
+  for (std::size_t idx = 0; idx < 20; ++idx) {
+    document["Zone"]["Valid copy " + std::to_string(idx)] = document["Zone"]["Core_top"];
+    document["Zone"]["Invalid copy " + std::to_string(idx)] = document["Zone"]["Core_bottom"];
+  }
+
+  const auto plain = compiled_json::epjson_model_schema::validator::errors(document);
+  REQUIRE(plain.size() == 21);
+
+  json2cpp::validation::memo results{ 1024 };
+  const json2cpp::validation::subtree_hashes hashes{ document, results };
+  CHECK(hashes.find(&document["Zone"]["Core_top"]) == hashes.find(&document["Zone"]["Valid copy 3"]));
+  CHECK(hashes.find(&document["Zone"]["Core_top"]) != hashes.find(&document["Zone"]["Core_bottom"]));
+
+  std::vector<json2cpp::validation::error> errors;
+  json2cpp::validation::context ctx{ errors };
+  ctx.use_memo(results, hashes);
+  CHECK_FALSE(compiled_json::epjson_model_schema::validator::validate(document, ctx));
+
+  REQUIRE(errors.size() == plain.size());
+  for (std::size_t idx = 0; idx < plain.size(); ++idx) {
+    CHECK(errors[idx].path == plain[idx].path);
+    CHECK(errors[idx].message == plain[idx].message);
+  }
+  // each valid copy of Core_top is a hit; the invalid copies run again to report their errors
+  CHECK(results.stats().hits >= 20);
+  CHECK(results.stats().hit_rate() > 0.0);
+
+  json2cpp::validation::context first_failure;
+  first_failure.use_memo(results, hashes);
+  CHECK_FALSE(compiled_json::epjson_model_schema::validator::validate(document, first_failure));
+
+  // compiled and parsed copies of a document hash alike
+  const auto &compiled = compiled_json::array_integers_10_20_30_40::get();
+  const auto parsed = load_example("array_integers_10_20_30_40.json");
+  CHECK(json2cpp::validation::subtree_hashes{ compiled, results }.find(&compiled)
+        == json2cpp::validation::subtree_hashes{ parsed, results }.find(&parsed));
+}
+
+namespace {
+// the multiplicative inverse of an odd number modulo 2^64
+std::uint64_t inverse(const std::uint64_t odd)
+{
+  std::uint64_t result = odd;
+  for (int step = 0; step < 5; ++step) { result *= 2U - odd * result; }
+  return result;
+}
+
+// the inverse of json2cpp::hash_detail::mix, to build values with a chosen hash
+std::uint64_t unmix(std::uint64_t value)
+{
+  value ^= (value >> 31U) ^ (value >> 62U);
+  value *= inverse(0x94d049bb133111ebULL);
+  value ^= (value >> 27U) ^ (value >> 54U);
+  value *= inverse(0xbf58476d1ce4e5b9ULL);
+  value ^= (value >> 30U) ^ (value >> 60U);
+  return value;
+}
+
+std::uint64_t unkeyed_hash(const nlohmann::json &value)
+{
+  json2cpp::hash_detail::ignore_subtrees ignore;
+  return json2cpp::hash_detail::hash_tree<json2cpp::hash_detail::doubles::by_representation>(value, ignore);
+}
+}// namespace
+
+TEST_CASE("A memo does not let a crafted colliding subtree reuse a remembered result")
+{
+  namespace hash = json2cpp::hash_detail;
+  // [1, 2] is valid; [1.5, tail] is not, with tail chosen to give it the same
+  // unkeyed hash by running the array hash backwards from [1, 2]'s
+  const auto valid = nlohmann::json::array({ 1U, 2U });
+  const auto last_step = unmix(unmix(unkeyed_hash(valid)));
+  const auto after_first = (last_step - hash::hash_unsigned(2)) * inverse(31);
+  const auto before_first = unmix(after_first) - hash::hash_unsigned(1);
+  const auto crafted_first = hash::mix(before_first + hash::hash_double_bits(1.5));
+  const auto tail = unmix(last_step - crafted_first * 31U) ^ unmix(hash::hash_unsigned(0));
+  const auto crafted = nlohmann::json::array({ 1.5, tail });
+  REQUIRE(unkeyed_hash(crafted) == unkeyed_hash(valid));
+
+  json2cpp::validation::memo results{ 64 };
+  const json2cpp::validation::subtree_hashes valid_hashes{ valid, results };
+  json2cpp::validation::context first;
+  first.use_memo(results, valid_hashes);
+  REQUIRE(compiled_json::allof_integers_and_numbers_schema::validator::validate(valid, first));
+
+  const json2cpp::validation::subtree_hashes crafted_hashes{ crafted, results };
+  CHECK(crafted_hashes.find(&crafted) != valid_hashes.find(&valid));
+  json2cpp::validation::context second;
+  second.use_memo(results, crafted_hashes);
+  CHECK_FALSE(compiled_json::allof_integers_and_numbers_schema::validator::validate(crafted, second));
+}
+
+TEST_CASE("Streaming validation finds the same errors without loading the document")
+{
+  auto document = load_example("RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  const auto &schema = compiled_json::epjson_model_schema::validator::stream_schema<nlohmann::json>();
+
+  const auto valid_text = document.dump();
+  REQUIRE(json2cpp::validation::validate_stream(schema, valid_text.begin(), valid_text.end()));
+
+  document.erase("Version");
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["terrain"] = "Forest";
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["colour"] = "red";
+  document["Zone"]["Core_bottom"]["x_origin"] = nullptr;
+  const auto text = document.dump();
+
+  std::vector<json2cpp::validation::error> streamed;
+  json2cpp::validation::stream_options options;
+  options.on_error = [&](const json2cpp::validation::error &error) { streamed.push_back(error); };
+  REQUIRE_FALSE(json2cpp::validation::validate_stream(schema, text.begin(), text.end(), options));
+
+  auto loaded = compiled_json::epjson_model_schema::validator::errors(document);
+  const auto by_location = [](const auto &lhs, const auto &rhs) {
+    return std::tie(lhs.path, lhs.message) < std::tie(rhs.path, rhs.message);
+  };
+  std::sort(streamed.begin(), streamed.end(), by_location);
+  std::sort(loaded.begin(), loaded.end(), by_location);
+  REQUIRE(streamed.size() == loaded.size());
+  for (std::size_t idx = 0; idx < loaded.size(); ++idx) {
+    CHECK(streamed[idx].path == loaded[idx].path);
+    CHECK(streamed[idx].message == loaded[idx].message);
+  }
+
+  json2cpp::validation::stream_options first_only;
+  first_only.stop_at_first_error = true;
+  json2cpp::validation::stream_validator<nlohmann::json> handler{ schema, first_only };
+  CHECK_FALSE(nlohmann::json::sax_parse(text, &handler));
+  CHECK(handler.error_count() == 1);
+
+  const std::string truncated = valid_text.substr(0, valid_text.size() / 2);
+  CHECK_FALSE(json2cpp::validation::validate_stream(schema, truncated.begin(), truncated.end()));
+}
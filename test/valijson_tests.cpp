@@ -1,6 +1,7 @@
 #include "allof_integers_and_numbers.schema.hpp"
 #include "array_doubles_10_20_30_40.hpp"
 #include "array_integers_10_20_30_40.hpp"
+#include "epjson_model.schema.hpp"
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
@@ -9,7 +10,13 @@
 #if defined(__GNUC__) && !defined(__clang__)
 #pragma GCC diagnostic pop
 #endif
+#include <filesystem>
+#include <fstream>
 #include <json2cpp/json2cpp_adapter.hpp>
+#include <json2cpp/json2cpp_parser.hpp>
+#include <json2cpp/json2cpp_schema_subset.hpp>
+#include <memory>
+#include <valijson/adapters/nlohmann_json_adapter.hpp>
 #include <valijson/schema.hpp>
 #include <valijson/schema_parser.hpp>
 #include <valijson/validator.hpp>
@@ -71,3 +78,89 @@ TEST_CASE("Can validate a document")
 
   REQUIRE(validator.validate(mySchema, myTargetAdapter, nullptr));
 }
+
+TEST_CASE("Adapter iterates object members without copying the document")
+{
+  using valijson::adapters::FrozenValue;
+  using valijson::adapters::json2cppJsonAdapter;
+
+  const json2cppJsonAdapter schemaAdapter(compiled_json::allof_integers_and_numbers_schema::get());
+  const auto object = schemaAdapter.asObject();
+
+  std::size_t members = 0;
+  for (const auto &member : object) {
+    const auto found = object.find(member.first);
+    REQUIRE(found != object.end());
+    CHECK((*found).first == member.first);
+    ++members;
+  }
+  CHECK(members == object.size());
+  CHECK(object.find("no such key") == object.end());
+
+  const std::unique_ptr<FrozenValue> frozen{ schemaAdapter.freeze() };
+  const std::unique_ptr<FrozenValue> cloned{ frozen->clone() };
+  CHECK(cloned->equalTo(schemaAdapter, true));
+}
+
+TEST_CASE("A schema subset validates a document like the whole schema")
+{
+  using valijson::Schema;
+  using valijson::SchemaParser;
+  using valijson::Validator;
+  using valijson::adapters::json2cppJsonAdapter;
+  using valijson::adapters::NlohmannJsonAdapter;
+
+  const auto populate = [](const json2cpp::json &schema_document) {
+    auto schema = std::make_unique<Schema>();
+    SchemaParser parser;
+    parser.populateSchema(json2cppJsonAdapter(schema_document), *schema);
+    return schema;
+  };
+
+  nlohmann::json document;
+  std::ifstream input(
+    std::filesystem::path{ JSON2CPP_EXAMPLES_DIR } / "RefBldgMediumOfficeNew2004_Chicago_epJSON.epJSON");
+  input >> document;
+
+  const auto &compiled_schema = compiled_json::epjson_model_schema::get();
+  const auto whole = populate(compiled_schema);
+  Validator validator;
+
+  const json2cpp::schema_subset subset{ compiled_schema, document };
+  CHECK(subset.property_count() == 2);
+  CHECK(validator.validate(*populate(subset.get()), NlohmannJsonAdapter(document), nullptr));
+  CHECK(validator.validate(*whole, NlohmannJsonAdapter(document), nullptr));
+
+  document["Building"]["Ref Bldg Medium Office New2004_v1.3_5.0"]["terrain"] = "Forest";
+  CHECK_FALSE(validator.validate(*populate(subset.get()), NlohmannJsonAdapter(document), nullptr));
+  CHECK_FALSE(validator.validate(*whole, NlohmannJsonAdapter(document), nullptr));
+
+  // "Building" is still required even though its subschema was left out
+  const nlohmann::json version_only{ { "Version", document["Version"] } };
+  const json2cpp::schema_subset version_subset{ compiled_schema, version_only };
+  CHECK(version_subset.property_count() == 1);
+  CHECK_FALSE(validator.validate(*populate(version_subset.get()), NlohmannJsonAdapter(version_only), nullptr));
+}
+
+TEST_CASE("A schema subset resolves references into properties the document lacks")
+{
+  using valijson::Schema;
+  using valijson::SchemaParser;
+  using valijson::Validator;
+  using valijson::adapters::json2cppJsonAdapter;
+  using valijson::adapters::NlohmannJsonAdapter;
+
+  const auto schema = json2cpp::parse(R"({"properties": {"count": {"type": "integer"},
+    "counts": {"type": "array", "items": {"$ref": "#/properties/count"}}}})");
+  nlohmann::json document{ { "counts", { 1, 2 } } };
+  const json2cpp::schema_subset subset{ schema.root(), document };
+  CHECK(subset.property_count() == 2);
+
+  Schema reduced;
+  SchemaParser parser;
+  REQUIRE_NOTHROW(parser.populateSchema(json2cppJsonAdapter(subset.get()), reduced));
+  Validator validator;
+  CHECK(validator.validate(reduced, NlohmannJsonAdapter(document), nullptr));
+  document["counts"].push_back("three");
+  CHECK_FALSE(validator.validate(reduced, NlohmannJsonAdapter(document), nullptr));
+}